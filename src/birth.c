@@ -538,6 +538,9 @@ void player_init(struct player *p)
 		l_ptr->pkills = 0;
 	}
 
+	/* The uniques available have changed */
+	get_mon_num_forget();
+
 	/* Hack -- Well fed player */
 	p->food = PY_FOOD_FULL - 1;
 
@@ -4,6 +4,8 @@
 #define BIRTH_H
 
 extern void player_birth(bool quickstart_allowed);
+extern void player_init(struct player *p);
+extern void set_map(struct player *p);
 extern void player_generate(struct player *p, player_sex *s,
                             struct player_race *r, player_class *c,
                             struct player_cutiemark *cm);
@@ -0,0 +1,728 @@
+/*
+ * File: cave-view.c
+ * Purpose: Calculation of the player's field of view
+ *
+ * Copyright (c) 1997 Ben Harrison, James E. Wilson, Robert A. Koeneke
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+#include "cave.h"
+
+/**
+ * The view code answers exactly the same question as calling "los()" from
+ * the player to every grid within MAX_SIGHT, but without walking a line for
+ * each of them.
+ *
+ * The grids which "los()" examines between two points depend only on the
+ * offset between those points.  So at startup we record the path for every
+ * offset within the view radius, and merge the paths into a tree rooted at
+ * the player, so that paths sharing their first few grids share nodes.  The
+ * tree is stored in preorder, with each node knowing the size of its own
+ * subtree.  Tracing the view is then a single linear pass over the tree: a
+ * node is reachable if its grid is projectable, and as soon as a grid is
+ * not, the whole subtree behind it is skipped.  A grid is in line of sight
+ * if the last node of its path was reached.
+ *
+ * The paths never leave the rectangle spanned by their end points, so a
+ * node which is out of bounds, or further away than MAX_SIGHT, can only
+ * lead to grids which are as well.
+ */
+
+/**
+ * Radius and diameter of the precomputed view tables
+ */
+#define VIEW_RAD	MAX_SIGHT_LGE
+#define VIEW_DIAM	(2 * VIEW_RAD + 1)
+
+/**
+ * Maximum number of grids "los()" checks between two points in view
+ */
+#define VIEW_PATH_MAX	(2 * VIEW_DIAM)
+
+/**
+ * A node in the view tree
+ */
+typedef struct view_node {
+	s16b dy;	/**< Offset of the grid from the player */
+	s16b dx;
+	u16b d;		/**< Distance of the grid from the player */
+	u16b skip;	/**< Size of the subtree rooted at this node */
+} view_node;
+
+static view_node *view_nodes;
+static byte *view_reach;
+static int view_num;
+
+/**
+ * Index of the last node on the path to each offset, or -1 if "los()"
+ * checks no grids at all for that offset
+ */
+static int view_end[VIEW_DIAM][VIEW_DIAM];
+
+/**
+ * The area processed by the previous call to update_view().  This starts
+ * out as the whole map, so the first call also clears anything loaded from
+ * the savefile.
+ */
+static int view_y1 = 0;
+static int view_x1 = 0;
+static int view_y2 = CAVE_INFO_Y - 1;
+static int view_x2 = CAVE_INFO_X - 1;
+
+/**
+ * What the previous view was calculated from.  While none of this changes,
+ * only grids near terrain or lighting changes need to be looked at again.
+ */
+static bool view_valid = FALSE;
+static int view_py;
+static int view_px;
+static int view_radius;
+static int view_max;
+static int view_blind;
+static bool view_glow;
+
+/**
+ * Bounding box of the grids changed since the previous view, empty if
+ * "dirty_y1 > dirty_y2"
+ */
+static int dirty_y1 = DUNGEON_HGT;
+static int dirty_x1 = DUNGEON_WID;
+static int dirty_y2 = -1;
+static int dirty_x2 = -1;
+
+
+/**
+ * Record the grids that "los()" would check, in order, on the way from
+ * (0,0) to (dy,dx).  Must match "los()" step for step, except that the
+ * "knight's move" shortcut is left to view_los().
+ */
+static int view_path(int dy, int dx, int *gy, int *gx)
+{
+	int ax = ABS(dx), ay = ABS(dy);
+	int sx = (dx < 0) ? -1 : 1, sy = (dy < 0) ? -1 : 1;
+	int qx, qy, tx, ty, f1, f2, m;
+	int n = 0;
+
+	/* Adjacent (or identical) grids */
+	if ((ax < 2) && (ay < 2))
+		return 0;
+
+	/* Directly South/North */
+	if (!dx) {
+		for (ty = sy; ty != dy; ty += sy) {
+			gy[n] = ty;
+			gx[n++] = 0;
+		}
+		return n;
+	}
+
+	/* Directly East/West */
+	if (!dy) {
+		for (tx = sx; tx != dx; tx += sx) {
+			gy[n] = 0;
+			gx[n++] = tx;
+		}
+		return n;
+	}
+
+	f2 = (ax * ay);
+	f1 = f2 << 1;
+
+	/* Travel horizontally */
+	if (ax >= ay) {
+		qy = ay * ay;
+		m = qy << 1;
+		tx = sx;
+
+		if (qy == f2) {
+			ty = sy;
+			qy -= f1;
+		} else {
+			ty = 0;
+		}
+
+		while (dx - tx) {
+			gy[n] = ty;
+			gx[n++] = tx;
+
+			qy += m;
+
+			if (qy < f2) {
+				tx += sx;
+			} else if (qy > f2) {
+				ty += sy;
+				gy[n] = ty;
+				gx[n++] = tx;
+				qy -= f1;
+				tx += sx;
+			} else {
+				ty += sy;
+				qy -= f1;
+				tx += sx;
+			}
+		}
+	}
+
+	/* Travel vertically */
+	else {
+		qx = ax * ax;
+		m = qx << 1;
+		ty = sy;
+
+		if (qx == f2) {
+			tx = sx;
+			qx -= f1;
+		} else {
+			tx = 0;
+		}
+
+		while (dy - ty) {
+			gy[n] = ty;
+			gx[n++] = tx;
+
+			qx += m;
+
+			if (qx < f2) {
+				ty += sy;
+			} else if (qx > f2) {
+				tx += sx;
+				gy[n] = ty;
+				gx[n++] = tx;
+				qx -= f1;
+				ty += sy;
+			} else {
+				tx += sx;
+				qx -= f1;
+				ty += sy;
+			}
+		}
+	}
+
+	return n;
+}
+
+/**
+ * Lay out the subtree rooted at node "i" of the linked tree in preorder,
+ * returning its size.
+ */
+static int view_flatten(int i, const int *child, const int *sibling,
+						const view_node *tree, int *remap)
+{
+	int here = view_num++;
+	int size = 1;
+	int c;
+
+	view_nodes[here] = tree[i];
+	remap[i] = here;
+
+	for (c = child[i]; c >= 0; c = sibling[c])
+		size += view_flatten(c, child, sibling, tree, remap);
+
+	view_nodes[here].skip = size;
+	return size;
+}
+
+/**
+ * Build the view tree
+ */
+void view_init(void)
+{
+	int gy[VIEW_PATH_MAX], gx[VIEW_PATH_MAX];
+	int *child, *sibling, *remap;
+	view_node *tree;
+	int alloc = VIEW_DIAM * VIEW_DIAM * 4;
+	int num = 0;
+	int dy, dx, i, n, c;
+
+	tree = mem_zalloc(alloc * sizeof(*tree));
+	child = mem_zalloc(alloc * sizeof(*child));
+	sibling = mem_zalloc(alloc * sizeof(*sibling));
+
+	/* Node 0 is the root, which is not checked itself */
+	child[0] = sibling[0] = -1;
+	num = 1;
+
+	for (dy = -VIEW_RAD; dy <= VIEW_RAD; dy++) {
+		for (dx = -VIEW_RAD; dx <= VIEW_RAD; dx++) {
+			int node = 0;
+
+			n = view_path(dy, dx, gy, gx);
+
+			/* Walk down the tree, adding nodes as needed */
+			for (i = 0; i < n; i++) {
+				for (c = child[node]; c >= 0; c = sibling[c])
+					if ((tree[c].dy == gy[i]) && (tree[c].dx == gx[i]))
+						break;
+
+				if (c < 0) {
+					if (num == alloc) {
+						alloc *= 2;
+						tree = mem_realloc(tree, alloc * sizeof(*tree));
+						child = mem_realloc(child, alloc * sizeof(*child));
+						sibling = mem_realloc(sibling,
+											  alloc * sizeof(*sibling));
+					}
+
+					c = num++;
+					tree[c].dy = gy[i];
+					tree[c].dx = gx[i];
+					tree[c].d = distance(0, 0, gy[i], gx[i]);
+					child[c] = -1;
+					sibling[c] = child[node];
+					child[node] = c;
+				}
+
+				node = c;
+			}
+
+			/* Remember the tree index for now */
+			view_end[dy + VIEW_RAD][dx + VIEW_RAD] = node;
+		}
+	}
+
+	/* Flatten the tree, then drop the root */
+	view_nodes = mem_zalloc(num * sizeof(*view_nodes));
+	remap = mem_zalloc(num * sizeof(*remap));
+	view_num = 0;
+	(void) view_flatten(0, child, sibling, tree, remap);
+
+	view_num--;
+	memmove(view_nodes, view_nodes + 1, view_num * sizeof(*view_nodes));
+	view_reach = mem_zalloc(MAX(view_num, 1) * sizeof(*view_reach));
+
+	for (dy = 0; dy < VIEW_DIAM; dy++)
+		for (dx = 0; dx < VIEW_DIAM; dx++)
+			view_end[dy][dx] = remap[view_end[dy][dx]] - 1;
+
+	mem_free(remap);
+	mem_free(sibling);
+	mem_free(child);
+	mem_free(tree);
+}
+
+/**
+ * Free the view tree
+ */
+void view_free(void)
+{
+	FREE(view_reach);
+	FREE(view_nodes);
+	view_num = 0;
+}
+
+/**
+ * Trace the view tree outward from the player
+ */
+static void view_trace(int py, int px, int max)
+{
+	int i = 0;
+
+	while (i < view_num) {
+		const view_node *n = &view_nodes[i];
+		int y = py + n->dy;
+		int x = px + n->dx;
+
+		if ((n->d <= max) && in_bounds(y, x) && cave_project(y, x)) {
+			view_reach[i++] = 1;
+		} else {
+			memset(view_reach + i, 0, n->skip);
+			i += n->skip;
+		}
+	}
+}
+
+/**
+ * Equivalent of "los(py, px, py + dy, px + dx)" after view_trace()
+ */
+static bool view_los(int py, int px, int dy, int dx)
+{
+	int ax = ABS(dx);
+	int ay = ABS(dy);
+	int e = view_end[dy + VIEW_RAD][dx + VIEW_RAD];
+
+	/* Vertical "knights" */
+	if ((ax == 1) && (ay == 2)) {
+		if (cave_project(py + ((dy < 0) ? -1 : 1), px))
+			return (TRUE);
+	}
+
+	/* Horizontal "knights" */
+	else if ((ay == 1) && (ax == 2)) {
+		if (cave_project(py, px + ((dx < 0) ? -1 : 1)))
+			return (TRUE);
+	}
+
+	return ((e < 0) || view_reach[e]);
+}
+
+
+/**
+ * The bits of word "w" of a cave_info row which lie in columns x1..x2
+ */
+static u32b view_word_mask(int w, int x1, int x2)
+{
+	u32b m = ~(u32b) 0;
+	int lo = w * CAVE_WORD_BITS;
+	int hi = lo + CAVE_WORD_BITS - 1;
+
+	if (x1 > lo)
+		m &= ~(u32b) 0 << (x1 - lo);
+	if (x2 < hi)
+		m &= ~(u32b) 0 >> (hi - x2);
+
+	return m;
+}
+
+/**
+ * Redraw the grids for the set bits of word "w" of row "y"
+ */
+static void view_light_bits(int y, int w, u32b bits)
+{
+	int b;
+
+	for (b = 0; bits; b++, bits >>= 1)
+		if (bits & 1)
+			light_spot(y, w * CAVE_WORD_BITS + b);
+}
+
+/**
+ * Forget the "SQUARE_VIEW" grids, redrawing as needed
+ */
+void forget_view(void)
+{
+	int y, w;
+
+	for (y = view_y1; y <= view_y2; y++) {
+		for (w = CAVE_WORD(view_x1); w <= CAVE_WORD(view_x2); w++) {
+			u32b *view = &cave_info[SQUARE_VIEW][y][w];
+			u32b v = *view & view_word_mask(w, view_x1, view_x2);
+
+			*view &= ~v;
+			cave_info[SQUARE_SEEN][y][w] &= ~v;
+
+			view_light_bits(y, w, v);
+		}
+	}
+
+	view_valid = FALSE;
+}
+
+/**
+ * Note that the terrain or lighting of a grid has changed, so that the
+ * next update_view() looks at it again.
+ */
+void view_mark_dirty(int y, int x)
+{
+	if (y < dirty_y1)
+		dirty_y1 = y;
+	if (y > dirty_y2)
+		dirty_y2 = y;
+	if (x < dirty_x1)
+		dirty_x1 = x;
+	if (x > dirty_x2)
+		dirty_x2 = x;
+}
+
+/**
+ * Throw away the current view, for when the whole level has changed.
+ */
+void view_invalidate(void)
+{
+	view_valid = FALSE;
+	view_y1 = 0;
+	view_x1 = 0;
+	view_y2 = CAVE_INFO_Y - 1;
+	view_x2 = CAVE_INFO_X - 1;
+}
+
+
+
+/**
+ * Save the old "view" grids for later.  This is "SEEN becomes TEMP, then
+ * clear VIEW and SEEN", a word of grids at a time.
+ */
+static void mark_wasseen(int y1, int x1, int y2, int x2)
+{
+	int y, w;
+
+	for (y = y1; y <= y2; y++) {
+		for (w = CAVE_WORD(x1); w <= CAVE_WORD(x2); w++) {
+			u32b m = view_word_mask(w, x1, x2);
+
+			cave_info[SQUARE_TEMP][y][w] |= cave_info[SQUARE_SEEN][y][w] & m;
+			cave_info[SQUARE_VIEW][y][w] &= ~m;
+			cave_info[SQUARE_SEEN][y][w] &= ~m;
+		}
+	}
+}
+
+/**
+ * Notice and redraw the grids whose "seen" state has changed since
+ * mark_wasseen(), which are those where SEEN and TEMP differ.
+ */
+static void update_seen(int y1, int x1, int y2, int x2, int blind)
+{
+	int y, w, b;
+
+	for (y = y1; y <= y2; y++) {
+		for (w = CAVE_WORD(x1); w <= CAVE_WORD(x2); w++) {
+			u32b m = view_word_mask(w, x1, x2);
+			u32b *seen = &cave_info[SQUARE_SEEN][y][w];
+			u32b *temp = &cave_info[SQUARE_TEMP][y][w];
+			u32b changed;
+
+			if (blind)
+				*seen &= ~m;
+
+			changed = (*seen ^ *temp) & m;
+
+			for (b = 0; changed; b++, changed >>= 1) {
+				int x = w * CAVE_WORD_BITS + b;
+
+				if (!(changed & 1))
+					continue;
+
+				/* Square went from unseen -> seen */
+				if (*seen & ((u32b) 1 << b))
+					note_spot(y, x);
+
+				/* Either way, redraw it */
+				light_spot(y, x);
+			}
+
+			*temp &= ~m;
+		}
+	}
+}
+
+/**
+ * True if the square is a wall square (impedes the player's los).
+ *
+ */
+bool cave_iswall(int y, int x)
+{
+	if (!in_bounds(y, x))
+		return FALSE;
+
+	return !cave_see_through(y, x);
+}
+
+static void become_viewable(int y, int x, int lit, int py, int px)
+{
+	int xc = x;
+	int yc = y;
+	if (square_has(y, x, SQUARE_VIEW))
+		return;
+
+	square_on(y, x, SQUARE_VIEW);
+
+	if (lit)
+		square_on(y, x, SQUARE_SEEN);
+
+	if (square_has(y, x, SQUARE_GLOW)) {
+		if (cave_iswall(y, x)) {
+			/* For walls, move a bit towards the player.
+			 * TODO(elly): huh? why?
+			 */
+			xc = (x < px) ? (x + 1) : (x > px) ? (x - 1) : x;
+			yc = (y < py) ? (y + 1) : (y > py) ? (y - 1) : y;
+		}
+		if (square_has(yc, xc, SQUARE_GLOW))
+			square_on(y, x, SQUARE_SEEN);
+	}
+}
+
+static void update_view_one(int y, int x, int radius, int py, int px)
+{
+	int xc = x;
+	int yc = y;
+
+	int d = distance(y, x, py, px);
+	int lit = d < radius;
+
+	if (d > MAX_SIGHT)
+		return;
+
+	/* Special case for wall lighting. If we are a wall and the square in
+	 * the direction of the player is in LOS, we are in LOS. This avoids
+	 * situations like:
+	 * #1#############
+	 * #............@#
+	 * ###############
+	 * where the wall cell marked '1' would not be lit because the LOS
+	 * algorithm runs into the adjacent wall cell.
+	 */
+	if (cave_iswall(y, x)) {
+		int dx = x - px;
+		int dy = y - py;
+		int ax = ABS(dx);
+		int ay = ABS(dy);
+		int sx = dx > 0 ? 1 : -1;
+		int sy = dy > 0 ? 1 : -1;
+
+		xc = (x < px) ? (x + 1) : (x > px) ? (x - 1) : x;
+		yc = (y < py) ? (y + 1) : (y > py) ? (y - 1) : y;
+
+		/* Check that the cell we're trying to steal LOS from isn't a
+		 * wall. If we don't do this, double-thickness walls will have
+		 * both sides visible.
+		 */
+		if (cave_iswall(yc, xc)) {
+			xc = x;
+			yc = y;
+		}
+
+		/* Check that we got here via the 'knight's move' rule. If so,
+		 * don't steal LOS. */
+		if (ax == 2 && ay == 1) {
+			if (!cave_iswall(y, x - sx) && cave_iswall(y - sy, x - sx)) {
+				xc = x;
+				yc = y;
+			}
+		} else if (ax == 1 && ay == 2) {
+			if (cave_iswall(y - sy, x) && cave_iswall(y - sy, x - sx)) {
+				xc = x;
+				yc = y;
+			}
+		}
+	}
+
+
+	if (view_los(py, px, yc - py, xc - px))
+		become_viewable(y, x, lit, py, px);
+}
+
+/**
+ * Calculate the complete field of view.
+ *
+ * Only the MAX_SIGHT box around the player is examined, along with the box
+ * from the previous call so that grids which have dropped out of view are
+ * noticed.
+ *
+ * If the player has not moved, and their light and blindness are the same,
+ * then only terrain or lighting changes recorded by view_mark_dirty() can
+ * change the view.  Whether a grid is in view only depends on the grids
+ * in the rectangle between it and the player, so a changed grid can only
+ * affect the grids behind it, and only those are recalculated.  If none of
+ * the changes are within sight, nothing needs to be done at all.
+ */
+void update_view(void)
+{
+	int x, y;
+	int y1, x1, y2, x2;
+	int oy1, ox1, oy2, ox2;
+	int py = p_ptr->py;
+	int px = p_ptr->px;
+	int max = MIN(MAX_SIGHT, VIEW_RAD);
+	int blind = p_ptr->timed[TMD_BLIND];
+	bool glow = square_has(py, px, SQUARE_GLOW);
+
+	int radius;
+
+	/* Extract "radius" value */
+	if ((player_has(PF_UNLIGHT) || p_ptr->state.darkness)
+		&& (p_ptr->cur_light <= 0))
+		radius = 2;
+	else
+		radius = p_ptr->cur_light;
+
+	/* Handle real light */
+	if (radius > 0)
+		++radius;
+
+	/* The area in sight */
+	y1 = MAX(py - max, 0);
+	x1 = MAX(px - max, 0);
+	y2 = MIN(py + max, DUNGEON_HGT - 1);
+	x2 = MIN(px + max, DUNGEON_WID - 1);
+
+	if (view_valid && (py == view_py) && (px == view_px) &&
+		(radius == view_radius) && (max == view_max) &&
+		(blind == view_blind) && (glow == view_glow)) {
+		/* Nothing has changed within sight */
+		if ((dirty_y1 > y2) || (dirty_y2 < y1) ||
+			(dirty_x1 > x2) || (dirty_x2 < x1)) {
+			dirty_y1 = DUNGEON_HGT;
+			dirty_x1 = DUNGEON_WID;
+			dirty_y2 = dirty_x2 = -1;
+			return;
+		}
+
+		/* Only look behind the changes */
+		if (dirty_y1 > py)
+			y1 = dirty_y1;
+		if (dirty_y2 < py)
+			y2 = dirty_y2;
+		if (dirty_x1 > px)
+			x1 = dirty_x1;
+		if (dirty_x2 < px)
+			x2 = dirty_x2;
+
+		oy1 = y1;
+		ox1 = x1;
+		oy2 = y2;
+		ox2 = x2;
+	} else {
+		oy1 = view_y1;
+		ox1 = view_x1;
+		oy2 = view_y2;
+		ox2 = view_x2;
+
+		/* Remember where we looked */
+		view_y1 = y1;
+		view_x1 = x1;
+		view_y2 = y2;
+		view_x2 = x2;
+	}
+
+	mark_wasseen(oy1, ox1, oy2, ox2);
+
+	/* Assume we can view the player grid */
+	if ((py >= y1) && (py <= y2) && (px >= x1) && (px <= x2)) {
+		square_on(py, px, SQUARE_VIEW);
+		if (radius > 0 || glow)
+			square_on(py, px, SQUARE_SEEN);
+	}
+
+	/* Find out which grids are in line of sight */
+	view_trace(py, px, max);
+
+	/* View squares we have LOS to */
+	for (y = y1; y <= y2; y++)
+		for (x = x1; x <= x2; x++)
+			update_view_one(y, x, radius, py, px);
+
+	/*** Step 3 -- Complete the algorithm ***/
+
+	/* Cover both the old and the new view */
+	oy1 = MIN(oy1, y1);
+	ox1 = MIN(ox1, x1);
+	oy2 = MAX(oy2, y2);
+	ox2 = MAX(ox2, x2);
+
+	update_seen(oy1, ox1, oy2, ox2, blind);
+
+	/* Remember what the view was calculated from */
+	view_valid = TRUE;
+	view_py = py;
+	view_px = px;
+	view_radius = radius;
+	view_max = max;
+	view_blind = blind;
+	view_glow = glow;
+
+	dirty_y1 = DUNGEON_HGT;
+	dirty_x1 = DUNGEON_WID;
+	dirty_y2 = dirty_x2 = -1;
+}
@@ -91,7 +91,7 @@ int distance(int y1, int x1, int y2, int x2)
  * determining which grids are illuminated by the player's torch, and which
  * grids and monsters can be "seen" by the player, etc).
  */
-bool los(int y1, int x1, int y2, int x2)
+static bool los_aux(int y1, int x1, int y2, int x2)
 {
 	/* Delta */
 	int dx, dy;
@@ -286,6 +286,98 @@ bool los(int y1, int x1, int y2, int x2)
 	return (TRUE);
 }
 
+
+/**
+ * The results of los() and of projectable() calls which ignore monsters are
+ * memoized in a small direct-mapped cache, keyed by the endpoints (and the
+ * projection flags) and stamped with the terrain epoch.  Any change to a
+ * grid's feature bumps the epoch, invalidating every entry at once.
+ */
+#define LOS_CACHE_SIZE	4096
+
+/* "flg" value of los() entries, which no projectable() call uses */
+#define LOS_CACHE_LOS	0xFFFFFFFFL
+
+typedef struct {
+	u32b key;
+	u32b flg;
+	u32b epoch;
+	byte result;
+} los_cache_entry;
+
+static los_cache_entry los_cache[LOS_CACHE_SIZE];
+
+/**
+ * The terrain epoch; entries with epoch 0 are empty
+ */
+static u32b cave_epoch = 1;
+
+/**
+ * Cache statistics, reported by the 'L' debug command
+ */
+u32b los_cache_hits = 0;
+u32b los_cache_misses = 0;
+
+/**
+ * Note that the terrain of the level has changed
+ */
+static void cave_epoch_bump(void)
+{
+	cave_epoch++;
+
+	/* Skip the "empty" epoch on wrap-around */
+	if (!cave_epoch) {
+		C_WIPE(los_cache, LOS_CACHE_SIZE, los_cache_entry);
+		cave_epoch = 1;
+	}
+}
+
+/**
+ * Find the cache slot for a query; TRUE if it holds the answer.  Both
+ * grids must be in bounds, so that each coordinate fits in its byte of the
+ * key.
+ */
+static bool los_cache_find(int y1, int x1, int y2, int x2, u32b flg,
+						   los_cache_entry **entry)
+{
+	u32b key = ((u32b) (y1 & 0xFF) << 24) | ((u32b) (x1 & 0xFF) << 16) |
+		((u32b) (y2 & 0xFF) << 8) | (u32b) (x2 & 0xFF);
+	u32b h = (key ^ (flg * 0x9E3779B1UL)) * 0x9E3779B1UL;
+	los_cache_entry *e = &los_cache[h >> 20 & (LOS_CACHE_SIZE - 1)];
+
+	*entry = e;
+
+	if ((e->epoch == cave_epoch) && (e->key == key) && (e->flg == flg)) {
+		los_cache_hits++;
+		return TRUE;
+	}
+
+	los_cache_misses++;
+
+	e->key = key;
+	e->flg = flg;
+	e->epoch = cave_epoch;
+	return FALSE;
+}
+
+/**
+ * Determine if there is a line of sight between two grids (see los_aux())
+ */
+bool los(int y1, int x1, int y2, int x2)
+{
+	los_cache_entry *e;
+
+	/* Adjacent grids need no work, and queries off the map no key */
+	if (((ABS(y2 - y1) < 2) && (ABS(x2 - x1) < 2)) ||
+		!in_bounds(y1, x1) || !in_bounds(y2, x2))
+		return los_aux(y1, x1, y2, x2);
+
+	if (!los_cache_find(y1, x1, y2, x2, LOS_CACHE_LOS, &e))
+		e->result = los_aux(y1, x1, y2, x2);
+
+	return e->result;
+}
+
 /*
  * Get the direction between two points
  */
@@ -588,14 +680,14 @@ bool dtrap_edge(int y, int x)
 	int i, j;
 
 	/* Check if the square is a dtrap in the first place */
-	if (!sqinfo_has(cave_info[y][x], SQUARE_DTRAP))
+	if (!square_has(y, x, SQUARE_DTRAP))
 		return FALSE;
 
 	/* Check for non-dtrap adjacent grids */
 	for (i = -1; i <= 1; i++)
 		for (j = -1; j <= 1; j++)
 			if (in_bounds_fully(y + i, x + j) &&
-				(!sqinfo_has(cave_info[y + i][x + j], SQUARE_DTRAP)))
+				(!square_has(y + i, x + j, SQUARE_DTRAP)))
 				return TRUE;
 	
 	return FALSE;
@@ -938,11 +1030,11 @@ void map_info(unsigned y, unsigned x, grid_data * g)
 
 	/* Set things we can work out right now */
 	g->f_idx = cave_feat[y][x];
-	g->in_view = sqinfo_has(cave_info[y][x], SQUARE_SEEN) ? TRUE : FALSE;
+	g->in_view = square_has(y, x, SQUARE_SEEN) ? TRUE : FALSE;
 	g->is_player = (cave_m_idx[y][x] < 0) ? TRUE : FALSE;
 	g->m_idx = (g->is_player) ? 0 : cave_m_idx[y][x];
 	g->hallucinate = p_ptr->timed[TMD_IMAGE] ? TRUE : FALSE;
-	g->trapborder = (sqinfo_has(cave_info[y][x], SQUARE_DEDGE)) ? TRUE : FALSE;
+	g->trapborder = (square_has(y, x, SQUARE_DEDGE)) ? TRUE : FALSE;
 	f_ptr = &f_info[g->f_idx];
 
 	/* Apply "mimic" field */
@@ -952,19 +1044,19 @@ void map_info(unsigned y, unsigned x, grid_data * g)
 	if (g->in_view) {
 		g->lighting = FEAT_LIGHTING_LOS;
 
-		if (!sqinfo_has(cave_info[y][x], SQUARE_GLOW)
+		if (!square_has(y, x, SQUARE_GLOW)
 			&& OPT(view_yellow_light))
 			g->lighting = FEAT_LIGHTING_TORCH;
 
 	}
 	/* Unknown */
-	else if (!sqinfo_has(cave_info[y][x], SQUARE_MARK)) {
+	else if (!square_has(y, x, SQUARE_MARK)) {
 		g->f_idx = FEAT_NONE;
 	}
 
 	/* There is a trap in this grid */
-	if (sqinfo_has(cave_info[y][x], SQUARE_TRAP) &&
-		sqinfo_has(cave_info[y][x], SQUARE_MARK)) {
+	if (square_has(y, x, SQUARE_TRAP) &&
+		square_has(y, x, SQUARE_MARK)) {
 		int i;
 
 		/* Scan the current trap list */
@@ -1272,7 +1364,7 @@ void note_spot(int y, int x)
 	object_type *o_ptr;
 
 	/* Require "seen" flag */
-	if (!sqinfo_has(cave_info[y][x], SQUARE_SEEN))
+	if (!square_has(y, x, SQUARE_SEEN))
 		return;
 
 
@@ -1285,11 +1377,11 @@ void note_spot(int y, int x)
 
 
 	/* Hack -- memorize grids */
-	if (sqinfo_has(cave_info[y][x], SQUARE_MARK))
+	if (square_has(y, x, SQUARE_MARK))
 		return;
 
 	/* Memorize */
-	sqinfo_on(cave_info[y][x], SQUARE_MARK);
+	square_on(y, x, SQUARE_MARK);
 }
 
 
@@ -2055,202 +2147,303 @@ void do_cmd_view_map(void)
 
 
 /**
- * Forget the "SQUARE_VIEW" grids, redrawing as needed
+ * Flow layers which are up to date (bit N for layer N).  Layer 0, the
+ * noise flow, always is.
  */
-void forget_view(void)
+static byte flow_layers_built = 0x01;
+
+/**
+ * FLOW_AVOID_* terrains which were on the level when the layers were built
+ */
+static int flow_terrain = 0;
+
+/**
+ * The grids which have a cost in each flow layer, so that a layer can be
+ * erased without a sweep of the whole level
+ */
+static u16b flow_grids[FLOW_MAX][DUNGEON_HGT * DUNGEON_WID];
+static int flow_grid_n[FLOW_MAX];
+
+/**
+ * The frontier of a flow fill.  A fill is breadth-first, so the frontier
+ * only ever holds grids of two consecutive costs, all within
+ * NOISE_STRENGTH grids of the start.
+ */
+#define FLOW_RING	8192
+
+static u16b flow_ring[FLOW_RING];
+
+/**
+ * Grids passed by the current re-centering search are those stamped with
+ * the current search generation, so no clearing is needed between searches.
+ */
+static u16b flow_seen[DUNGEON_HGT][DUNGEON_WID];
+static u16b flow_seen_gen = 0;
+
+/**
+ * Erase one flow layer
+ */
+static void flow_erase(int layer)
 {
-	int x, y;
+	byte (*flow)[DUNGEON_WID] = cave_flow[layer];
+	int i;
 
-	for (y = 0; y < CAVE_INFO_Y; y++) {
-		for (x = 0; x < CAVE_INFO_X; x++) {
-			if (!sqinfo_has(cave_info[y][x], SQUARE_VIEW))
-				continue;
-			sqinfo_off(cave_info[y][x], SQUARE_VIEW);
-			sqinfo_off(cave_info[y][x], SQUARE_SEEN);
-			light_spot(y, x);
-		}
-	}
+	for (i = 0; i < flow_grid_n[layer]; i++)
+		flow[GRID_Y(flow_grids[layer][i])][GRID_X(flow_grids[layer][i])] = 0;
+
+	flow_grid_n[layer] = 0;
 }
 
+/**
+ * Erase all flow information, for a new level
+ */
+void flow_wipe(void)
+{
+	int layer;
 
+	for (layer = 0; layer < FLOW_MAX; layer++)
+		flow_erase(layer);
+
+	flow_layers_built = 0x01;
+}
 
 /**
- * Calculate the complete field of view using a new algorithm
+ * Get the flow layer to use for a monster which avoids the FLOW_AVOID_*
+ * terrains in "avoid".  Fall back to the noise flow if that layer has not
+ * been built, or if none of that terrain is on the level.
  */
-static void mark_wasseen(void)
+int flow_layer_index(int avoid)
 {
-	int x, y;
-	/* Save the old "view" grids for later */
-	for (y = 0; y < CAVE_INFO_Y; y++) {
-		for (x = 0; x < CAVE_INFO_X; x++) {
-			if (sqinfo_has(cave_info[y][x], SQUARE_SEEN))
-				sqinfo_on(cave_info[y][x], SQUARE_TEMP);
-			sqinfo_off(cave_info[y][x], SQUARE_VIEW);
-			sqinfo_off(cave_info[y][x], SQUARE_SEEN);
-		}
-	}
+	int layer = avoid & flow_terrain;
+
+	if (!(flow_layers_built & (1 << layer)))
+		return 0;
+
+	return layer;
 }
 
-static void update_one(int y, int x, int blind)
+/**
+ * Is any grid on the level marked in a cave_tf plane?
+ */
+static bool cave_tf_any(int t)
 {
-	if (blind)
-		sqinfo_off(cave_info[y][x], SQUARE_SEEN);
-
-	/* Square went from unseen -> seen */
-	if (sqinfo_has(cave_info[y][x], SQUARE_SEEN) &&
-		!sqinfo_has(cave_info[y][x], SQUARE_TEMP)) {
-		note_spot(y, x);
-		light_spot(y, x);
-	}
+	int y, w;
 
-	/* Square went from seen -> unseen */
-	if (!sqinfo_has(cave_info[y][x], SQUARE_SEEN) &&
-		sqinfo_has(cave_info[y][x], SQUARE_TEMP))
-		light_spot(y, x);
+	for (y = 0; y < DUNGEON_HGT; y++)
+		for (w = 0; w < CAVE_WORDS; w++)
+			if (cave_tf[t][y][w])
+				return TRUE;
 
-	sqinfo_off(cave_info[y][x], SQUARE_TEMP);
+	return FALSE;
 }
 
 /**
- * True if the square is a wall square (impedes the player's los).
- *
+ * Can noise flow through a grid, for a given flow layer?
  */
-bool cave_iswall(int y, int x)
+static bool flow_passable(int layer, int y, int x)
 {
-	/* Terrain */
-	feature_type *f_ptr;
+	if (tf_has(f_info[cave_feat[y][x]].flags, TF_NO_NOISE))
+		return FALSE;
+
+	if ((layer & FLOW_AVOID_FIRE) && (cave_tf_has(y, x, CAVE_TF_FIERY) ||
+									  cave_tf_has(y, x, CAVE_TF_BURNING)))
+		return FALSE;
 
-	if (!in_bounds(y, x))
+	if ((layer & FLOW_AVOID_WATER) && cave_tf_has(y, x, CAVE_TF_WATERY))
 		return FALSE;
 
-	f_ptr = &f_info[cave_feat[y][x]];
+	if ((layer & FLOW_AVOID_DOORS) && cave_tf_has(y, x, CAVE_TF_DOOR_CLOSED))
+		return FALSE;
 
-	return !tf_has(f_ptr->flags, TF_LOS);
+	return TRUE;
 }
 
-static void become_viewable(int y, int x, int lit, int py, int px)
+/**
+ * Fill an erased flow layer outwards from (y, x), which gets cost "cost",
+ * out to NOISE_STRENGTH grids.
+ */
+static void flow_fill(int layer, int y, int x, int cost)
 {
-	int xc = x;
-	int yc = y;
-	if (sqinfo_has(cave_info[y][x], SQUARE_VIEW))
-		return;
+	byte (*flow)[DUNGEON_WID] = cave_flow[layer];
+	int limit = cost + NOISE_STRENGTH;
+	int head = 0, tail = 0;
+	int d;
 
-	sqinfo_on(cave_info[y][x], SQUARE_VIEW);
+	flow[y][x] = cost;
+	flow_grids[layer][flow_grid_n[layer]++] = GRID(y, x);
+	flow_ring[tail++ & (FLOW_RING - 1)] = GRID(y, x);
 
-	if (lit)
-		sqinfo_on(cave_info[y][x], SQUARE_SEEN);
+	while (head != tail) {
+		u16b grid = flow_ring[head++ & (FLOW_RING - 1)];
 
-	if (sqinfo_has(cave_info[y][x], SQUARE_GLOW)) {
-		if (cave_iswall(y, x)) {
-			/* For walls, move a bit towards the player.
-			 * TODO(elly): huh? why?
-			 */
-			xc = (x < px) ? (x + 1) : (x > px) ? (x - 1) : x;
-			yc = (y < py) ? (y + 1) : (y > py) ? (y - 1) : y;
+		y = GRID_Y(grid);
+		x = GRID_X(grid);
+		cost = flow[y][x] + 1;
+
+		/* Stop at the limit of the noise */
+		if (cost > limit)
+			continue;
+
+		for (d = 0; d < 8; d++) {
+			int y2 = y + ddy_ddd[d];
+			int x2 = x + ddx_ddd[d];
+
+			if (!in_bounds(y2, x2))
+				continue;
+
+			/* Ignore previously marked grids */
+			if (flow[y2][x2])
+				continue;
+
+			/* Ignore walls.  Do not ignore rubble. */
+			if (!flow_passable(layer, y2, x2))
+				continue;
+
+			flow[y2][x2] = cost;
+			flow_grids[layer][flow_grid_n[layer]++] = GRID(y2, x2);
+			flow_ring[tail++ & (FLOW_RING - 1)] = GRID(y2, x2);
 		}
-		if (sqinfo_has(cave_info[yc][xc], SQUARE_GLOW))
-			sqinfo_on(cave_info[y][x], SQUARE_SEEN);
 	}
 }
 
-static void update_view_one(int y, int x, int radius, int py, int px)
+/**
+ * Re-center the noise flow on the character, who has moved a short way
+ * from the last update center.
+ *
+ * Search outwards from the character through grids with flow until the
+ * old center is found, stamping every grid passed.  Those grids are no
+ * further from the character than the old center was, so giving them
+ * their distance from the character, counting up from a center cost lower
+ * than the old one by the route distance, leaves a downhill path to the
+ * character from every grid.  Return FALSE if this cannot be done.
+ */
+static bool flow_recenter(void)
 {
-	int xc = x;
-	int yc = y;
+	byte (*flow)[DUNGEON_WID] = cave_flow[0];
+	int head = 0, tail = 0;
+	int route = 0;
+	bool found = FALSE;
+	int y, x, d;
 
-	int d = distance(y, x, py, px);
-	int lit = d < radius;
+	/* Start a new search, wiping the stamps when the generation wraps */
+	if (!++flow_seen_gen) {
+		C_WIPE(flow_seen, DUNGEON_HGT * DUNGEON_WID, u16b);
+		flow_seen_gen = 1;
+	}
 
-	if (d > MAX_SIGHT)
-		return;
+	flow_seen[p_ptr->py][p_ptr->px] = flow_seen_gen;
+	flow_ring[tail++ & (FLOW_RING - 1)] = GRID(p_ptr->py, p_ptr->px);
 
-	/* Special case for wall lighting. If we are a wall and the square in
-	 * the direction of the player is in LOS, we are in LOS. This avoids
-	 * situations like:
-	 * #1#############
-	 * #............@#
-	 * ###############
-	 * where the wall cell marked '1' would not be lit because the LOS
-	 * algorithm runs into the adjacent wall cell.
-	 */
-	if (cave_iswall(y, x)) {
-		int dx = x - px;
-		int dy = y - py;
-		int ax = ABS(dx);
-		int ay = ABS(dy);
-		int sx = dx > 0 ? 1 : -1;
-		int sy = dy > 0 ? 1 : -1;
-
-		xc = (x < px) ? (x + 1) : (x > px) ? (x - 1) : x;
-		yc = (y < py) ? (y + 1) : (y > py) ? (y - 1) : y;
-
-		/* Check that the cell we're trying to steal LOS from isn't a
-		 * wall. If we don't do this, double-thickness walls will have
-		 * both sides visible.
-		 */
-		if (cave_iswall(yc, xc)) {
-			xc = x;
-			yc = y;
-		}
+	/* Search a ring of grids at a time, until the old center is found */
+	while (!found && (head != tail) && (route <= NOISE_STRENGTH)) {
+		int last = tail;
 
-		/* Check that we got here via the 'knight's move' rule. If so,
-		 * don't steal LOS. */
-		if (ax == 2 && ay == 1) {
-			if (!cave_iswall(y, x - sx) && cave_iswall(y - sy, x - sx)) {
-				xc = x;
-				yc = y;
-			}
-		} else if (ax == 1 && ay == 2) {
-			if (cave_iswall(y - sy, x) && cave_iswall(y - sy, x - sx)) {
-				xc = x;
-				yc = y;
+		route++;
+
+		while (head != last) {
+			u16b grid = flow_ring[head++ & (FLOW_RING - 1)];
+
+			for (d = 0; d < 8; d++) {
+				y = GRID_Y(grid) + ddy_ddd[d];
+				x = GRID_X(grid) + ddx_ddd[d];
+
+				if (!in_bounds(y, x))
+					continue;
+
+				/* Ignore grids without flow, and those already passed */
+				if (!flow[y][x] || (flow_seen[y][x] == flow_seen_gen))
+					continue;
+
+				flow_seen[y][x] = flow_seen_gen;
+				flow_ring[tail++ & (FLOW_RING - 1)] = GRID(y, x);
+
+				if ((y == update_center_y) && (x == update_center_x))
+					found = TRUE;
 			}
 		}
 	}
 
+	/* Lost the old center, or can't reduce the center cost any more */
+	if (!found || (cost_at_center - route < 1))
+		return FALSE;
 
-	if (los(py, px, yc, xc))
-		become_viewable(y, x, lit, py, px);
-}
+	cost_at_center -= route;
 
-void update_view(void)
-{
-	int x, y;
+	/* Refill the stamped grids from the character */
+	head = tail = 0;
+	flow[p_ptr->py][p_ptr->px] = cost_at_center;
+	flow_ring[tail++ & (FLOW_RING - 1)] = GRID(p_ptr->py, p_ptr->px);
 
-	int radius;
+	while (head != tail) {
+		u16b grid = flow_ring[head++ & (FLOW_RING - 1)];
+		int cost = flow[GRID_Y(grid)][GRID_X(grid)] + 1;
 
-	mark_wasseen();
+		for (d = 0; d < 8; d++) {
+			y = GRID_Y(grid) + ddy_ddd[d];
+			x = GRID_X(grid) + ddx_ddd[d];
 
-	/* Extract "radius" value */
-	if ((player_has(PF_UNLIGHT) || p_ptr->state.darkness)
-		&& (p_ptr->cur_light <= 0))
-		radius = 2;
-	else
-		radius = p_ptr->cur_light;
+			if (!in_bounds(y, x))
+				continue;
 
-	/* Handle real light */
-	if (radius > 0)
-		++radius;
+			/* Only lower the stamped grids */
+			if ((flow_seen[y][x] != flow_seen_gen) || (flow[y][x] <= cost))
+				continue;
 
-	/* Assume we can view the player grid */
-	sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_VIEW);
-	if (radius > 0
-		|| sqinfo_has(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW))
-		sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_SEEN);
+			flow[y][x] = cost;
+			flow_ring[tail++ & (FLOW_RING - 1)] = GRID(y, x);
+		}
+	}
 
-	/* View squares we have LOS to */
-	for (y = 0; y < CAVE_INFO_Y; y++)
-		for (x = 0; x < CAVE_INFO_X; x++)
-			update_view_one(y, x, radius, p_ptr->py, p_ptr->px);
+	return TRUE;
+}
 
-	/*** Step 3 -- Complete the algorithm ***/
+/**
+ * Rebuild the flow layers which awake monsters on the level can use.
+ * Layers that would be the same as a simpler one (because the level has
+ * none of the terrain they avoid) are never built.
+ */
+static void update_flow_layers(void)
+{
+	int needed = 0;
+	int i, layer;
+
+	/* Note the terrain on the level which may stop a flow */
+	flow_terrain = 0;
+	if (cave_tf_any(CAVE_TF_FIERY) || cave_tf_any(CAVE_TF_BURNING))
+		flow_terrain |= FLOW_AVOID_FIRE;
+	if (cave_tf_any(CAVE_TF_WATERY))
+		flow_terrain |= FLOW_AVOID_WATER;
+	if (cave_tf_any(CAVE_TF_DOOR_CLOSED))
+		flow_terrain |= FLOW_AVOID_DOORS;
+
+	/* Note the layers awake monsters need */
+	for (i = 1; i < m_max; i++) {
+		monster_type *m_ptr = &m_list[i];
+		monster_race *r_ptr = &r_info[m_ptr->r_idx];
+
+		/* Skip dead and sleeping monsters */
+		if (!m_ptr->r_idx || m_ptr->csleep)
+			continue;
 
-	for (y = 0; y < CAVE_INFO_Y; y++)
-		for (x = 0; x < CAVE_INFO_X; x++)
-			update_one(y, x, p_ptr->timed[TMD_BLIND]);
-}
+		/* Monsters which go through rock never use the flow */
+		if (rf_has(r_ptr->flags, RF_PASS_WALL) ||
+			rf_has(r_ptr->flags, RF_KILL_WALL))
+			continue;
 
+		needed |= 1 << (monster_flow_avoid(m_ptr) & flow_terrain);
+	}
 
+	/* Build them */
+	flow_layers_built = 0x01;
+	for (layer = 1; layer < FLOW_MAX; layer++) {
+		if (!(needed & (1 << layer)))
+			continue;
+
+		flow_erase(layer);
+		flow_fill(layer, p_ptr->py, p_ptr->px, 1);
+		flow_layers_built |= 1 << layer;
+	}
+}
 
 
 /**
@@ -2266,35 +2459,23 @@ void update_view(void)
  * twisty tunnels and mazes.  Monsters can also run away from loud 
  * noises.
  *
- * The biggest limitation of this code is that it does not easily 
- * allow for alternate ways around doors (not all monsters can handle 
- * doors) and lava/water (many monsters are not allowed to enter 
- * water, lava, or both).
- *
- * The flow table is three-dimensional.  The first dimension allows the 
- * table to both store and overwrite grids safely.  The second indicates 
- * whether this value is that for x or for y.  The third is the number 
- * of grids able to be stored at any flow distance.
+ * A full rebuild gives the character's grid a cost of 100.  When the
+ * character moves a short way, the flow is re-centered instead (see
+ * "flow_recenter()"), which only touches the grids around the character.
+ * Once the center cost runs out, or the character is far from the last
+ * full rebuild, the flow is rebuilt.
+ *
+ * This flow does not allow for alternate ways around doors (not all
+ * monsters can handle doors) and lava/water (many monsters are not
+ * allowed to enter water, lava, or both).  So once the noise flow is
+ * updated, the flow layers which awake monsters need are rebuilt as
+ * well; see "update_flow_layers()".
  */
 void update_noise(void)
 {
-	int cost;
-	int route_distance = 0;
-
-	int i, d;
-	int y, x, y2, x2;
-	int last_index;
-	int grid_count = 0;
-
 	int dist;
 	bool full = FALSE;
 
-	/* Note where we get information from, and where we overwrite */
-	int this_cycle = 0;
-	int next_cycle = 1;
-
-	byte flow_table[2][2][8 * NOISE_STRENGTH];
-
 	/* The character's grid has no flow info.  Do a full rebuild. */
 	if (cave_cost[p_ptr->py][p_ptr->px] == 0)
 		full = TRUE;
@@ -2318,130 +2499,30 @@ void update_noise(void)
 			if (ABS(p_ptr->px - update_center_x) > dist)
 				dist = ABS(p_ptr->px - update_center_x);
 
-			/* 
+			/* Still at the last update center */
+			if (!dist)
+				return;
+
+			/*
 			 * We probably cannot decrease the center cost any more.
 			 * We should assume that we have to do a full rebuild.
 			 */
 			if (cost_at_center - (dist + 5) <= 0)
 				full = TRUE;
 
-
-			/* Less than five grids away from last update */
-			else if (dist < 5) {
-				/* We're in LOS of the last update - don't update again */
-				if (los
-					(p_ptr->py, p_ptr->px, update_center_y,
-					 update_center_x))
-					return;
-
-				/* We're not in LOS - update */
-				else
-					full = FALSE;
-			}
-
-			/* Always update if at least five grids away */
-			else
-				full = FALSE;
-		}
-	}
-
-	/* Update */
-	if (!full) {
-		bool found = FALSE;
-
-		/* Start at the character's location */
-		flow_table[this_cycle][0][0] = p_ptr->py;
-		flow_table[this_cycle][1][0] = p_ptr->px;
-		grid_count = 1;
-
-		/* Erase outwards until we hit the previous update center */
-		for (cost = 0; cost <= NOISE_STRENGTH; cost++) {
-			/* 
-			 * Keep track of the route distance to the previous 
-			 * update center.
+			/*
+			 * Less than five grids away from last update, and in LOS
+			 * of it - don't update again
 			 */
-			route_distance++;
-
-
-			/* Get the number of grids we'll be looking at */
-			last_index = grid_count;
-
-			/* Clear the grid count */
-			grid_count = 0;
-
-			/* Get each valid entry in the flow table in turn */
-			for (i = 0; i < last_index; i++) {
-				/* Get this grid */
-				y = flow_table[this_cycle][0][i];
-				x = flow_table[this_cycle][1][i];
-
-				/* Look at all adjacent grids */
-				for (d = 0; d < 8; d++) {
-					/* Child location */
-					y2 = y + ddy_ddd[d];
-					x2 = x + ddx_ddd[d];
-
-					/* Check Bounds */
-					if (!in_bounds(y2, x2))
-						continue;
-
-					/* Ignore illegal grids */
-					if (cave_cost[y2][x2] == 0)
-						continue;
-
-					/* Ignore previously erased grids */
-					if (cave_cost[y2][x2] == 255)
-						continue;
-
-					/* Erase previous info, mark grid */
-					cave_cost[y2][x2] = 255;
-
-					/* Store this grid in the flow table */
-					flow_table[next_cycle][0][grid_count] = y2;
-					flow_table[next_cycle][1][grid_count] = x2;
-
-					/* Increment number of grids stored */
-					grid_count++;
-
-					/* If this is the previous update center, we can stop */
-					if ((y2 == update_center_y) && (x2 == update_center_x))
-						found = TRUE;
-				}
-			}
-
-			/* Stop when we find the previous update center. */
-			if (found)
-				break;
-
-
-			/* Swap write and read portions of the table */
-			if (this_cycle == 0) {
-				this_cycle = 1;
-				next_cycle = 0;
-			} else {
-				this_cycle = 0;
-				next_cycle = 1;
-			}
-		}
-
-		/* 
-		 * Reduce the flow cost assigned to the new center grid by 
-		 * enough to maintain the correct cost slope out to the range 
-		 * we have to update the flow.
-		 */
-		cost_at_center -= route_distance;
-
-		/* We can't reduce the center cost any more.  Do a full rebuild. */
-		if (cost_at_center < 0)
-			full = TRUE;
-
-		else {
-			/* Store the new update center */
-			update_center_y = p_ptr->py;
-			update_center_x = p_ptr->px;
+			if ((dist < 5) && los(p_ptr->py, p_ptr->px, update_center_y,
+								   update_center_x))
+				return;
 		}
 	}
 
+	/* Re-center the flow on the character */
+	if (!full && !flow_recenter())
+		full = TRUE;
 
 	/* Full rebuild */
 	if (full) {
@@ -2455,101 +2536,86 @@ void update_noise(void)
 		/* Save the new noise epicenter */
 		flow_center_y = p_ptr->py;
 		flow_center_x = p_ptr->px;
-		update_center_y = p_ptr->py;
-		update_center_x = p_ptr->px;
-
 
-		/* Erase all of the current flow (noise) information */
-		for (y = 0; y < DUNGEON_HGT; y++) {
-			for (x = 0; x < DUNGEON_WID; x++) {
-				cave_cost[y][x] = 0;
-			}
-		}
+		/* Erase the current flow (noise) information, and rebuild */
+		flow_erase(0);
+		flow_fill(0, p_ptr->py, p_ptr->px, cost_at_center);
 	}
 
+	/* Store the new update center */
+	update_center_y = p_ptr->py;
+	update_center_x = p_ptr->px;
 
-	/*** Update or rebuild the flow ***/
-
-
-	/* Store base cost at the character location */
-	cave_cost[p_ptr->py][p_ptr->px] = cost_at_center;
-
-	/* Store this grid in the flow table, note that we've done so */
-	flow_table[this_cycle][0][0] = p_ptr->py;
-	flow_table[this_cycle][1][0] = p_ptr->px;
-	grid_count = 1;
-
-	/* Extend the noise burst out to its limits */
-	for (cost = cost_at_center + 1;
-		 cost <= cost_at_center + NOISE_STRENGTH; cost++) {
-		/* Get the number of grids we'll be looking at */
-		last_index = grid_count;
-
-		/* Stop if we've run out of work to do */
-		if (last_index == 0)
-			break;
+	/* Rebuild the flow layers to match */
+	update_flow_layers();
+}
 
-		/* Clear the grid count */
-		grid_count = 0;
 
-		/* Get each valid entry in the flow table in turn. */
-		for (i = 0; i < last_index; i++) {
-			/* Get this grid */
-			y = flow_table[this_cycle][0][i];
-			x = flow_table[this_cycle][1][i];
+/**
+ * Scent ages of the 5x5 pattern laid down around the character.  The
+ * corners are too far away to take scent.
+ */
+static const int scent_adjust[5][5] = {
+	{-1, 2, 2, 2, -1},
+	{2, 1, 1, 1, 2},
+	{2, 1, 0, 1, 2},
+	{2, 1, 1, 1, 2},
+	{-1, 2, 2, 2, -1},
+};
 
-			/* Look at all adjacent grids */
-			for (d = 0; d < 8; d++) {
-				/* Child location */
-				y2 = y + ddy_ddd[d];
-				x2 = x + ddx_ddd[d];
+/**
+ * Which grids of the scent pattern the character can see, one bit per
+ * grid (bit i * 5 + j), for each arrangement of projectable grids around
+ * him (bit d set if the grid in direction ddy_ddd[d], ddx_ddd[d] is
+ * projectable).  Everything within two grids is seen or hidden only by
+ * the grids next to the character, so each arrangement need only be
+ * worked out once.
+ */
+static u32b scent_pattern[256];
+static bool scent_pattern_known[256];
 
-				/* Check Bounds */
-				if (!in_bounds(y2, x2))
-					continue;
+/**
+ * Return the grids of the scent pattern in line of sight of the character.
+ */
+static u32b scent_pattern_los(int py, int px)
+{
+	int open = 0;
+	u32b pattern = 0L;
+	int i, j, d;
 
-				/* When doing a rebuild... */
-				if (full) {
-					/* Ignore previously marked grids */
-					if (cave_cost[y2][x2])
-						continue;
+	/* Too near the edge of the dungeon to use the table */
+	bool edge = ((py < 2) || (px < 2) || (py >= DUNGEON_HGT - 2)
+				 || (px >= DUNGEON_WID - 2));
 
-					/* Ignore walls.  Do not ignore rubble. */
-					if (tf_has
-						(f_info[cave_feat[y2][x2]].flags, TF_NO_NOISE))
-						continue;
-				}
+	if (!edge) {
+		for (d = 0; d < 8; d++)
+			if (cave_project(py + ddy_ddd[d], px + ddx_ddd[d]))
+				open |= (1 << d);
 
-				/* When doing an update... */
-				else {
-					/* Ignore all but specially marked grids */
-					if (cave_cost[y2][x2] != 255)
-						continue;
-				}
+		if (scent_pattern_known[open])
+			return (scent_pattern[open]);
+	}
 
-				/* Store cost at this location */
-				cave_cost[y2][x2] = cost;
+	for (i = 0; i < 5; i++) {
+		for (j = 0; j < 5; j++) {
+			int y = i + py - 2;
+			int x = j + px - 2;
 
-				/* Store this grid in the flow table */
-				flow_table[next_cycle][0][grid_count] = y2;
-				flow_table[next_cycle][1][grid_count] = x2;
+			if (!in_bounds(y, x))
+				continue;
 
-				/* Increment number of grids stored */
-				grid_count++;
-			}
+			if (los(py, px, y, x))
+				pattern |= (1L << (i * 5 + j));
 		}
+	}
 
-		/* Swap write and read portions of the table */
-		if (this_cycle == 0) {
-			this_cycle = 1;
-			next_cycle = 0;
-		} else {
-			this_cycle = 0;
-			next_cycle = 1;
-		}
+	if (!edge) {
+		scent_pattern[open] = pattern;
+		scent_pattern_known[open] = TRUE;
 	}
-}
 
+	return (pattern);
+}
 
 /**
  * Characters leave scent trails for perceptive monsters to track.
@@ -2560,12 +2626,12 @@ void update_noise(void)
  * but not to run away from him.
  *
  * Smell is valued according to age.  When a character takes his turn, 
- * scent is aged by one, and new scent of the current age is laid down.  
+ * the scent clock ticks, and new scent is stamped with the current time.  
  * Speedy characters leave more scent, true, but it also ages faster, 
  * which makes it harder to hunt them down.
  *
- * Whenever the age count loops, most of the scent trail is erased and 
- * the age of the remainder is recalculated.
+ * Scent is aged when it is read (see "get_scent()"), so old scent never
+ * needs to be swept away.
  */
 void update_smell(void)
 {
@@ -2575,56 +2641,31 @@ void update_smell(void)
 	int py = p_ptr->py;
 	int px = p_ptr->px;
 
-	feature_type *f_ptr = NULL;
-
-	/* Create a table that controls the spread of scent */
-	int scent_adjust[5][5] = {
-		{250, 2, 2, 2, 250},
-		{2, 1, 1, 1, 2},
-		{2, 1, 0, 1, 2},
-		{2, 1, 1, 1, 2},
-		{250, 2, 2, 2, 250},
-	};
-
-	/* Scent becomes "younger" */
-	scent_when--;
-
-	/* Loop the age and adjust scent values when necessary */
-	if (scent_when <= 0) {
-		/* Scan the entire dungeon */
-		for (y = 0; y < DUNGEON_HGT; y++) {
-			for (x = 0; x < DUNGEON_WID; x++) {
-				/* Ignore non-existent scent */
-				if (cave_when[y][x] == 0)
-					continue;
+	u32b pattern;
 
-				/* Erase the earlier part of the previous cycle */
-				if (cave_when[y][x] > SMELL_STRENGTH)
-					cave_when[y][x] = 0;
-
-				/* Reset the ages of the most recent scent */
-				else
-					cave_when[y][x] =
-						250 - SMELL_STRENGTH + cave_when[y][x];
-			}
-		}
+	feature_type *f_ptr = NULL;
 
-		/* Reset the age value */
-		scent_when = 250 - SMELL_STRENGTH;
-	}
+	/* Scent becomes older */
+	scent_turn++;
 
+	/* Grids blocked by walls from the character */
+	pattern = scent_pattern_los(py, px);
 
 	/* Lay down new scent */
 	for (i = 0; i < 5; i++) {
 		for (j = 0; j < 5; j++) {
+			/* Note grids that are too far away */
+			if (scent_adjust[i][j] < 0)
+				continue;
+
+			/* Grid must not be blocked by walls from the character */
+			if (!(pattern & (1L << (i * 5 + j))))
+				continue;
+
 			/* Translate table to map grids */
 			y = i + py - 2;
 			x = j + px - 2;
 
-			/* Check Bounds */
-			if (!in_bounds(y, x))
-				continue;
-
 			/* Get the feature */
 			f_ptr = &f_info[cave_feat[y][x]];
 
@@ -2633,16 +2674,8 @@ void update_smell(void)
 				continue;
 			}
 
-			/* Grid must not be blocked by walls from the character */
-			if (!los(p_ptr->py, p_ptr->px, y, x))
-				continue;
-
-			/* Note grids that are too far away */
-			if (scent_adjust[i][j] == 250)
-				continue;
-
 			/* Mark the grid with new scent */
-			cave_when[y][x] = scent_when + scent_adjust[i][j];
+			cave_when[y][x] = scent_turn - scent_adjust[i][j];
 		}
 	}
 }
@@ -2694,7 +2727,7 @@ void map_area(int y, int x, bool extended)
 				if (!tf_has(f_ptr->flags, TF_FLOOR) ||
 					tf_has(f_ptr->flags, TF_INTERESTING)) {
 					/* Memorize the object */
-					sqinfo_on(cave_info[y][x], SQUARE_MARK);
+					square_on(y, x, SQUARE_MARK);
 				}
 
 				/* Memorize known walls */
@@ -2706,7 +2739,7 @@ void map_area(int y, int x, bool extended)
 					f_ptr = &f_info[cave_feat[yy][xx]];
 					if (!tf_has(f_ptr->flags, TF_LOS)) {
 						/* Memorize the walls */
-						sqinfo_on(cave_info[yy][xx], SQUARE_MARK);
+						square_on(yy, xx, SQUARE_MARK);
 					}
 				}
 			}
@@ -2757,7 +2790,7 @@ void wiz_light(bool wizard)
 
 		/* Skip objects in vaults, if not a wizard. */
 		if ((wizard == FALSE)
-			&& sqinfo_has(cave_info[o_ptr->iy][o_ptr->ix], SQUARE_ICKY))
+			&& square_has(o_ptr->iy, o_ptr->ix, SQUARE_ICKY))
 			continue;
 
 		/* Memorize */
@@ -2784,11 +2817,11 @@ void wiz_light(bool wizard)
 					f_ptr = &f_info[cave_feat[yy][xx]];
 
 					/* Perma-light the grid (always) */
-					sqinfo_on(cave_info[yy][xx], SQUARE_GLOW);
+					square_on(yy, xx, SQUARE_GLOW);
 
 					/* If not a wizard, do not mark passable grids in vaults */
 					if ((!wizard)
-						&& sqinfo_has(cave_info[yy][xx], SQUARE_ICKY)) {
+						&& square_has(yy, xx, SQUARE_ICKY)) {
 						if (tf_has(f_ptr->flags, TF_PASSABLE))
 							continue;
 					}
@@ -2797,15 +2830,15 @@ void wiz_light(bool wizard)
 					if (!tf_has(f_ptr->flags, TF_FLOOR) ||
 						cave_visible_trap(yy, xx)) {
 						/* Memorize the grid */
-						sqinfo_on(cave_info[yy][xx], SQUARE_MARK);
+						square_on(yy, xx, SQUARE_MARK);
 					}
 				}
 			}
 		}
 	}
 
-	/* Fully update the visuals */
-	p_ptr->update |= (PU_FORGET_VIEW | PU_UPDATE_VIEW | PU_MONSTERS);
+	/* Update the visuals */
+	p_ptr->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
 
 	/* Redraw whole map, monster list */
 	p_ptr->redraw |= (PR_MAP | PR_MONLIST | PR_ITEMLIST);
@@ -2822,15 +2855,14 @@ void wiz_dark(void)
 
 
 	/* Forget every grid */
+	cave_info_clear(SQUARE_MARK);
+	cave_info_clear(SQUARE_DTRAP);
+	cave_info_clear(SQUARE_DEDGE);
+
 	for (y = 0; y < DUNGEON_HGT; y++) {
 		for (x = 0; x < DUNGEON_WID; x++) {
 			int idx;
 
-			/* Process the grid */
-			sqinfo_off(cave_info[y][x], SQUARE_MARK);
-			sqinfo_off(cave_info[y][x], SQUARE_DTRAP);
-			sqinfo_off(cave_info[y][x], SQUARE_DEDGE);
-
 			/* Traps become invisible */
 			idx = visible_trap_idx(y, x);
 			if (idx > -1)
@@ -2873,6 +2905,10 @@ void illuminate(void)
 	if (stage_map[p_ptr->stage][STAGE_TYPE] == CAVE)
 		return;
 
+	/* The lighting of the whole level may change */
+	view_mark_dirty(0, 0);
+	view_mark_dirty(DUNGEON_HGT - 1, DUNGEON_WID - 1);
+
 	/* Apply light or darkness */
 	for (y = 0; y < DUNGEON_HGT; y++) {
 		for (x = 0; x < DUNGEON_WID; x++) {
@@ -2880,29 +2916,29 @@ void illuminate(void)
 			if ((cave_feat[y][x] == FEAT_PERM_SOLID) && !p_ptr->depth) {
 
 				/* Darken and forget the grid */
-				sqinfo_off(cave_info[y][x], SQUARE_GLOW);
-				sqinfo_off(cave_info[y][x], SQUARE_MARK);
+				square_off(y, x, SQUARE_GLOW);
+				square_off(y, x, SQUARE_MARK);
 			}
 
 			/* Special case of shops */
 			else if (cave_feat[y][x] == FEAT_PERM_EXTRA) {
 				/* Illuminate the grid */
-				sqinfo_on(cave_info[y][x], SQUARE_GLOW);
+				square_on(y, x, SQUARE_GLOW);
 
 				/* Memorize the grid */
-				sqinfo_on(cave_info[y][x], SQUARE_MARK);
+				square_on(y, x, SQUARE_MARK);
 			}
 
 			/* Viewable grids (light) */
 			else if (is_daylight) {
 				/* Illuminate the grid */
-				sqinfo_on(cave_info[y][x], SQUARE_GLOW);
+				square_on(y, x, SQUARE_GLOW);
 			}
 
 			/* Viewable grids (dark) */
 			else {
 				/* Darken the grid */
-				sqinfo_off(cave_info[y][x], SQUARE_GLOW);
+				square_off(y, x, SQUARE_GLOW);
 			}
 		}
 	}
@@ -2915,30 +2951,76 @@ void illuminate(void)
 			/* Track shop doorways */
 			if (tf_has(f_ptr->flags, TF_SHOP)) {
 				/* Illuminate and memorise the grid */
-				sqinfo_on(cave_info[y][x], SQUARE_GLOW);
-				sqinfo_on(cave_info[y][x], SQUARE_MARK);
+				square_on(y, x, SQUARE_GLOW);
+				square_on(y, x, SQUARE_MARK);
 
 				for (i = 0; i < 8; i++) {
 					int yy = y + ddy_ddd[i];
 					int xx = x + ddx_ddd[i];
 
 					/* Illuminate and memorise the grid */
-					sqinfo_on(cave_info[yy][xx], SQUARE_GLOW);
-					sqinfo_on(cave_info[yy][xx], SQUARE_MARK);
+					square_on(yy, xx, SQUARE_GLOW);
+					square_on(yy, xx, SQUARE_MARK);
 				}
 			}
 		}
 	}
 
 
-	/* Fully update the visuals */
-	p_ptr->update |= (PU_FORGET_VIEW | PU_UPDATE_VIEW | PU_MONSTERS);
+	/* Update the visuals */
+	p_ptr->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
 
 	/* Redraw map, monster list */
 	p_ptr->redraw |= (PR_MAP | PR_MONLIST | PR_ITEMLIST);
 }
 
 
+/**
+ * The f_info flag mirrored in each of the cave_tf planes
+ */
+static const int cave_tf_flag[CAVE_TF_MAX] = {
+	TF_LOS,
+	TF_PROJECT,
+	TF_PASSABLE,
+	TF_EASY,
+	TF_FIERY,
+	TF_BURNING,
+	TF_WATERY,
+	TF_DOOR_CLOSED
+};
+
+/**
+ * Bring the cave_tf planes of a grid into line with its feature
+ */
+static void cave_tf_update(int y, int x)
+{
+	feature_type *f_ptr = &f_info[cave_feat[y][x]];
+	int t;
+
+	for (t = 0; t < CAVE_TF_MAX; t++) {
+		if (tf_has(f_ptr->flags, cave_tf_flag[t]))
+			cave_tf[t][y][CAVE_WORD(x)] |= CAVE_BIT(x);
+		else
+			cave_tf[t][y][CAVE_WORD(x)] &= ~CAVE_BIT(x);
+	}
+}
+
+/**
+ * Rebuild the cave_tf planes for the whole level, for use after the
+ * feature array has been filled in directly
+ */
+void cave_tf_rebuild(void)
+{
+	int y, x;
+
+	memset(cave_tf, 0, CAVE_TF_MAX * sizeof(cave_plane));
+	cave_epoch_bump();
+
+	for (y = 0; y < DUNGEON_HGT; y++)
+		for (x = 0; x < DUNGEON_WID; x++)
+			cave_tf_update(y, x);
+}
+
 /**
  * Change the "feat" flag for a grid, and notice/redraw the grid. 
  */
@@ -2963,6 +3045,11 @@ void cave_set_feat(int y, int x, int feat)
 	{
 	    /* Change the feature */
 		cave_feat[y][x] = feat;
+		cave_tf_update(y, x);
+		cave_epoch_bump();
+
+		/* The view may have changed */
+		view_mark_dirty(y, x);
 
 		/* Notice/Redraw */
 		if (character_dungeon) {
@@ -2976,6 +3063,106 @@ void cave_set_feat(int y, int x, int feat)
 }
 
 
+/**
+ * Clear every square flag of a grid
+ */
+void square_wipe(int y, int x)
+{
+	int flag;
+
+	for (flag = 0; flag < SQUARE_MAX; flag++)
+		square_off(y, x, flag);
+}
+
+/**
+ * Get the "n"th byte of a grid's square flags, laid out as a bitflag array
+ * (flag FLAG_START is the lowest bit of byte 0).  Used by the savefile.
+ */
+byte square_get_byte(int y, int x, int n)
+{
+	byte b = 0;
+	int i;
+
+	for (i = 0; i < (int) FLAG_WIDTH; i++) {
+		int flag = n * FLAG_WIDTH + i + FLAG_START;
+
+		if ((flag < SQUARE_MAX) && square_has(y, x, flag))
+			b |= (1 << i);
+	}
+
+	return b;
+}
+
+/**
+ * Set the "n"th byte of a grid's square flags, as laid out above
+ */
+void square_set_byte(int y, int x, int n, byte b)
+{
+	int i;
+
+	for (i = 0; i < (int) FLAG_WIDTH; i++) {
+		int flag = n * FLAG_WIDTH + i + FLAG_START;
+
+		if (flag >= SQUARE_MAX)
+			break;
+
+		if (b & (1 << i))
+			square_on(y, x, flag);
+		else
+			square_off(y, x, flag);
+	}
+}
+
+/**
+ * Copy the square flags of a grid into a bitflag array
+ */
+void square_info_get(int y, int x, bitflag f[SQUARE_SIZE])
+{
+	int flag;
+
+	sqinfo_wipe(f);
+
+	for (flag = FLAG_START; flag < SQUARE_MAX; flag++)
+		if (square_has(y, x, flag))
+			sqinfo_on(f, flag);
+}
+
+/**
+ * Set the square flags of a grid from a bitflag array
+ */
+void square_info_set(int y, int x, const bitflag f[SQUARE_SIZE])
+{
+	int flag;
+
+	for (flag = FLAG_START; flag < SQUARE_MAX; flag++) {
+		if (sqinfo_has(f, flag))
+			square_on(y, x, flag);
+		else
+			square_off(y, x, flag);
+	}
+}
+
+/**
+ * Clear every square flag on the level
+ */
+void cave_info_wipe(void)
+{
+	memset(cave_info, 0, SQUARE_MAX * sizeof(cave_plane));
+}
+
+/**
+ * Clear one square flag everywhere on the level
+ */
+void cave_info_clear(int flag)
+{
+	memset(cave_info[flag], 0, sizeof(cave_plane));
+
+	/* Lighting decides what is in view */
+	if (flag == SQUARE_GLOW)
+		view_invalidate();
+}
+
+
 
 /**
  * Determine the path taken by a projection.
@@ -3272,13 +3459,12 @@ int project_path(u16b * gp, int range, int y1, int x1, int y2, int x2,
  * a given grid, if a monster can target the player, and if a clear shot 
  * exists from monster to player.
  */
-byte projectable(int y1, int x1, int y2, int x2, int flg)
+static byte projectable_aux(int y1, int x1, int y2, int x2, int flg)
 {
 	int y, x;
 
 	int grid_n = 0;
 	u16b grid_g[512];
-	feature_type *f_ptr;
 
 	/* Check the projection path */
 	grid_n = project_path(grid_g, MAX_RANGE, y1, x1, y2, x2, flg);
@@ -3296,8 +3482,7 @@ byte projectable(int y1, int x1, int y2, int x2, int flg)
 		return (PROJECT_NO);
 
 	/* Must end in a passable grid. */
-	f_ptr = &f_info[cave_feat[y][x]];
-	if (!tf_has(f_ptr->flags, TF_PASSABLE))
+	if (!cave_passable(y, x))
 		return (PROJECT_NO);
 
 
@@ -3312,6 +3497,26 @@ byte projectable(int y1, int x1, int y2, int x2, int flg)
 	return (PROJECT_NOT_CLEAR);
 }
 
+/**
+ * Determine if a bolt spell cast from (y1,x1) to (y2,x2) will arrive
+ * (see projectable_aux()).  Paths which stop at or check for monsters
+ * depend on more than the terrain, and paths from or to grids off the map
+ * have no cache key, so neither is cached.
+ */
+byte projectable(int y1, int x1, int y2, int x2, int flg)
+{
+	los_cache_entry *e;
+
+	if ((flg & (PROJECT_STOP | PROJECT_CHCK)) || !in_bounds(y1, x1) ||
+		!in_bounds(y2, x2))
+		return projectable_aux(y1, x1, y2, x2, flg);
+
+	if (!los_cache_find(y1, x1, y2, x2, (u32b) flg, &e))
+		e->result = projectable_aux(y1, x1, y2, x2, flg);
+
+	return e->result;
+}
+
 /**
  * Standard "find me a location" function
  *
@@ -3362,12 +3567,21 @@ void scatter(int *yp, int *xp, int y, int x, int d, int m)
 void health_track(int m_idx)
 {
 	/* Track a new guy */
-	p_ptr->health_who = m_idx;
+	p_ptr->health_who = (m_idx > 0) ? monster_handle(m_idx) : 0;
 
 	/* Redraw (later) */
 	p_ptr->redraw |= (PR_HEALTH | PR_MON_MANA);
 }
 
+/**
+ * Get the index of the tracked monster, or 0 if none is tracked or the
+ * tracked monster has gone
+ */
+int health_tracked(void)
+{
+	return (p_ptr->health_who ? monster_handle_idx(p_ptr->health_who) : 0);
+}
+
 
 
 /**
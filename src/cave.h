@@ -21,11 +21,26 @@
  */
 #define NOISE_STRENGTH 45
 
+/**
+ * Flow layers.  Layer 0 is the noise flow itself ("cave_cost"); every other
+ * layer is the same flow but stopped by the terrain named in its index, a
+ * mask of FLOW_AVOID_* bits, for monsters which cannot cross that terrain.
+ */
+#define FLOW_AVOID_FIRE         0x01
+#define FLOW_AVOID_WATER        0x02
+#define FLOW_AVOID_DOORS        0x04
+#define FLOW_MAX                8
+
 /**
  * Character turns it takes for smell to totally dissipate
  */
 #define SMELL_STRENGTH 60
 
+/**
+ * Character turns before a scent trail is gone altogether
+ */
+#define SCENT_MAX_AGE (250 - SMELL_STRENGTH)
+
 /*** Feature Indexes (see "lib/edit/terrain.txt") ***/
 
 /** Nothing */
@@ -110,15 +125,48 @@ enum
 
 #define TF_SIZE                FLAG_SIZE(TF_MAX)
 
-#define tf_has(f, flag)        flag_has_dbg(f, TF_SIZE, flag, #f, #flag)
+#define tf_has(f, flag)        flag_has_fast(f, TF_SIZE, flag)
+
+
+/**
+ * Terrain flags which are tested for single grids in the inner loops (line
+ * of sight, projection paths, movement) are mirrored from f_info into bit
+ * planes shaped like cave_info.  cave_set_feat() keeps them current.
+ */
+enum
+{
+	CAVE_TF_LOS,
+	CAVE_TF_PROJECT,
+	CAVE_TF_PASSABLE,
+	CAVE_TF_EASY,
+	CAVE_TF_FIERY,
+	CAVE_TF_BURNING,
+	CAVE_TF_WATERY,
+	CAVE_TF_DOOR_CLOSED,
+	CAVE_TF_MAX
+};
 
+#define cave_tf_has(Y, X, t) \
+    ((cave_tf[t][Y][CAVE_WORD(X)] & CAVE_BIT(X)) != 0)
 
 /**
  * Determine if a legal grid can be projected through
  * This is a pretty feeble hack -NRM-
  */
 #define cave_project(Y,X) \
-    (tf_has(f_info[cave_feat[Y][X]].flags, TF_PROJECT)) 
+    (cave_tf_has(Y, X, CAVE_TF_PROJECT))
+
+/**
+ * Determine if a legal grid can be seen through
+ */
+#define cave_see_through(Y,X) \
+    (cave_tf_has(Y, X, CAVE_TF_LOS))
+
+/**
+ * Determine if a legal grid can be passed through
+ */
+#define cave_passable(Y,X) \
+    (cave_tf_has(Y, X, CAVE_TF_PASSABLE))
 
 
 /**
@@ -140,7 +188,7 @@ enum
  * Line 2 -- forbid player/monsters
  */
 #define cave_empty_bold(Y,X) \
-    (tf_has(f_info[cave_feat[Y][X]].flags, TF_EASY) && \
+    (cave_tf_has(Y, X, CAVE_TF_EASY) && \
      (cave_m_idx[Y][X] == 0))
 
 /*
@@ -175,13 +223,36 @@ enum
 #define sqinfo_inter(f1, f2)       flag_inter(f1, f2, SQUARE_SIZE)
 #define sqinfo_diff(f1, f2)        flag_diff(f1, f2, SQUARE_SIZE)
 
+/**
+ * The square flags of the level are stored as bit planes: "cave_info" holds
+ * one packed bitmap per SQUARE_* flag, with a bit for each grid and
+ * CAVE_WORDS words to a row.  This lets operations over the whole map (or
+ * a band of it) handle a word of grids at a time.
+ *
+ * There is no longer a bitflag array per grid, so cave_info[y][x] can't be
+ * handed to the sqinfo_*() macros.  Single flags of a grid use
+ * square_has(y, x, flag), square_on() and square_off() in place of
+ * sqinfo_has(cave_info[y][x], flag) and friends, and square_wipe(y, x)
+ * replaces sqinfo_wipe(cave_info[y][x]).  Code that wants a grid's flags
+ * as a set can copy them out with square_info_get(), use the sqinfo_*()
+ * macros on the copy as before, and store them with square_info_set().
+ */
+#define CAVE_INFO_Y	DUNGEON_HGT
+#define CAVE_INFO_X	256
+
+#define CAVE_WORD_BITS             32
+#define CAVE_WORDS                 (CAVE_INFO_X / CAVE_WORD_BITS)
+#define CAVE_WORD(X)               ((X) / CAVE_WORD_BITS)
+#define CAVE_BIT(X)                ((u32b) 1 << ((X) % CAVE_WORD_BITS))
+
+
 /**
  * Determine if a "legal" grid is within "los" of the player
  *
  * Note the use of comparison to zero to force a "boolean" result
  */
 #define player_has_los_bold(Y,X) \
-    (sqinfo_has(cave_info[Y][X], SQUARE_VIEW))
+    (square_has(Y, X, SQUARE_VIEW))
 
 
 /**
@@ -190,7 +261,7 @@ enum
  * Note the use of comparison to zero to force a "boolean" result
  */
 #define player_can_see_bold(Y,X) \
-    (sqinfo_has(cave_info[Y][X], SQUARE_SEEN))
+    (square_has(Y, X, SQUARE_SEEN))
 
 
 /**
@@ -253,22 +324,34 @@ typedef struct
 
 
 /**
- * An array of 256 cave bitflag arrays
+ * One bit plane of square flags
  */
-typedef bitflag grid_256[256][SQUARE_SIZE];
+typedef u32b cave_plane[DUNGEON_HGT][CAVE_WORDS];
 
 /**
  * An array of DUNGEON_WID byte's
  */
 typedef byte byte_wid[DUNGEON_WID];
 
+/**
+ * One layer of flow information
+ */
+typedef byte flow_layer[DUNGEON_HGT][DUNGEON_WID];
+
 /**
  * An array of DUNGEON_WID s16b's
  */
 typedef s16b s16b_wid[DUNGEON_WID];
 
+/**
+ * An array of DUNGEON_WID u32b's
+ */
+typedef u32b u32b_wid[DUNGEON_WID];
+
 
 extern int distance(int y1, int x1, int y2, int x2);
+extern u32b los_cache_hits;
+extern u32b los_cache_misses;
 extern bool los(int y1, int x1, int y2, int x2);
 extern int get_direction (int source_y, int source_x, int target_y, int target_x);
 extern bool no_light(void);
@@ -284,8 +367,15 @@ extern void light_spot(int y, int x);
 extern void prt_map(void);
 extern void display_map(int *cy, int *cx);
 extern void do_cmd_view_map(void);
+extern void view_init(void);
+extern void view_free(void);
 extern void forget_view(void);
+extern void view_mark_dirty(int y, int x);
+extern void view_invalidate(void);
 extern void update_view(void);
+extern bool cave_iswall(int y, int x);
+extern void flow_wipe(void);
+extern int flow_layer_index(int avoid);
 extern void update_noise(void);
 extern void update_smell(void);
 extern void map_area(int y, int x, bool extended);
@@ -293,11 +383,20 @@ extern void wiz_light(bool wizard);
 extern void wiz_dark(void);
 extern void illuminate(void);
 extern void cave_set_feat(int y, int x, int feat);
+extern void square_wipe(int y, int x);
+extern byte square_get_byte(int y, int x, int n);
+extern void square_set_byte(int y, int x, int n, byte b);
+extern void square_info_get(int y, int x, bitflag f[SQUARE_SIZE]);
+extern void square_info_set(int y, int x, const bitflag f[SQUARE_SIZE]);
+extern void cave_info_wipe(void);
+extern void cave_info_clear(int flag);
+extern void cave_tf_rebuild(void);
 extern int project_path(u16b *gp, int range, \
                          int y1, int x1, int y2, int x2, int flg);
 extern byte projectable(int y1, int x1, int y2, int x2, int flg);
 extern void scatter(int *yp, int *xp, int y, int x, int d, int m);
 extern void health_track(int m_idx);
+extern int health_tracked(void);
 extern void monster_race_track(int r_idx);
 extern void track_object(int item);
 extern void track_object_kind(int k_idx);
@@ -308,9 +407,37 @@ extern bool add_temp_cave(int y, int x);
 extern int search_temp_cave(int y, int x, int min, int max);
 void cave_temp_clean(void);
 
-#define CAVE_INFO_Y	DUNGEON_HGT
-#define CAVE_INFO_X	256
 #define MAX_TEMP_GRIDS 256
 
 
+/*
+ * Single square flags of a grid (see "cave_info" above).  Lighting decides
+ * what is in view, so turning SQUARE_GLOW on or off marks the grid for the
+ * next update_view(); the test vanishes for the constant flags nearly every
+ * caller passes.
+ */
+extern u32b (*cave_info)[DUNGEON_HGT][CAVE_WORDS];
+
+static inline bool square_has(int y, int x, int flag)
+{
+	return (cave_info[flag][y][CAVE_WORD(x)] & CAVE_BIT(x)) != 0;
+}
+
+static inline void square_on(int y, int x, int flag)
+{
+	if (flag == SQUARE_GLOW)
+		view_mark_dirty(y, x);
+
+	cave_info[flag][y][CAVE_WORD(x)] |= CAVE_BIT(x);
+}
+
+static inline void square_off(int y, int x, int flag)
+{
+	if (flag == SQUARE_GLOW)
+		view_mark_dirty(y, x);
+
+	cave_info[flag][y][CAVE_WORD(x)] &= ~CAVE_BIT(x);
+}
+
+
 #endif /* !CAVE_H */
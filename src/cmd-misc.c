@@ -46,7 +46,7 @@ void get_feats(int *surroundings)
 			continue;
 
 		/* Must have knowledge */
-		if (!sqinfo_has(cave_info[yy][xx], SQUARE_MARK))
+		if (!square_has(yy, xx, SQUARE_MARK))
 			continue;
 
 		/* Record the feature */
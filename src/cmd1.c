@@ -834,18 +834,18 @@ void move_player(int dir, bool no_options)
 		disturb(0, 0);
 
 		/* Notice unknown obstacles */
-		if (!sqinfo_has(cave_info[y][x], SQUARE_MARK)) {
+		if (!square_has(y, x, SQUARE_MARK)) {
 			/* Closed door */
 			if (tf_has(f_ptr->flags, TF_DOOR_CLOSED)) {
 				msgt(MSG_HITWALL, "You feel a door blocking your way.");
-				sqinfo_on(cave_info[y][x], SQUARE_MARK);
+				square_on(y, x, SQUARE_MARK);
 				light_spot(y, x);
 			}
 
 			/* Wall (or secret door) */
 			else {
 				msgt(MSG_HITWALL, "You feel a wall blocking your way.");
-				sqinfo_on(cave_info[y][x], SQUARE_MARK);
+				square_on(y, x, SQUARE_MARK);
 				light_spot(y, x);
 			}
 		}
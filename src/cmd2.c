@@ -1520,7 +1520,7 @@ int count_feats(int *y, int *x, int flag, bool under)
 			continue;
 
 		/* Must have knowledge */
-		if (!sqinfo_has(cave_info[yy][xx], SQUARE_MARK))
+		if (!square_has(yy, xx, SQUARE_MARK))
 			continue;
 
 		/* Not looking for this feature */
@@ -1562,7 +1562,7 @@ int count_traps(int *y, int *x)
 			continue;
 
 		/* Must have knowledge */
-		if (!sqinfo_has(cave_info[yy][xx], SQUARE_MARK))
+		if (!square_has(yy, xx, SQUARE_MARK))
 			continue;
 
 		/* No trap */
@@ -1645,7 +1645,7 @@ static bool do_cmd_open_test(int y, int x)
 	feature_type *f_ptr = &f_info[cave_feat[y][x]];
 
 	/* Must have knowledge */
-	if (!sqinfo_has(cave_info[y][x], SQUARE_MARK)) {
+	if (!square_has(y, x, SQUARE_MARK)) {
 		/* Message */
 		msg("You see nothing there.");
 
@@ -1845,7 +1845,7 @@ static bool do_cmd_close_test(int y, int x)
 	feature_type *f_ptr = &f_info[cave_feat[y][x]];
 
 	/* Must have knowledge */
-	if (!sqinfo_has(cave_info[y][x], SQUARE_MARK)) {
+	if (!square_has(y, x, SQUARE_MARK)) {
 		/* Message */
 		msg("You see nothing there.");
 
@@ -1969,7 +1969,7 @@ static bool do_cmd_tunnel_test(int y, int x)
 	feature_type *f_ptr = &f_info[cave_feat[y][x]];
 
 	/* Must have knowledge */
-	if (!sqinfo_has(cave_info[y][x], SQUARE_MARK)) {
+	if (!square_has(y, x, SQUARE_MARK)) {
 		/* Message */
 		msg("You see nothing there.");
 
@@ -2008,7 +2008,7 @@ static bool twall(int y, int x)
 	sound(MSG_DIG);
 
 	/* Forget the wall */
-	sqinfo_off(cave_info[y][x], SQUARE_MARK);
+	square_off(y, x, SQUARE_MARK);
 
 	/* Remove the feature */
 	if (outside)
@@ -2250,7 +2250,7 @@ void do_cmd_tunnel(cmd_code code, cmd_arg args[])
 static bool do_cmd_disarm_test(int y, int x)
 {
 	/* Must have knowledge */
-	if (!sqinfo_has(cave_info[y][x], SQUARE_MARK)) {
+	if (!square_has(y, x, SQUARE_MARK)) {
 		/* Message */
 		msg("You see nothing there.");
 
@@ -2436,7 +2436,7 @@ static bool do_cmd_bash_test(int y, int x)
 	feature_type *f_ptr = &f_info[cave_feat[y][x]];
 
 	/* Must have knowledge */
-	if (!sqinfo_has(cave_info[y][x], SQUARE_MARK)) {
+	if (!square_has(y, x, SQUARE_MARK)) {
 		/* Message */
 		msg("You see nothing there.");
 
@@ -2647,7 +2647,7 @@ void do_cmd_alter_aux(int dir)
 	f_ptr = &f_info[feat];
 
 	/* Must have knowledge to know feature XXX XXX */
-	if (!sqinfo_has(cave_info[y][x], SQUARE_MARK))
+	if (!square_has(y, x, SQUARE_MARK))
 		feat = FEAT_NONE;
 
 
@@ -2713,7 +2713,7 @@ void do_cmd_alter_aux(int dir)
 	}
 
 	/* Disarm traps */
-	else if (sqinfo_has(cave_info[y][x], SQUARE_TRAP)) {
+	else if (square_has(y, x, SQUARE_TRAP)) {
 		/* Disarm */
 		more = do_cmd_disarm_aux(y, x);
 	}
@@ -2781,7 +2781,7 @@ bool do_cmd_spike_test(int y, int x)
 	feature_type *f_ptr = &f_info[cave_feat[y][x]];
 
 	/* Must have knowledge */
-	if (!sqinfo_has(cave_info[y][x], SQUARE_MARK)) {
+	if (!square_has(y, x, SQUARE_MARK)) {
 		/* Message */
 		msg("You see nothing there.");
 
@@ -2873,12 +2873,12 @@ void do_cmd_spike(cmd_code code, cmd_arg args[])
 
 		/* Convert "locked" to "stuck" XXX XXX XXX */
 		if (!tf_has(f_ptr->flags, TF_DOOR_JAMMED)) {
-			cave_feat[y][x] += 0x08;
+			cave_set_feat(y, x, cave_feat[y][x] + 0x08);
 		}
 
 		/* Add one spike to the door */
 		if (cave_feat[y][x] != FEAT_DOOR_TAIL) {
-			cave_feat[y][x] += 0x01;
+			cave_set_feat(y, x, cave_feat[y][x] + 0x01);
 		}
 
 		/* Use up, and describe, a single spike, from the bottom */
@@ -2911,7 +2911,7 @@ static bool do_cmd_walk_test(int y, int x)
 
 
 	/* Hack -- walking obtains knowledge XXX XXX */
-	if (!sqinfo_has(cave_info[y][x], SQUARE_MARK))
+	if (!square_has(y, x, SQUARE_MARK))
 		return (TRUE);
 
 	/* Check for being stuck in a web */
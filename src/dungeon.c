@@ -533,7 +533,7 @@ static void process_world(void)
         if(randint1(f_ptr->duration) == 1)
         {
         	/* Remove the feature */
-        	sqinfo_off(cave_info[cave_temp[i][0]][cave_temp[i][1]], SQUARE_MARK);
+        	square_off(cave_temp[i][0], cave_temp[i][1], SQUARE_MARK);
         	cave_set_feat(cave_temp[i][0], cave_temp[i][1], FEAT_FLOOR);
         	
         	/* Remove from list */
@@ -2091,7 +2091,7 @@ static void dungeon(void)
 			cave_set_feat(py, px, p_ptr->create_stair);
 
 			/* Mark the stairs as known */
-			sqinfo_on(cave_info[py][px], SQUARE_MARK);
+			square_on(py, px, SQUARE_MARK);
 		}
 
 		/* Cancel the stair request */
@@ -2199,18 +2199,11 @@ static void dungeon(void)
 		if (m_cnt + 32 > z_info->m_max)
 			compact_monsters(64);
 
-		/* Hack -- Compress the monster list occasionally */
-		if (m_cnt + 32 < m_max)
-			compact_monsters(0);
-
-
 		/* Hack -- Compact the object list occasionally */
 		if (o_cnt + 32 > z_info->o_max)
 			compact_objects(64);
 
-		/* Hack -- Compress the object list occasionally */
-		if (o_cnt + 32 < o_max)
-			compact_objects(0);
+		/* Freed indexes are reused, so there is no need to compress */
 
 
 	/*** Apply energy ***/
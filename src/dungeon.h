@@ -3,6 +3,7 @@
 
 extern u16b daycount;
 
+extern void init_artifacts(void);
 extern void play_game(void);
 extern void idle_update(void);
 
@@ -3260,7 +3260,7 @@ bool effect_do(effect_type effect, bool * ident, bool aware, int dir)
 						continue;
 
 					/* Skip grids in vaults */
-					if (sqinfo_has(cave_info[y][x], SQUARE_ICKY))
+					if (square_has(y, x, SQUARE_ICKY))
 						continue;
 
 					/* Lava now */
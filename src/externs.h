@@ -100,8 +100,10 @@ extern bool repair_mflag_show;
 extern bool repair_mflag_mark;
 extern s16b o_max;
 extern s16b o_cnt;
+extern s16b o_free_num;
 extern s16b m_max;
 extern s16b m_cnt;
+extern s16b m_free_num;
 extern u16b trap_max;
 extern u16b trap_cnt;
 extern u16b group_id;
@@ -120,20 +122,22 @@ extern int temp_n;
 extern u16b *temp_g;
 extern byte *temp_y;
 extern byte *temp_x;
+extern s16b *temp_m_idx;
 extern u16b (*adjacency)[NUM_STAGES];
 extern u16b (*stage_path)[NUM_STAGES];
 extern u16b (*temp_path)[NUM_STAGES];
 extern u16b (*race_prob)[NUM_STAGES];
 extern byte *dummy;
-extern bitflag (*cave_info)[256][SQUARE_SIZE];
+extern u32b (*cave_tf)[DUNGEON_HGT][CAVE_WORDS];
 extern byte (*cave_feat)[DUNGEON_WID];
 extern s16b (*cave_o_idx)[DUNGEON_WID];
 extern s16b (*cave_m_idx)[DUNGEON_WID];
 extern byte cave_temp[MAX_TEMP_GRIDS][2];
 
+extern byte (*cave_flow)[DUNGEON_HGT][DUNGEON_WID];
 extern byte (*cave_cost)[DUNGEON_WID];
-extern byte (*cave_when)[DUNGEON_WID];
-extern int scent_when;
+extern u32b (*cave_when)[DUNGEON_WID];
+extern u32b scent_turn;
 extern int flow_center_y;
 extern int flow_center_x;
 extern int update_center_y;
@@ -142,7 +146,15 @@ extern int cost_at_center;
 
 extern trap_type *trap_list;
 extern object_type *o_list;
+extern s16b *o_free;
+extern u16b *o_gen;
 extern monster_type *m_list;
+extern s16b *m_free;
+extern u16b *m_gen;
+extern s16b *mon_bucket;
+extern s16b *mon_bucket_count;
+extern s16b *mon_bucket_next;
+extern u32b *mon_bucket_mark;
 extern monster_lore *l_list;
 extern struct store_type *store;
 extern const char *** name_sections;
@@ -150,11 +162,15 @@ extern object_type *inventory;
 extern object_type *quiver;
 extern s16b alloc_kind_size;
 extern alloc_entry *alloc_kind_table;
+extern u32b *alloc_kind_cum;
 extern s16b alloc_ego_size;
 extern alloc_entry *alloc_ego_table;
+extern u32b *alloc_ego_cum;
 extern s16b alloc_race_size;
 extern alloc_entry *alloc_race_table;
 extern u32b alloc_race_total;
+extern u32b *alloc_race_cut;
+extern s16b *alloc_race_alias;
 extern byte gf_to_attr[GF_MAX][BOLT_MAX];
 extern wchar_t gf_to_char[GF_MAX][BOLT_MAX];
 extern byte misc_to_attr[256];
@@ -272,6 +288,9 @@ extern bool py_attack(int y, int x, bool can_push);
 void death_screen(void);
 
 /* pathfind.c */
+extern char pf_result[];
+extern int pf_result_index;
+extern bool is_valid_pf(int y, int x);
 extern bool findpath(int y, int x);
 extern int get_angle_to_target(int y0, int x0, int y1, int x1, int dir);
 extern void run_step(int dir);
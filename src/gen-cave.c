@@ -178,7 +178,7 @@ static void build_streamer(int feat, int chance)
 				/* Hack -- Add some (known) treasure */
 				if (time_to_treas == 0) {
 					time_to_treas = randint1(chance * 2);
-					cave_feat[y][dx] += 0x04;
+					cave_set_feat(y, dx, cave_feat[y][dx] + 0x04);
 				}
 			}
 		}
@@ -216,7 +216,7 @@ static void build_streamer(int feat, int chance)
 				/* Hack -- Add some (known) treasure */
 				if (time_to_treas == 0) {
 					time_to_treas = randint1(chance * 2);
-					cave_feat[dy][x] += 0x04;
+					cave_set_feat(dy, x, cave_feat[dy][x] + 0x04);
 				}
 			}
 		}
@@ -384,11 +384,11 @@ void destroy_level(bool new_level)
 					}
 
 					/* No longer part of a room or vault */
-					sqinfo_off(cave_info[y][x], SQUARE_ROOM);
-					sqinfo_off(cave_info[y][x], SQUARE_ICKY);
+					square_off(y, x, SQUARE_ROOM);
+					square_off(y, x, SQUARE_ICKY);
 
 					/* No longer illuminated */
-					sqinfo_off(cave_info[y][x], SQUARE_GLOW);
+					square_off(y, x, SQUARE_GLOW);
 				}
 			}
 		}
@@ -820,7 +820,7 @@ static void try_door(int y0, int x0)
 		return;
 
 	/* Ignore room grids */
-	if (sqinfo_has(cave_info[y0][x0], SQUARE_ROOM))
+	if (square_has(y0, x0, SQUARE_ROOM))
 		return;
 
 	/* Occasional door (if allowed) */
@@ -837,7 +837,7 @@ static void try_door(int y0, int x0)
 				continue;
 
 			/* Skip grids inside rooms */
-			if (sqinfo_has(cave_info[y][x], SQUARE_ROOM))
+			if (square_has(y, x, SQUARE_ROOM))
 				continue;
 
 			/* We require at least two walls outside of rooms. */
@@ -1028,7 +1028,7 @@ void build_tunnel(int start_room, int end_room)
 
 			/* We're in our destination room - head straight for target. */
 			if ((tmp == end_room) &&
-				sqinfo_has(cave_info[row1][col1], SQUARE_ROOM)) {
+				square_has(row1, col1, SQUARE_ROOM)) {
 				correct_dir(&row_dir, &col_dir, row1, col1, row2, col2);
 			}
 
@@ -1265,7 +1265,7 @@ void build_tunnel(int start_room, int end_room)
 
 			/* Forbid re-entry near this piercing. */
 			if ((!unalterable(cave_feat[row1 + row_dir][col1 + col_dir]))
-				&& sqinfo_has(cave_info[row1][col1], SQUARE_ROOM)) {
+				&& square_has(row1, col1, SQUARE_ROOM)) {
 				if (row_dir) {
 					for (x = col1 - 3; x <= col1 + 3; x++) {
 						/* Convert adjacent "outer" walls */
@@ -1496,7 +1496,7 @@ void build_tunnel(int start_room, int end_room)
 		}
 
 		/* Travel quickly through rooms. */
-		else if (sqinfo_has(cave_info[tmp_row][tmp_col], SQUARE_ROOM)) {
+		else if (square_has(tmp_row, tmp_col, SQUARE_ROOM)) {
 			/* Accept the location */
 			row1 = tmp_row;
 			col1 = tmp_col;
@@ -1830,6 +1830,9 @@ extern void cave_gen(void)
 		}
 	}
 
+	/* Update the terrain flags to match */
+	cave_tf_rebuild();
+
 	/* Actual maximum number of rooms on this level */
 	dun->row_rooms = DUNGEON_HGT / BLOCK_HGT;
 	dun->col_rooms = DUNGEON_WID / BLOCK_WID;
@@ -2106,7 +2109,7 @@ extern void cave_gen(void)
 	/* Clear "temp" flags. */
 	for (y = 0; y < DUNGEON_HGT; y++) {
 		for (x = 0; x < DUNGEON_WID; x++) {
-			sqinfo_off(cave_info[y][x], SQUARE_TEMP);
+			square_off(y, x, SQUARE_TEMP);
 		}
 	}
 }
@@ -160,9 +160,9 @@ static bool generate_room(int y1, int x1, int y2, int x2, int light)
 
 	for (y = y1; y <= y2; y++) {
 		for (x = x1; x <= x2; x++) {
-			sqinfo_on(cave_info[y][x], SQUARE_ROOM);
+			square_on(y, x, SQUARE_ROOM);
 			if (light)
-				sqinfo_on(cave_info[y][x], SQUARE_GLOW);
+				square_on(y, x, SQUARE_GLOW);
 		}
 	}
 
@@ -195,7 +195,7 @@ extern void generate_mark(int y1, int x1, int y2, int x2, int flg)
 
 	for (y = y1; y <= y2; y++) {
 		for (x = x1; x <= x2; x++) {
-			sqinfo_on(cave_info[y][x], flg);
+			square_on(y, x, flg);
 		}
 	}
 }
@@ -713,7 +713,7 @@ extern bool generate_starburst_room(int y1, int x1, int y2, int x2,
 	for (y = y1 + 1; y < y2; y++) {
 		for (x = x1 + 1; x < x2; x++) {
 			/* Do not touch "icky" grids. */
-			if (sqinfo_has(cave_info[y][x], SQUARE_ICKY))
+			if (square_has(y, x, SQUARE_ICKY))
 				continue;
 
 			/* Do not touch occupied grids. */
@@ -753,17 +753,17 @@ extern bool generate_starburst_room(int y1, int x1, int y2, int x2,
 								cave_set_feat(y, x, feat);
 
 								if (tf_has(f_ptr->flags, TF_FLOOR))
-									sqinfo_on(cave_info[y][x],
+									square_on(y, x,
 											  SQUARE_ROOM);
 								else
-									sqinfo_off(cave_info[y][x],
+									square_off(y, x,
 											   SQUARE_ROOM);
 
 								if (light)
-									sqinfo_on(cave_info[y][x],
+									square_on(y, x,
 											  SQUARE_GLOW);
 								else
-									sqinfo_off(cave_info[y][x],
+									square_off(y, x,
 											   SQUARE_GLOW);
 							}
 
@@ -792,7 +792,7 @@ extern bool generate_starburst_room(int y1, int x1, int y2, int x2,
 
 								/* Light grid. */
 								if (light)
-									sqinfo_on(cave_info[y][x],
+									square_on(y, x,
 											  SQUARE_GLOW);
 							}
 						}
@@ -821,11 +821,11 @@ extern bool generate_starburst_room(int y1, int x1, int y2, int x2,
 						int xx = x + ddx_ddd[d];
 
 						/* Join to room */
-						sqinfo_on(cave_info[yy][xx], SQUARE_ROOM);
+						square_on(yy, xx, SQUARE_ROOM);
 
 						/* Illuminate if requested. */
 						if (light)
-							sqinfo_on(cave_info[yy][xx], SQUARE_GLOW);
+							square_on(yy, xx, SQUARE_GLOW);
 
 						/* Look for dungeon granite. */
 						if (cave_feat[yy][xx] == FEAT_WALL_EXTRA) {
@@ -1119,7 +1119,7 @@ static bool build_type1(void)
 				if (!light) {
 					for (y = y1 - 1; y <= y2 + 1; y++) {
 						for (x = x1 - 1; x <= x2 + 1; x++) {
-							sqinfo_on(cave_info[y][x], SQUARE_GLOW);
+							square_on(y, x, SQUARE_GLOW);
 						}
 					}
 				}
@@ -2303,11 +2303,11 @@ static bool build_type6(void)
 						continue;
 
 					/* Turn into room. */
-					sqinfo_on(cave_info[yy][xx], SQUARE_ROOM);
+					square_on(yy, xx, SQUARE_ROOM);
 
 					/* Illuminate if requested. */
 					if (light)
-						sqinfo_on(cave_info[yy][xx], SQUARE_GLOW);
+						square_on(yy, xx, SQUARE_GLOW);
 				}
 			}
 		}
@@ -2426,12 +2426,12 @@ extern bool build_vault(int y0, int x0, int ymax, int xmax,
 
 			/* Part of a vault.  Can be lit.  May be "icky". */
 			if (icky) {
-				sqinfo_on(cave_info[y][x], SQUARE_ICKY);
-				sqinfo_on(cave_info[y][x], SQUARE_ROOM);
+				square_on(y, x, SQUARE_ICKY);
+				square_on(y, x, SQUARE_ROOM);
 			} else if (stage_map[p_ptr->stage][STAGE_TYPE] == CAVE)
-				sqinfo_on(cave_info[y][x], SQUARE_ROOM);
+				square_on(y, x, SQUARE_ROOM);
 			if (light)
-				sqinfo_on(cave_info[y][x], SQUARE_GLOW);
+				square_on(y, x, SQUARE_GLOW);
 
 			/* Analyze the grid */
 			switch (*t) {
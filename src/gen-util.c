@@ -118,7 +118,7 @@ void new_player_spot(void)
 			x = randint0(DUNGEON_WID);
 
 			/* Refuse to start on anti-teleport (vault) grids */
-			if (sqinfo_has(cave_info[y][x], SQUARE_ICKY))
+			if (square_has(y, x, SQUARE_ICKY))
 				continue;
 
 			/* Must be a "naked" floor grid */
@@ -402,7 +402,7 @@ void alloc_object(int set, int typ, int num)
 				continue;
 
 			/* Check for "room" */
-			room = sqinfo_has(cave_info[y][x], SQUARE_ROOM) ? TRUE : FALSE;
+			room = square_has(y, x, SQUARE_ROOM) ? TRUE : FALSE;
 
 			/* Require corridor? */
 			if ((set == ALLOC_SET_CORR) && room)
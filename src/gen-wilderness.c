@@ -687,7 +687,7 @@ static int make_formation(int y, int x, int base_feat1, int base_feat2,
 					f_ptr = &f_info[cave_feat[yy][xx]];
 					if ((tf_has(f_ptr->flags, TF_PERMANENT))
 						|| (distance(yy, xx, p_ptr->py, p_ptr->px) < 20)
-						|| sqinfo_has(cave_info[yy][xx], SQUARE_ICKY))
+						|| square_has(yy, xx, SQUARE_ICKY))
 						good_place = FALSE;
 				}
 		} else
@@ -738,7 +738,7 @@ static int make_formation(int y, int x, int base_feat1, int base_feat2,
 		if (((cave_feat[ty][tx] != base_feat1)
 			 && (cave_feat[ty][tx] != base_feat2))
 			|| !(in_bounds_fully(ty, tx))
-			|| sqinfo_has(cave_info[ty][tx], SQUARE_ICKY)) {
+			|| square_has(ty, tx, SQUARE_ICKY)) {
 			free(all_feat);
 			return (total);
 		}
@@ -752,7 +752,7 @@ static int make_formation(int y, int x, int base_feat1, int base_feat2,
 
 		/* Set the feature */
 		cave_set_feat(ty, tx, all_feat[i]);
-		sqinfo_on(cave_info[ty][tx], SQUARE_ICKY);
+		square_on(ty, tx, SQUARE_ICKY);
 
 		/* Choose a random step for next feature, try to keep going */
 		terrain = randint0(8) + 1;
@@ -761,7 +761,7 @@ static int make_formation(int y, int x, int base_feat1, int base_feat2,
 		for (j = 0; j < 100; j++) {
 			ty += ddy[terrain];
 			tx += ddx[terrain];
-			if (!sqinfo_has(cave_info[ty][tx], SQUARE_ICKY))
+			if (!square_has(ty, tx, SQUARE_ICKY))
 				break;
 		}
 
@@ -838,7 +838,7 @@ static int populate(bool valley)
 	/* Clear "temp" flags. */
 	for (y = 0; y < DUNGEON_HGT; y++) {
 		for (x = 0; x < DUNGEON_WID; x++) {
-			sqinfo_off(cave_info[y][x], SQUARE_TEMP);
+			square_off(y, x, SQUARE_TEMP);
 
 			/* Paranoia - remake the dungeon walls */
 			if ((y == 0) || (x == 0) || (y == DUNGEON_HGT - 1)
@@ -879,6 +879,9 @@ extern void plain_gen(void)
 		}
 	}
 
+	/* Update the terrain flags to match */
+	cave_tf_rebuild();
+
 
 	/* Place 2 or 3 paths to neighbouring stages, place player -NRM- */
 	alloc_paths(stage, last_stage);
@@ -911,7 +914,7 @@ extern void plain_gen(void)
 	/* No longer "icky" */
 	for (y = 0; y < DUNGEON_HGT; y++) {
 		for (x = 0; x < DUNGEON_WID; x++) {
-			sqinfo_off(cave_info[y][x], SQUARE_ICKY);
+			square_off(y, x, SQUARE_ICKY);
 		}
 	}
 
@@ -933,7 +936,7 @@ static void mtn_connect(int y, int x, int y1, int x1)
 			|| (!in_bounds_fully(GRID_Y(gp[j]), GRID_X(gp[j]))))
 			break;
 		cave_set_feat(GRID_Y(gp[j]), GRID_X(gp[j]), FEAT_ROAD);
-		sqinfo_on(cave_info[GRID_Y(gp[j])][GRID_X(gp[j])], SQUARE_ICKY);
+		square_on(GRID_Y(gp[j]), GRID_X(gp[j]), SQUARE_ICKY);
 	}
 }
 
@@ -977,6 +980,9 @@ extern void mtn_gen(void)
 		}
 	}
 
+	/* Update the terrain flags to match */
+	cave_tf_rebuild();
+
 	/* Make stage boundaries */
 	make_edges(FALSE, FALSE);
 
@@ -1014,7 +1020,7 @@ extern void mtn_gen(void)
 		for (x = 0; x < DUNGEON_WID; x++)
 			if (cave_feat[y][x] == FEAT_ROAD) {
 				/* Hack - prepare for plateaux, connecting */
-				sqinfo_on(cave_info[y][x], SQUARE_ICKY);
+				square_on(y, x, SQUARE_ICKY);
 				floors++;
 			}
 	}
@@ -1125,7 +1131,7 @@ extern void mtn_gen(void)
 			case FEAT_GRASS:
 				{
 					cave_set_feat(y, x, FEAT_WALL_SOLID);
-					sqinfo_on(cave_info[y][x], SQUARE_WALL);
+					square_on(y, x, SQUARE_WALL);
 					break;
 				}
 			case FEAT_SHOP_HEAD:
@@ -1136,7 +1142,7 @@ extern void mtn_gen(void)
 			case FEAT_SHOP_HEAD + 1:
 				{
 					cave_set_feat(y, x, FEAT_MAGMA);
-					sqinfo_on(cave_info[y][x], SQUARE_WALL);
+					square_on(y, x, SQUARE_WALL);
 					break;
 				}
 			case FEAT_SHOP_HEAD + 2:
@@ -1166,7 +1172,7 @@ extern void mtn_gen(void)
 	/* No longer "icky" */
 	for (y = 0; y < DUNGEON_HGT; y++) {
 		for (x = 0; x < DUNGEON_WID; x++) {
-			sqinfo_off(cave_info[y][x], SQUARE_ICKY);
+			square_off(y, x, SQUARE_ICKY);
 
 			/* Paranoia - remake the dungeon walls */
 			if ((y == 0) || (x == 0) || (y == DUNGEON_HGT - 1)
@@ -1205,6 +1211,9 @@ extern void mtntop_gen(void)
 		}
 	}
 
+	/* Update the terrain flags to match */
+	cave_tf_rebuild();
+
 	/* Make stage boundaries */
 	make_edges(FALSE, FALSE);
 
@@ -1221,8 +1230,8 @@ extern void mtntop_gen(void)
 
 	/* Summit */
 	for (i = -1; i <= 1; i++) {
-		cave_feat[y + i][x] = FEAT_WALL_SOLID;
-		cave_feat[y][x + i] = FEAT_WALL_SOLID;
+		cave_set_feat(y + i, x, FEAT_WALL_SOLID);
+		cave_set_feat(y, x + i, FEAT_WALL_SOLID);
 	}
 
 	/* Count the floors */
@@ -1269,7 +1278,7 @@ extern void mtntop_gen(void)
 				floors--;
 				if (floors == spot) {
 					player_place(y1, x1);
-					sqinfo_on(cave_info[y1][x1], SQUARE_ICKY);
+					square_on(y1, x1, SQUARE_ICKY);
 					continue;
 				}
 			}
@@ -1348,7 +1357,7 @@ extern void mtntop_gen(void)
 	/* No longer "icky" */
 	for (y = 0; y < DUNGEON_HGT; y++) {
 		for (x = 0; x < DUNGEON_WID; x++) {
-			sqinfo_off(cave_info[y][x], SQUARE_ICKY);
+			square_off(y, x, SQUARE_ICKY);
 
 			/* Paranoia - remake the dungeon walls */
 			if ((y == 0) || (x == 0) || (y == DUNGEON_HGT - 1)
@@ -1383,7 +1392,7 @@ extern void mtntop_gen(void)
 	/* Clear "temp" flags. */
 	for (y = 0; y < DUNGEON_HGT; y++) {
 		for (x = 0; x < DUNGEON_WID; x++) {
-			sqinfo_off(cave_info[y][x], SQUARE_TEMP);
+			square_off(y, x, SQUARE_TEMP);
 		}
 	}
 }
@@ -1420,6 +1429,9 @@ extern void forest_gen(void)
 		}
 	}
 
+	/* Update the terrain flags to match */
+	cave_tf_rebuild();
+
 	/* Place 2 or 3 paths to neighbouring stages, place player -NRM- */
 	alloc_paths(stage, last_stage);
 
@@ -1438,7 +1450,7 @@ extern void forest_gen(void)
 					cave_set_feat(y, x, FEAT_TREE);
 			} else
 				/* Hack - prepare for clearings */
-				sqinfo_on(cave_info[y][x], SQUARE_ICKY);
+				square_on(y, x, SQUARE_ICKY);
 
 			/* Mega hack - remove paths if emerging from Nan Dungortheb */
 			if ((last_stage == q_list[2].stage)
@@ -1473,7 +1485,7 @@ extern void forest_gen(void)
 	/* No longer "icky" */
 	for (y = 0; y < DUNGEON_HGT; y++) {
 		for (x = 0; x < DUNGEON_WID; x++) {
-			sqinfo_off(cave_info[y][x], SQUARE_ICKY);
+			square_off(y, x, SQUARE_ICKY);
 		}
 	}
 
@@ -1503,7 +1515,7 @@ extern void forest_gen(void)
 	/* No longer "icky" */
 	for (y = 0; y < DUNGEON_HGT; y++) {
 		for (x = 0; x < DUNGEON_WID; x++) {
-			sqinfo_off(cave_info[y][x], SQUARE_ICKY);
+			square_off(y, x, SQUARE_ICKY);
 		}
 	}
 
@@ -1540,6 +1552,9 @@ extern void swamp_gen(void)
 		}
 	}
 
+	/* Update the terrain flags to match */
+	cave_tf_rebuild();
+
 	/* Place 2 or 3 paths to neighbouring stages, place player -NRM- */
 	alloc_paths(stage, last_stage);
 
@@ -1578,7 +1593,7 @@ extern void swamp_gen(void)
 	/* No longer "icky" */
 	for (y = 0; y < DUNGEON_HGT; y++) {
 		for (x = 0; x < DUNGEON_WID; x++) {
-			sqinfo_off(cave_info[y][x], SQUARE_ICKY);
+			square_off(y, x, SQUARE_ICKY);
 		}
 	}
 
@@ -1618,6 +1633,9 @@ extern void desert_gen(void)
 		}
 	}
 
+	/* Update the terrain flags to match */
+	cave_tf_rebuild();
+
 	/* Place 2 or 3 paths to neighbouring stages, place player -NRM- */
 	alloc_paths(stage, last_stage);
 
@@ -1667,7 +1685,7 @@ extern void desert_gen(void)
 					cave_set_feat(y, x, FEAT_MAGMA);
 			} else
 				/* Hack - prepare for clearings */
-				sqinfo_on(cave_info[y][x], SQUARE_ICKY);
+				square_on(y, x, SQUARE_ICKY);
 		}
 	}
 
@@ -1697,7 +1715,7 @@ extern void desert_gen(void)
 	/* No longer "icky" */
 	for (y = 0; y < DUNGEON_HGT; y++) {
 		for (x = 0; x < DUNGEON_WID; x++) {
-			sqinfo_off(cave_info[y][x], SQUARE_ICKY);
+			square_off(y, x, SQUARE_ICKY);
 		}
 	}
 
@@ -1718,7 +1736,7 @@ extern void desert_gen(void)
 	/* No longer "icky" */
 	for (y = 0; y < DUNGEON_HGT; y++) {
 		for (x = 0; x < DUNGEON_WID; x++) {
-			sqinfo_off(cave_info[y][x], SQUARE_ICKY);
+			square_off(y, x, SQUARE_ICKY);
 		}
 	}
 
@@ -1757,6 +1775,9 @@ extern void river_gen(void)
 		}
 	}
 
+	/* Update the terrain flags to match */
+	cave_tf_rebuild();
+
 	/* Place 2 or 3 paths to neighbouring stages, place player -NRM- */
 	alloc_paths(stage, last_stage);
 
@@ -1775,7 +1796,7 @@ extern void river_gen(void)
 		for (x = i - randint0(5) - 10; x < i + randint0(5) + 10; x++) {
 			/* Make the river */
 			cave_set_feat(y, x, FEAT_WATER);
-			sqinfo_on(cave_info[y][x], SQUARE_ICKY);
+			square_on(y, x, SQUARE_ICKY);
 		}
 		/* Meander */
 		i += randint0(3) - 1;
@@ -1848,7 +1869,7 @@ extern void river_gen(void)
 	/* No longer "icky" */
 	for (y = 0; y < DUNGEON_HGT; y++) {
 		for (x = 0; x < DUNGEON_WID; x++) {
-			sqinfo_off(cave_info[y][x], SQUARE_ICKY);
+			square_off(y, x, SQUARE_ICKY);
 		}
 	}
 
@@ -1919,7 +1940,7 @@ bool place_web(int type)
 					|| (cave_feat[y][x] == FEAT_PERM_SOLID)
 					|| (cave_feat[y][x] == FEAT_MORE_SOUTH) ||
 					((y == p_ptr->py) && (x == p_ptr->px))
-					|| sqinfo_has(cave_info[y][x], SQUARE_ICKY))
+					|| square_has(y, x, SQUARE_ICKY))
 					no_good = TRUE;
 
 		/* Try again, or stop if we've found a place */
@@ -2029,7 +2050,7 @@ extern void valley_gen(void)
 	/* No longer "icky" */
 	for (y = 0; y < DUNGEON_HGT; y++) {
 		for (x = 0; x < DUNGEON_WID; x++) {
-			sqinfo_off(cave_info[y][x], SQUARE_ICKY);
+			square_off(y, x, SQUARE_ICKY);
 		}
 	}
 
@@ -2041,7 +2062,7 @@ extern void valley_gen(void)
 		p_ptr->path_coord = 0;
 
 		/* Make sure a web can't be placed on the player */
-		sqinfo_on(cave_info[y][x], SQUARE_ICKY);
+		square_on(y, x, SQUARE_ICKY);
 	}
 
 	/* Place objects, traps and monsters */
@@ -2060,7 +2081,7 @@ extern void valley_gen(void)
 	/* Clear "temp" flags. */
 	for (y = 0; y < DUNGEON_HGT; y++) {
 		for (x = 0; x < DUNGEON_WID; x++) {
-			sqinfo_off(cave_info[y][x], SQUARE_TEMP);
+			square_off(y, x, SQUARE_TEMP);
 
 			/* Paranoia - remake the dungeon walls */
 			if ((y == 0) || (x == 0) || (y == DUNGEON_HGT - 1)
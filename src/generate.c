@@ -435,23 +435,28 @@ static void clear_cave(void)
 	wipe_o_list();
 	wipe_m_list();
 	wipe_trap_list();
-	/* Clear flags and flow information. */
+	/* No flags */
+	cave_info_wipe();
+
+	/* No flow */
+	flow_wipe();
+
+	/* Clear features and scent information. */
 	for (y = 0; y < DUNGEON_HGT; y++) {
 		for (x = 0; x < DUNGEON_WID; x++) {
 			/* No features */
 			cave_feat[y][x] = 0;
 
-			/* No flags */
-			sqinfo_wipe(cave_info[y][x]);
-
-			/* No flow */
-			cave_cost[y][x] = 0;
+			/* No scent */
 			cave_when[y][x] = 0;
 
 			/* Clear any left-over monsters (should be none) and the player. */
 			cave_m_idx[y][x] = 0;
 		}
 	}
+
+	/* Update the terrain flags to match */
+	cave_tf_rebuild();
 	
 	/* Clear list of temporary features */
 	for (y = 0; y < MAX_TEMP_GRIDS; y++)
@@ -463,6 +468,9 @@ static void clear_cave(void)
 	/* Mega-Hack -- no player in dungeon yet */
 	p_ptr->px = p_ptr->py = 0;
 
+	/* The old view is meaningless now */
+	view_invalidate();
+
 	/* Hack -- illegal panel */
 	Term->offset_y = DUNGEON_HGT;
 	Term->offset_x = DUNGEON_WID;
@@ -511,19 +519,21 @@ void generate_cave(void)
 
 		/* Reset monsters and objects */
 		o_max = 1;
+		o_free_num = 0;
 		m_max = 1;
+		m_free_num = 0;
 
 
-		/* Clear flags and flow information. */
+		/* No flags */
+		cave_info_wipe();
+
+		/* No flow */
+		flow_wipe();
+
+		/* Clear scent information. */
 		for (y = 0; y < DUNGEON_HGT; y++) {
 			for (x = 0; x < DUNGEON_WID; x++) {
-				/* No flags */
-				sqinfo_wipe(cave_info[y][x]);
-
-				/* No flow */
-				cave_cost[y][x] = 0;
 				cave_when[y][x] = 0;
-
 			}
 		}
 
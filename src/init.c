@@ -176,13 +176,12 @@ static const char *brand_values[] = {
 
 static u32b grab_one_effect(const char *what)
 {
-	size_t i;
+	int i;
 
-	/* Scan activations */
-	for (i = 0; i < N_ELEMENTS(effect_list); i++) {
-		if (streq(what, effect_list[i]))
-			return i;
-	}
+	/* Look up activations */
+	i = lookup_table_name(effect_list, 0, N_ELEMENTS(effect_list), what);
+	if (i >= 0)
+		return i;
 
 	/* Oops */
 	msg("Unknown effect '%s'.", what);
@@ -198,24 +197,23 @@ u32b grab_value(const char *what, const char **value_type, int num,
 	char s[80];
 	char *t;
 
-	my_strcpy(s, what, strlen(what));
+	my_strcpy(s, what, sizeof(s));
 
 	/* Find the first bracket */
 	for (t = s; *t && (*t != '['); ++t)	/* loop */
 		;
 
-	/* Get the value */
-	if (1 != sscanf(t + 1, "%d", val))
-		return (PARSE_ERROR_INVALID_VALUE);
+	/* Get the value, which must be there */
+	if (!*t || (1 != sscanf(t + 1, "%d", val)))
+		return (0);
 
 	/* Terminate the string */
 	*t = '\0';
 
 	/* Check the possibilities */
-	for (i = 0; i < num; i++) {
-		if (streq(s, value_type[i]))
-			return i;
-	}
+	i = lookup_table_name(value_type, 0, num, s);
+	if (i >= 0)
+		return i;
 
 	/* Not found */
 	return (0);
@@ -2168,11 +2166,8 @@ static const char *r_info_blow_method[] = {
 
 static int find_blow_method(const char *name)
 {
-	int i;
-	for (i = 0; r_info_blow_method[i]; i++)
-		if (streq(name, r_info_blow_method[i]))
-			break;
-	return i;
+	int i = lookup_table_name(r_info_blow_method, 0, -1, name);
+	return (i < 0) ? (int) N_ELEMENTS(r_info_blow_method) - 1 : i;
 }
 
 static const char *r_info_blow_effect[] = {
@@ -2184,11 +2179,8 @@ static const char *r_info_blow_effect[] = {
 
 static int find_blow_effect(const char *name)
 {
-	int i;
-	for (i = 0; r_info_blow_effect[i]; i++)
-		if (streq(name, r_info_blow_effect[i]))
-			break;
-	return i;
+	int i = lookup_table_name(r_info_blow_effect, 0, -1, name);
+	return (i < 0) ? (int) N_ELEMENTS(r_info_blow_effect) - 1 : i;
 }
 
 static enum parser_error parse_r_b(struct parser *p)
@@ -4424,8 +4416,11 @@ static errr init_other(void)
 
 	/*** Prepare dungeon arrays ***/
 
-	/* Padded into array */
-	cave_info = C_ZNEW(DUNGEON_HGT, grid_256);
+	/* Square flags, one bit plane per flag */
+	cave_info = C_ZNEW(SQUARE_MAX, cave_plane);
+
+	/* Terrain flags, mirrored from the feature array */
+	cave_tf = C_ZNEW(CAVE_TF_MAX, cave_plane);
 
 	/* Feature array */
 	cave_feat = C_ZNEW(DUNGEON_HGT, byte_wid);
@@ -4435,17 +4430,30 @@ static errr init_other(void)
 	cave_m_idx = C_ZNEW(DUNGEON_HGT, s16b_wid);
 
 	/* Flow arrays */
-	cave_cost = C_ZNEW(DUNGEON_HGT, byte_wid);
-	cave_when = C_ZNEW(DUNGEON_HGT, byte_wid);
+	cave_flow = C_ZNEW(FLOW_MAX, flow_layer);
+	cave_cost = cave_flow[0];
+	cave_when = C_ZNEW(DUNGEON_HGT, u32b_wid);
+
+	/* Field of view tables */
+	view_init();
 
 
 	/*** Prepare entity arrays ***/
 
 	/* Objects */
 	o_list = C_ZNEW(z_info->o_max, object_type);
+	o_free = C_ZNEW(z_info->o_max, s16b);
+	o_gen = C_ZNEW(z_info->o_max, u16b);
 
 	/* Monsters */
 	m_list = C_ZNEW(z_info->m_max, monster_type);
+	m_free = C_ZNEW(z_info->m_max, s16b);
+	m_gen = C_ZNEW(z_info->m_max, u16b);
+	temp_m_idx = C_ZNEW(z_info->m_max, s16b);
+	mon_bucket = C_ZNEW(MON_BUCKET_HGT * MON_BUCKET_WID, s16b);
+	mon_bucket_count = C_ZNEW(MON_BUCKET_HGT * MON_BUCKET_WID, s16b);
+	mon_bucket_next = C_ZNEW(z_info->m_max, s16b);
+	mon_bucket_mark = C_ZNEW(MON_MARK_WORDS, u32b);
 
 	/* Traps */
 	trap_list = C_ZNEW(z_info->l_max, trap_type);
@@ -4627,6 +4635,9 @@ static errr init_alloc(void)
 	/* Allocate the alloc_kind_table */
 	alloc_kind_table = C_ZNEW(alloc_kind_size, alloc_entry);
 
+	/* Allocate the running totals for it */
+	alloc_kind_cum = C_ZNEW(ALLOC_KIND_CACHE * alloc_kind_size, u32b);
+
 	/* Access the table entry */
 	table = alloc_kind_table;
 
@@ -4707,6 +4718,10 @@ static errr init_alloc(void)
 	/* Allocate the alloc_race_table */
 	alloc_race_table = C_ZNEW(alloc_race_size, alloc_entry);
 
+	/* Allocate the alias table used to draw from it */
+	alloc_race_cut = C_ZNEW(alloc_race_size, u32b);
+	alloc_race_alias = C_ZNEW(alloc_race_size, s16b);
+
 	/* Get the table entry */
 	table = alloc_race_table;
 
@@ -4780,6 +4795,9 @@ static errr init_alloc(void)
 	/* Allocate the alloc_ego_table */
 	alloc_ego_table = C_ZNEW(alloc_ego_size, alloc_entry);
 
+	/* Allocate the running totals for it */
+	alloc_ego_cum = C_ZNEW(ALLOC_EGO_CACHE * alloc_ego_size, u32b);
+
 	/* Get the table entry */
 	table = alloc_ego_table;
 
@@ -4957,6 +4975,528 @@ void update_artifact_sets()
 	}
 }
 
+/*** Binary caches of parsed template files ***/
+
+/**
+ * Layout version of the binary caches; change it when their layout does
+ */
+#define INFO_CACHE_FORMAT	1
+
+/**
+ * The most string fields in a cached record
+ */
+#define INFO_CACHE_STRINGS	3
+
+/**
+ * An info array which is saved to a binary cache once it has been parsed,
+ * so later runs can load it without parsing its template file.
+ *
+ * Strings are saved as offsets into a block of text (zero for none), stale
+ * list pointers are cleared, and any other pointers are turned into indexes
+ * by "pack" and back by "unpack".
+ */
+struct info_cache {
+	void **info;			/**< The info array */
+	size_t max;			/**< Offset of its size in z_info */
+	size_t size;			/**< Size of a record */
+	size_t next;			/**< Offset of the stale list pointer */
+	size_t strings[INFO_CACHE_STRINGS];	/**< Offsets of string fields */
+	int num_strings;
+	void (*pack)(void *record);
+	bool (*unpack)(void *record);
+};
+
+/**
+ * Header of a binary cache file
+ */
+struct info_cache_head {
+	char version[64];	/**< Game version and build time */
+	u32b format;		/**< INFO_CACHE_FORMAT */
+	u32b hash;		/**< Hash of the template files */
+	u32b size;		/**< Size of a record */
+	u32b count;		/**< Number of records */
+	u32b text_len;		/**< Length of the text block */
+};
+
+/**
+ * Store an offset or index in a pointer field of a record
+ */
+static void info_cache_put(void *record, size_t offset, size_t value)
+{
+	memcpy((char *) record + offset, &value, sizeof(value));
+}
+
+/**
+ * Get an offset or index back out of a pointer field of a record
+ */
+static size_t info_cache_get(const void *record, size_t offset)
+{
+	size_t value;
+
+	memcpy(&value, (const char *) record + offset, sizeof(value));
+	return value;
+}
+
+/**
+ * Turn a monster race's base into its place in the monster base list
+ */
+static void pack_r(void *record)
+{
+	monster_race *r_ptr = record;
+	monster_base *rb;
+	size_t i = 1;
+
+	for (rb = rb_info; rb && (rb != r_ptr->base); rb = rb->next)
+		i++;
+
+	info_cache_put(r_ptr, offsetof(monster_race, base), rb ? i : 0);
+}
+
+/**
+ * Turn a place in the monster base list back into a monster race's base
+ */
+static bool unpack_r(void *record)
+{
+	monster_race *r_ptr = record;
+	monster_base *rb = rb_info;
+	size_t i = info_cache_get(r_ptr, offsetof(monster_race, base));
+
+	if (!i) {
+		r_ptr->base = NULL;
+		return TRUE;
+	}
+
+	while (rb && --i)
+		rb = rb->next;
+
+	r_ptr->base = rb;
+	return (rb != NULL);
+}
+
+static struct info_cache f_cache = {
+	(void **) &f_info, offsetof(maxima, f_max),
+	sizeof(feature_type), offsetof(feature_type, next),
+	{ offsetof(feature_type, name), offsetof(feature_type, text) }, 2,
+	NULL, NULL
+};
+
+static struct info_cache k_cache = {
+	(void **) &k_info, offsetof(maxima, k_max),
+	sizeof(object_kind), offsetof(object_kind, next),
+	{ offsetof(object_kind, name), offsetof(object_kind, text) }, 2,
+	NULL, NULL
+};
+
+static struct info_cache e_cache = {
+	(void **) &e_info, offsetof(maxima, e_max),
+	sizeof(ego_item_type), offsetof(ego_item_type, next),
+	{ offsetof(ego_item_type, name), offsetof(ego_item_type, text) }, 2,
+	NULL, NULL
+};
+
+static struct info_cache r_cache = {
+	(void **) &r_info, offsetof(maxima, r_max),
+	sizeof(monster_race), offsetof(monster_race, next),
+	{ offsetof(monster_race, name), offsetof(monster_race, text) }, 2,
+	pack_r, unpack_r
+};
+
+static struct info_cache a_cache = {
+	(void **) &a_info, offsetof(maxima, a_max),
+	sizeof(artifact_type), offsetof(artifact_type, next),
+	{ offsetof(artifact_type, name), offsetof(artifact_type, text),
+	  offsetof(artifact_type, effect_msg) }, 3,
+	NULL, NULL
+};
+
+static struct info_cache v_cache = {
+	(void **) &v_info, offsetof(maxima, v_max),
+	sizeof(struct vault), offsetof(struct vault, next),
+	{ offsetof(struct vault, name), offsetof(struct vault, message),
+	  offsetof(struct vault, text) }, 3,
+	NULL, NULL
+};
+
+static struct info_cache t_cache = {
+	(void **) &t_info, offsetof(maxima, t_max),
+	sizeof(struct vault), offsetof(struct vault, next),
+	{ offsetof(struct vault, name), offsetof(struct vault, message),
+	  offsetof(struct vault, text) }, 3,
+	NULL, NULL
+};
+
+/**
+ * Fold the contents of a template file into an FNV-1a hash
+ */
+static u32b info_cache_hash(const char *name, u32b hash)
+{
+	char path[1024];
+	char buf[4096];
+	ang_file *fh;
+	int n, i;
+
+	path_build(path, sizeof(path), ANGBAND_DIR_EDIT, format("%s.txt", name));
+	fh = file_open(path, MODE_READ, -1);
+	if (!fh)
+		return hash;
+
+	while ((n = file_read(fh, buf, sizeof(buf))) > 0)
+		for (i = 0; i < n; i++)
+			hash = (hash ^ (byte) buf[i]) * 16777619UL;
+
+	file_close(fh);
+	return hash;
+}
+
+/**
+ * Check whether a binary cache is newer than a template file it was built
+ * from
+ */
+static bool info_cache_newer(const char *cache, const char *name)
+{
+	char path[1024];
+
+	path_build(path, sizeof(path), ANGBAND_DIR_EDIT, format("%s.txt", name));
+	return file_newer(cache, path);
+}
+
+/**
+ * Fill in the header a binary cache should have
+ */
+static void info_cache_head_make(struct info_cache_head *head,
+								 const struct info_cache *ic, u32b hash)
+{
+	WIPE(head, struct info_cache_head);
+	my_strcpy(head->version, format("%s %s %s", VERSION_STRING, __DATE__,
+									__TIME__), sizeof(head->version));
+	head->format = INFO_CACHE_FORMAT;
+	head->hash = hash;
+	head->size = ic->size;
+	head->count = *(u16b *) ((char *) z_info + ic->max);
+}
+
+/**
+ * Load an info array from its binary cache, returning FALSE (with nothing
+ * changed) if the cache is missing, out of date or damaged.
+ */
+static bool info_cache_load(const struct info_cache *ic, const char *path,
+							u32b hash)
+{
+	struct info_cache_head want, head;
+	ang_file *fh;
+	char *records, *text;
+	size_t len;
+	u32b i;
+	int j;
+	bool ok;
+
+	info_cache_head_make(&want, ic, hash);
+
+	fh = file_open(path, MODE_READ, -1);
+	if (!fh)
+		return FALSE;
+
+	/* Check the header */
+	if ((file_read(fh, (char *) &head, sizeof(head)) != (int) sizeof(head))
+		|| memcmp(head.version, want.version, sizeof(head.version))
+		|| (head.format != want.format) || (head.hash != want.hash)
+		|| (head.size != want.size) || (head.count != want.count)) {
+		file_close(fh);
+		return FALSE;
+	}
+
+	/* Read the records and the text after them */
+	len = head.size * head.count;
+	records = mem_zalloc(len ? len : 1);
+	text = mem_alloc(head.text_len + 1);
+	ok = ((file_read(fh, records, len) == (int) len)
+		  && (file_read(fh, text, head.text_len) == (int) head.text_len));
+	file_close(fh);
+	text[head.text_len] = '\0';
+
+	/* Check the strings, and turn other pointers back */
+	for (i = 0; ok && (i < head.count); i++) {
+		char *record = records + i * head.size;
+
+		for (j = 0; j < ic->num_strings; j++)
+			if (info_cache_get(record, ic->strings[j]) > head.text_len)
+				ok = FALSE;
+
+		if (ok && ic->unpack)
+			ok = ic->unpack(record);
+	}
+
+	if (!ok) {
+		mem_free(text);
+		mem_free(records);
+		return FALSE;
+	}
+
+	/* Make the strings */
+	for (i = 0; i < head.count; i++) {
+		char *record = records + i * head.size;
+
+		for (j = 0; j < ic->num_strings; j++) {
+			size_t offset = info_cache_get(record, ic->strings[j]);
+			char *str = offset ? string_make(text + offset - 1) : NULL;
+
+			memcpy(record + ic->strings[j], &str, sizeof(str));
+		}
+	}
+
+	mem_free(text);
+	*ic->info = records;
+	return TRUE;
+}
+
+/**
+ * Save a freshly parsed info array to its binary cache.  Failure only
+ * means the template file is parsed again next time.
+ */
+static void info_cache_save(const struct info_cache *ic, const char *path,
+							u32b hash)
+{
+	struct info_cache_head head;
+	ang_file *fh;
+	char *records, *text;
+	size_t len, text_len = 0;
+	u32b i;
+	int j;
+	bool ok;
+
+	info_cache_head_make(&head, ic, hash);
+	len = head.size * head.count;
+
+	/* Measure the strings */
+	for (i = 0; i < head.count; i++) {
+		const char *record = (const char *) *ic->info + i * head.size;
+
+		for (j = 0; j < ic->num_strings; j++) {
+			const char *str;
+
+			memcpy(&str, record + ic->strings[j], sizeof(str));
+			if (str)
+				text_len += strlen(str) + 1;
+		}
+	}
+
+	/* Copy the records, moving the strings into the text */
+	records = mem_alloc(len ? len : 1);
+	memcpy(records, *ic->info, len);
+	text = mem_alloc(text_len ? text_len : 1);
+	text_len = 0;
+
+	for (i = 0; i < head.count; i++) {
+		char *record = records + i * head.size;
+
+		for (j = 0; j < ic->num_strings; j++) {
+			const char *str;
+
+			memcpy(&str, record + ic->strings[j], sizeof(str));
+			if (!str) {
+				info_cache_put(record, ic->strings[j], 0);
+				continue;
+			}
+
+			info_cache_put(record, ic->strings[j], text_len + 1);
+			memcpy(text + text_len, str, strlen(str) + 1);
+			text_len += strlen(str) + 1;
+		}
+
+		memset(record + ic->next, 0, sizeof(void *));
+
+		if (ic->pack)
+			ic->pack(record);
+	}
+
+	head.text_len = text_len;
+
+	/* Write the file, removing it again if that fails */
+	fh = file_open(path, MODE_WRITE, FTYPE_RAW);
+	if (fh) {
+		ok = (file_write(fh, (const char *) &head, sizeof(head))
+			  && file_write(fh, records, len)
+			  && file_write(fh, text, text_len));
+		file_close(fh);
+
+		if (!ok)
+			file_delete(path);
+	}
+
+	mem_free(text);
+	mem_free(records);
+}
+
+/*** Loading the template files ***/
+
+/**
+ * A step in loading the template files: the parser to run, with the binary
+ * cache of its info array if it has one, and the other steps (by template
+ * name) whose data it uses, which must be loaded first.
+ */
+struct init_step {
+	struct file_parser *parser;
+	struct info_cache *cache;
+	const char *status;		/**< Progress message */
+	const char *fail;		/**< Message to quit with */
+	void (*after)(void);		/**< What to do once it is loaded */
+	const char *needs[2];
+	bool done;
+};
+
+static struct init_step init_steps[] = {
+	{ &z_parser, NULL, "Initializing array sizes...",
+	  "Cannot initialize sizes", NULL, { NULL } },
+	{ &trap_parser, NULL, "Initializing arrays... (traps)",
+	  "Cannot initialize traps", NULL, { "limits" } },
+	{ &f_parser, &f_cache, "Initializing arrays... (features)",
+	  "Cannot initialize features", NULL, { "limits" } },
+	{ &k_parser, &k_cache, "Initializing arrays... (objects)",
+	  "Cannot initialize objects", NULL, { "limits" } },
+	{ &e_parser, &e_cache, "Initializing arrays... (ego-items)",
+	  "Cannot initialize ego-items", NULL, { "limits" } },
+	{ &mp_parser, NULL, "Initializing arrays... (pain messages)",
+	  "Cannot initialize monster pain messages", NULL, { "limits" } },
+	{ &rb_parser, NULL, "Initializing arrays... (monster bases)",
+	  "Cannot initialize monster bases", NULL, { "pain messages" } },
+	{ &r_parser, &r_cache, "Initializing arrays... (monsters)",
+	  "Cannot initialize monsters", NULL, { "monster_base" } },
+	{ &a_parser, &a_cache, "Initializing arrays... (artifacts)",
+	  "Cannot initialize artifacts", NULL, { "object" } },
+	{ &set_parser, NULL, "Initializing arrays... (set items)",
+	  "Cannot initialize set items", update_artifact_sets, { "artifact" } },
+	{ &v_parser, &v_cache, "Initializing arrays... (vaults)",
+	  "Cannot initialize vaults", NULL, { "limits" } },
+	{ &t_parser, &t_cache, "Initializing arrays... (themed)",
+	  "Cannot initialize themed levels", NULL, { "limits" } },
+	{ &h_parser, NULL, "Initializing arrays... (histories)",
+	  "Cannot initialize histories", NULL, { "limits" } },
+	{ &b_parser, NULL, "Initializing arrays... (stores)",
+	  "Cannot initialize stores", NULL, { "limits" } },
+	{ &p_parser, NULL, "Initializing arrays... (races)",
+	  "Cannot initialize races", NULL, { "limits" } },
+	{ &c_parser, NULL, "Initializing arrays... (classes)",
+	  "Cannot initialize classes", NULL, { "object" } },
+	{ &mark_parser, NULL, "Initializing arrays... (cutie marks)",
+	  "Cannot initialize cutie marks", NULL, { "limits" } },
+	{ &ability_parser, NULL, "Initializing arrays... (innate abilities)",
+	  "Cannot initialize innate abilities", NULL, { "limits" } },
+	{ &flavor_parser, NULL, "Initializing arrays... (flavors)",
+	  "Cannot initialize flavors", NULL, { "object" } },
+	{ &s_parser, NULL, "Initializing arrays... (spells)",
+	  "Cannot initialize spells", NULL, { "limits" } },
+	{ &hints_parser, NULL, "Initializing arrays... (hints)",
+	  "Cannot initialize hints", NULL, { NULL } },
+	{ &names_parser, NULL, "Initializing arrays... (random names)",
+	  "Can't parse names", NULL, { NULL } },
+};
+
+/**
+ * Find the step which loads a template
+ */
+static struct init_step *init_step_find(const char *name)
+{
+	size_t i;
+
+	for (i = 0; i < N_ELEMENTS(init_steps); i++)
+		if (streq(init_steps[i].parser->name, name))
+			return &init_steps[i];
+
+	quit_fmt("No way to load '%s'", name);
+	return NULL;
+}
+
+/**
+ * Fold the templates a step's data comes from, including those of the
+ * steps it needs, into a hash, and check whether a binary cache is newer
+ * than all of them.
+ */
+static bool init_step_sources(const struct init_step *step, const char *cache,
+							  u32b *hash)
+{
+	bool newer = TRUE;
+	size_t i;
+
+	for (i = 0; (i < N_ELEMENTS(step->needs)) && step->needs[i]; i++)
+		if (!init_step_sources(init_step_find(step->needs[i]), cache, hash))
+			newer = FALSE;
+
+	*hash = info_cache_hash(step->parser->name, *hash);
+	return info_cache_newer(cache, step->parser->name) && newer;
+}
+
+/**
+ * Load a step's data, from its binary cache if that is up to date with the
+ * templates it comes from, or else by parsing it and saving a new cache.
+ */
+static errr init_step_run(const struct init_step *step)
+{
+	char path[1024];
+	u32b hash = 2166136261UL;
+	errr r;
+
+	if (!step->cache)
+		return run_parser(step->parser);
+
+	path_build(path, sizeof(path), ANGBAND_DIR_USER,
+			   format("%s.raw", step->parser->name));
+
+	/* Use the cache if no template has been touched since it was made */
+	if (init_step_sources(step, path, &hash)
+		&& info_cache_load(step->cache, path, hash))
+		return 0;
+
+	r = run_parser(step->parser);
+	if (!r)
+		info_cache_save(step->cache, path, hash);
+
+	return r;
+}
+
+/**
+ * Load all the template files.  Each step is run once the steps it needs
+ * are done, taking them in the order of init_steps[] where there is a
+ * choice, so the data always loads the same way.
+ */
+static void init_arrays(void)
+{
+	size_t i, j;
+	size_t left = N_ELEMENTS(init_steps);
+
+	for (i = 0; i < N_ELEMENTS(init_steps); i++)
+		init_steps[i].done = FALSE;
+
+	while (left) {
+		bool progress = FALSE;
+
+		for (i = 0; i < N_ELEMENTS(init_steps); i++) {
+			struct init_step *step = &init_steps[i];
+			bool ready = !step->done;
+
+			for (j = 0; ready && (j < N_ELEMENTS(step->needs))
+					 && step->needs[j]; j++)
+				if (!init_step_find(step->needs[j])->done)
+					ready = FALSE;
+
+			if (!ready)
+				continue;
+
+			event_signal_string(EVENT_INITSTATUS, step->status);
+			if (init_step_run(step))
+				quit(step->fail);
+			if (step->after)
+				step->after();
+
+			step->done = TRUE;
+			progress = TRUE;
+			left--;
+		}
+
+		if (!progress)
+			quit("Template files depend on each other in a loop");
+	}
+}
+
 /*
  * Hack -- main Angband initialization entry point
  *
@@ -5012,137 +5552,8 @@ bool init_angband(void)
 
 	/*** Initialize some arrays ***/
 
-	/* Initialize size info */
-	event_signal_string(EVENT_INITSTATUS, "Initializing array sizes...");
-	if (run_parser(&z_parser))
-		quit("Cannot initialize sizes");
-
-	/* Initialize trap info */
-	event_signal_string(EVENT_INITSTATUS,
-						"Initializing arrays... (traps)");
-	if (run_parser(&trap_parser))
-		quit("Cannot initialize traps");
-
-	/* Initialize feature info */
-	event_signal_string(EVENT_INITSTATUS,
-						"Initializing arrays... (features)");
-	if (run_parser(&f_parser))
-		quit("Cannot initialize features");
-
-	/* Initialize object info */
-	event_signal_string(EVENT_INITSTATUS,
-						"Initializing arrays... (objects)");
-	if (run_parser(&k_parser))
-		quit("Cannot initialize objects");
-
-	/* Initialize ego-item info */
-	event_signal_string(EVENT_INITSTATUS,
-						"Initializing arrays... (ego-items)");
-	if (run_parser(&e_parser))
-		quit("Cannot initialize ego-items");
-
-	/* Initialize monster pain messages */
-	event_signal_string(EVENT_INITSTATUS,
-						"Initializing arrays... (pain messages)");
-	if (run_parser(&mp_parser))
-		quit("Cannot initialize monster pain messages");
-
-	/* Initialize monster-base info */
-	event_signal_string(EVENT_INITSTATUS,
-						"Initializing arrays... (monster bases)");
-	if (run_parser(&rb_parser))
-		quit("Cannot initialize monster bases");
-
-	/* Initialize monster info */
-	event_signal_string(EVENT_INITSTATUS,
-						"Initializing arrays... (monsters)");
-	if (run_parser(&r_parser))
-		quit("Cannot initialize monsters");
-
-	/* Initialize artifact info */
-	event_signal_string(EVENT_INITSTATUS,
-						"Initializing arrays... (artifacts)");
-	if (run_parser(&a_parser))
-		quit("Cannot initialize artifacts");
-
-	/* Initialize set item info */
-	event_signal_string(EVENT_INITSTATUS,
-						"Initializing arrays... (set items)");
-	if (run_parser(&set_parser))
-		quit("Cannot initialize set items");
-	update_artifact_sets();
-
-	/* Initialize vault info */
-	event_signal_string(EVENT_INITSTATUS,
-						"Initializing arrays... (vaults)");
-	if (run_parser(&v_parser))
-		quit("Cannot initialize vaults");
-
-	/* Initialize themed level info */
-	event_signal_string(EVENT_INITSTATUS,
-						"Initializing arrays... (themed)");
-	if (run_parser(&t_parser))
-		quit("Cannot initialize themed levels");
-
-	/* Initialize history info */
-	event_signal_string(EVENT_INITSTATUS,
-						"Initializing arrays... (histories)");
-	if (run_parser(&h_parser))
-		quit("Cannot initialize histories");
-
-	/* Initialize store info */
-	event_signal_string(EVENT_INITSTATUS,
-						"Initializing arrays... (stores)");
-	if (run_parser(&b_parser))
-		quit("Cannot initialize stores");
-
-	/* Initialize race info */
-	event_signal_string(EVENT_INITSTATUS,
-						"Initializing arrays... (races)");
-	if (run_parser(&p_parser))
-		quit("Cannot initialize races");
-
-	/* Initialize class info */
-	event_signal_string(EVENT_INITSTATUS,
-						"Initializing arrays... (classes)");
-	if (run_parser(&c_parser))
-		quit("Cannot initialize classes");
-		
-	/* Initialize cutie mark info */
-	event_signal_string(EVENT_INITSTATUS,
-                        "Initializing arrays... (cutie marks)");
-    if (run_parser(&mark_parser))
-        quit("Cannot initialize cutie marks");
-        
-    /* Initialize innate abilities */
-    event_signal_string(EVENT_INITSTATUS,
-                        "Initializing arrays... (innate abilities)");
-    if(run_parser(&ability_parser))
-        quit("Cannot initialize innate abilities");
-
-	/* Initialize flavor info */
-	event_signal_string(EVENT_INITSTATUS,
-						"Initializing arrays... (flavors)");
-	if (run_parser(&flavor_parser))
-		quit("Cannot initialize flavors");
-
-	/* Initialize spell info */
-	event_signal_string(EVENT_INITSTATUS,
-						"Initializing arrays... (spells)");
-	if (run_parser(&s_parser))
-		quit("Cannot initialize spells");
-
-	/* Initialize hint text */
-	event_signal_string(EVENT_INITSTATUS,
-						"Initializing arrays... (hints)");
-	if (run_parser(&hints_parser))
-		quit("Cannot initialize hints");
-
-	/* Initialise random name data */
-	event_signal_string(EVENT_INITSTATUS,
-						"Initializing arrays... (random names)");
-	if (run_parser(&names_parser))
-		quit("Can't parse names");
+	/* Initialize the arrays from the template files */
+	init_arrays();
 
 	/* Initialize some other arrays */
 	event_signal_string(EVENT_INITSTATUS,
@@ -5214,10 +5625,17 @@ void cleanup_angband(void)
 	FREE(artifact_normal);
 	FREE(artifact_special);
 
+	/* Free the indexes of flag and value names */
+	cleanup_name_indexes();
+
 	/* Free the allocation tables */
 	FREE(alloc_kind_table);
+	FREE(alloc_kind_cum);
 	FREE(alloc_ego_table);
+	FREE(alloc_ego_cum);
 	FREE(alloc_race_table);
+	FREE(alloc_race_cut);
+	FREE(alloc_race_alias);
 
 	event_remove_all_handlers();
 
@@ -5251,16 +5669,29 @@ void cleanup_angband(void)
 	FREE(l_list);
 	FREE(trap_list);
 	FREE(m_list);
+	FREE(m_free);
+	FREE(m_gen);
+	FREE(temp_m_idx);
+	FREE(mon_bucket);
+	FREE(mon_bucket_count);
+	FREE(mon_bucket_next);
+	FREE(mon_bucket_mark);
 	FREE(o_list);
+	FREE(o_free);
+	FREE(o_gen);
 
 	/* Flow arrays */
 	FREE(cave_when);
-	FREE(cave_cost);
+	FREE(cave_flow);
+
+	/* Free the field of view tables */
+	view_free();
 
 	/* Free the cave */
 	FREE(cave_o_idx);
 	FREE(cave_m_idx);
 	FREE(cave_feat);
+	FREE(cave_tf);
 	FREE(cave_info);
 
 	/* Free the temp array */
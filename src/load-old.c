@@ -513,6 +513,9 @@ static errr rd_savefile_new_aux(void)
 	/* Read the lore */
 	rd_lore(j);
     }
+
+    /* The uniques available have changed */
+    get_mon_num_forget();
   
     /* Object Memory */
     rd_u16b(&tmp16u);
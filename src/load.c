@@ -748,6 +748,9 @@ int rd_monster_memory(void)
 		rsf_inter(l_ptr->spell_flags, r_ptr->spell_flags);
 	}
 
+	/* The uniques available have changed */
+	get_mon_num_forget();
+
 	/* Success */
 	return (0);
 }
@@ -2019,7 +2022,7 @@ int rd_dungeon(void)
 			/* Apply the RLE info */
 			for (i = count; i > 0; i--) {
 				/* Extract "info" */
-				cave_info[y][x][n] = tmp8u;
+				square_set_byte(y, x, n, tmp8u);
 
 				/* Advance/Wrap */
 				if (++x >= DUNGEON_WID) {
@@ -2096,6 +2099,9 @@ int rd_dungeon(void)
 
 	/*** Success ***/
 
+	/* Start the view afresh */
+	view_invalidate();
+
 	/* The dungeon is ready */
 	character_dungeon = TRUE;
 
@@ -251,6 +251,9 @@ static void kill_all_monsters(int level)
 		if (rf_has(r_ptr->flags, RF_UNIQUE))
 			r_ptr->max_num = 0;
 	}
+
+	/* The uniques available have changed */
+	get_mon_num_forget();
 }
 
 static void unkill_uniques(void)
@@ -268,6 +271,9 @@ static void unkill_uniques(void)
 		if (rf_has(r_ptr->flags, RF_UNIQUE))
 			r_ptr->max_num = 1;
 	}
+
+	/* The uniques available have changed */
+	get_mon_num_forget();
 }
 
 static void reset_artifacts(void)
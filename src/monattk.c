@@ -312,8 +312,10 @@ static void make_request(int m_idx)
 	msg("%s runs off.", m_name);
 
 	/* If the monster is a unique, it will never come back. */
-	if (rf_has(r_ptr->flags, RF_UNIQUE))
+	if (rf_has(r_ptr->flags, RF_UNIQUE)) {
 		r_ptr->max_num = 0;
+		get_mon_num_forget();
+	}
 
 	/* Delete the monster. */
 	delete_monster_idx(m_idx);
@@ -403,7 +405,7 @@ bool make_attack_normal(monster_type * m_ptr, int y, int x)
 	/* 
 	 * Hack -- darkness protects those who serve it.
 	 */
-	if (!sqinfo_has(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW)
+	if (!square_has(p_ptr->py, p_ptr->px, SQUARE_GLOW)
 		&& (p_ptr->cur_light <= 0) && (!is_daylight)
 		&& player_has(PF_UNLIGHT))
 		terrain_bonus += ac / 8 + 10;
@@ -905,7 +907,7 @@ bool make_attack_normal(monster_type * m_ptr, int y, int x)
 									m_ptr->hp = m_ptr->maxhp;
 
 								/* Redraw (later) if needed */
-								if (p_ptr->health_who == m_idx)
+								if (health_tracked() == m_idx)
 									p_ptr->redraw |=
 										(PR_HEALTH | PR_MON_MANA);
 
@@ -2012,7 +2014,7 @@ bool make_attack_ranged(monster_type * m_ptr, int attack)
 	m_ptr->mana -= manacost;
 
 	/* Redraw (later) if needed */
-	if (p_ptr->health_who == m_idx)
+	if (health_tracked() == m_idx)
 		p_ptr->redraw |= (PR_MON_MANA);
 
 	/*** Get some info. ***/
@@ -3529,7 +3531,7 @@ bool make_attack_ranged(monster_type * m_ptr, int attack)
 			}
 
 			/* Redraw (later) if needed */
-			if (p_ptr->health_who == m_idx)
+			if (health_tracked() == m_idx)
 				p_ptr->redraw |= (PR_HEALTH);
 
 			/* Cancel fear */
@@ -3596,7 +3598,7 @@ bool make_attack_ranged(monster_type * m_ptr, int attack)
 			}
 
 			/* Redraw (later) if needed */
-			if (p_ptr->health_who == m_idx)
+			if (health_tracked() == m_idx)
 				p_ptr->redraw |= (PR_HEALTH);
 
 			break;
@@ -3780,7 +3782,7 @@ bool make_attack_ranged(monster_type * m_ptr, int attack)
 					}
 
 					/* Redraw (later) if needed */
-					if (p_ptr->health_who == m_idx)
+					if (health_tracked() == m_idx)
 						p_ptr->redraw |= (PR_MON_MANA);
 				}
 
@@ -3792,7 +3794,7 @@ bool make_attack_ranged(monster_type * m_ptr, int attack)
 						m_ptr->hp = m_ptr->maxhp;
 
 					/* Redraw (later) if needed */
-					if (p_ptr->health_who == m_idx)
+					if (health_tracked() == m_idx)
 						p_ptr->redraw |= (PR_HEALTH);
 
 					/* Special message */
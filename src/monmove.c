@@ -46,6 +46,64 @@
  */
 #define TURN_RANGE      3
 
+/**
+ * Largest radius of blast with a precomputed footprint
+ */
+#define AOE_TEMPLATE_RAD	4
+
+/**
+ * Kinds of area attack, for remembering what each would hit
+ */
+enum {
+	AOE_BREATH = 0,
+	AOE_BALL,
+	AOE_BEAM,
+	AOE_MAX
+};
+
+/**
+ * An area attack not yet tested; no attack can hit this many grids
+ */
+#define AOE_UNKNOWN	-1000
+
+/**
+ * Footprint of a blast: the offsets of the grids around the center,
+ * nearest first, and the number within each radius
+ */
+static s16b aoe_template_dy[(2 * AOE_TEMPLATE_RAD + 1) * (2 * AOE_TEMPLATE_RAD + 1)];
+static s16b aoe_template_dx[(2 * AOE_TEMPLATE_RAD + 1) * (2 * AOE_TEMPLATE_RAD + 1)];
+static byte aoe_template_d[(2 * AOE_TEMPLATE_RAD + 1) * (2 * AOE_TEMPLATE_RAD + 1)];
+static int aoe_template_n[AOE_TEMPLATE_RAD + 1];
+
+/**
+ * Build the blast footprint, the first time it is needed
+ */
+static void aoe_template_init(void)
+{
+	int d, y, x;
+	int n = 0;
+
+	/* Already built */
+	if (aoe_template_n[AOE_TEMPLATE_RAD])
+		return;
+
+	for (d = 1; d <= AOE_TEMPLATE_RAD; d++) {
+		for (y = -AOE_TEMPLATE_RAD; y <= AOE_TEMPLATE_RAD; y++) {
+			for (x = -AOE_TEMPLATE_RAD; x <= AOE_TEMPLATE_RAD; x++) {
+				if (distance(0, 0, y, x) != d)
+					continue;
+
+				aoe_template_dy[n] = y;
+				aoe_template_dx[n] = x;
+				aoe_template_d[n] = d;
+				n++;
+			}
+		}
+
+		aoe_template_n[d] = n;
+	}
+}
+
 /* Helper funtion for AoE tests */
 static int test_project(int who, int rad, int y, int x, int flg,
                     int degrees_of_arc, byte diameter_of_source)
@@ -95,6 +153,11 @@ static int test_project(int who, int rad, int y, int x, int flg,
 		grids++;
 	}
 	
+	/* An arc with no radius affects no grids */
+	else if ((flg & (PROJECT_ARC)) && (rad <= 0)) {
+		return (0);
+	}
+
 	/* Otherwise, travel along the projection path. */
 	else {
 		/* Calculate the projection path */
@@ -109,11 +172,10 @@ static int test_project(int who, int rad, int y, int x, int flg,
 			for (i = 0; i < path_n; ++i) {
 				int ny = GRID_Y(path_g[i]);
 				int nx = GRID_X(path_g[i]);
-				feature_type *f_ptr = &f_info[cave_feat[ny][nx]];
 
 
 				/* Hack -- Balls explode before reaching walls. */
-				if (!tf_has(f_ptr->flags, TF_PASSABLE) && (rad > 0))
+				if (!cave_passable(ny, nx) && (rad > 0))
 					break;
 
 				/* Advance */
@@ -184,66 +246,62 @@ static int test_project(int who, int rad, int y, int x, int flg,
 			grids++;
 		}
 
-		/* 
-		 * Scan every grid that might possibly 
-		 * be in the blast radius. 
-		 */
-		for (y = y0 - rad; y <= y0 + rad; y++) {
-			for (x = x0 - rad; x <= x0 + rad; x++) {
-				/* Center grid has already been stored. */
-				if ((y == y0) && (x == x0))
-					continue;
+		/* Small explosions accept the grids of their footprint in LOS */
+		if (!(flg & (PROJECT_ARC)) && (rad <= AOE_TEMPLATE_RAD)) {
+			aoe_template_init();
 
-				/* Precaution: Stay within area limit. */
-				if (grids >= 255)
-					break;
+			for (i = 0; i < aoe_template_n[rad]; i++) {
+				y = y0 + aoe_template_dy[i];
+				x = x0 + aoe_template_dx[i];
 
 				/* Ignore "illegal" locations */
 				if (!in_bounds(y, x))
 					continue;
-				
+
 				/* Most explosions are immediately stopped by walls. */
 				if (!cave_project(y, x))
 					continue;
-				
-				/* Must be within maximum distance. */
-				dist = (distance(y0, x0, y, x));
-				if (dist > rad)
-					continue;
-
 
-				/* If not an arc, accept all grids in LOS. */
-				if (!(flg & (PROJECT_ARC))) {
-					if (los(y0, x0, y, x)) {
-						gy[grids] = y;
-						gx[grids] = x;
-						gd[grids] = dist;
-						grids++;
-					}
+				if (los(y0, x0, y, x)) {
+					gy[grids] = y;
+					gx[grids] = x;
+					gd[grids] = aoe_template_d[i];
+					grids++;
 				}
+			}
+		}
 
-				/* Use angle comparison to delineate an arc. */
-				else {
-					int n2y, n2x, tmp, rotate, diff;
+		else {
+			/* 
+			 * Scan every grid that might possibly 
+			 * be in the blast radius. 
+			 */
+			for (y = y0 - rad; y <= y0 + rad; y++) {
+				for (x = x0 - rad; x <= x0 + rad; x++) {
+					/* Center grid has already been stored. */
+					if ((y == y0) && (x == x0))
+						continue;
 
-					/* Reorient current grid for table access. */
-					n2y = y - y1 + 20;
-					n2x = x - x1 + 20;
+					/* Precaution: Stay within area limit. */
+					if (grids >= 255)
+						break;
 
-					/* 
-					 * Find the angular difference (/2) between 
-					 * the lines to the end of the arc's center-
-					 * line and to the current grid.
-					 */
-					rotate = 90 - get_angle_to_grid[n1y][n1x];
-					tmp = ABS(get_angle_to_grid[n2y][n2x] + rotate) % 180;
-					diff = ABS(90 - tmp);
+					/* Ignore "illegal" locations */
+					if (!in_bounds(y, x))
+						continue;
+				
+					/* Most explosions are immediately stopped by walls. */
+					if (!cave_project(y, x))
+						continue;
+				
+					/* Must be within maximum distance. */
+					dist = (distance(y0, x0, y, x));
+					if (dist > rad)
+						continue;
 
-					/* 
-					 * If difference is not greater then that 
-					 * allowed, and the grid is in LOS, accept it.
-					 */
-					if (diff < (degrees_of_arc + 6) / 4) {
+
+					/* If not an arc, accept all grids in LOS. */
+					if (!(flg & (PROJECT_ARC))) {
 						if (los(y0, x0, y, x)) {
 							gy[grids] = y;
 							gx[grids] = x;
@@ -251,6 +309,37 @@ static int test_project(int who, int rad, int y, int x, int flg,
 							grids++;
 						}
 					}
+
+					/* Use angle comparison to delineate an arc. */
+					else {
+						int n2y, n2x, tmp, rotate, diff;
+
+						/* Reorient current grid for table access. */
+						n2y = y - y1 + 20;
+						n2x = x - x1 + 20;
+
+						/* 
+						 * Find the angular difference (/2) between 
+						 * the lines to the end of the arc's center-
+						 * line and to the current grid.
+						 */
+						rotate = 90 - get_angle_to_grid[n1y][n1x];
+						tmp = ABS(get_angle_to_grid[n2y][n2x] + rotate) % 180;
+						diff = ABS(90 - tmp);
+
+						/* 
+						 * If difference is not greater then that 
+						 * allowed, and the grid is in LOS, accept it.
+						 */
+						if (diff < (degrees_of_arc + 6) / 4) {
+							if (los(y0, x0, y, x)) {
+								gy[grids] = y;
+								gx[grids] = x;
+								gd[grids] = dist;
+								grids++;
+							}
+						}
+					}
 				}
 			}
 		}
@@ -282,12 +371,18 @@ static int test_project(int who, int rad, int y, int x, int flg,
 static int test_breath(int m_idx)
 {
     monster_type *m_ptr = &m_list[m_idx];
-	int ty = m_list[m_ptr->hostile].fy;
-	int tx = m_list[m_ptr->hostile].fx;
+	int ty = p_ptr->py;
+	int tx = p_ptr->px;
 	
 	int flg =
 		PROJECT_GRID | PROJECT_ITEM | PROJECT_KILL | PROJECT_ARC |
 		PROJECT_PLAY;
+
+	/* If the target is a monster, use those co-ords */
+	if (m_ptr->hostile > 0) {
+		ty = m_list[m_ptr->hostile].fy;
+		tx = m_list[m_ptr->hostile].fx;
+	}
 	
 	/* Estimate using the default diameter and a normal breath attack */
 	return test_project(m_idx, 0, ty, tx, flg, 20, 60);
@@ -297,10 +392,16 @@ static int test_breath(int m_idx)
 static int test_ball(int m_idx, int rad)
 {
     monster_type *m_ptr = &m_list[m_idx];
-	int ty = m_list[m_ptr->hostile].fy;
-	int tx = m_list[m_ptr->hostile].fx;
+	int ty = p_ptr->py;
+	int tx = p_ptr->px;
 	
 	int flg = PROJECT_GRID | PROJECT_ITEM | PROJECT_KILL | PROJECT_PLAY;
+
+	/* If the target is a monster, use those co-ords */
+	if (m_ptr->hostile > 0) {
+		ty = m_list[m_ptr->hostile].fy;
+		tx = m_list[m_ptr->hostile].fx;
+	}
 	
 	return test_project(m_idx, rad, ty, tx, flg, 0, 0);
 }
@@ -309,16 +410,29 @@ static int test_ball(int m_idx, int rad)
 static int test_beam(int m_idx)
 {
     monster_type *m_ptr = &m_list[m_idx];
-	int ty = m_list[m_ptr->hostile].fy;
-	int tx = m_list[m_ptr->hostile].fx;
+	int ty = p_ptr->py;
+	int tx = p_ptr->px;
 	
 	int flg = PROJECT_GRID | PROJECT_ITEM | PROJECT_KILL | PROJECT_PLAY | PROJECT_BEAM;
+
+	/* If the target is a monster, use those co-ords */
+	if (m_ptr->hostile > 0) {
+		ty = m_list[m_ptr->hostile].fy;
+		tx = m_list[m_ptr->hostile].fx;
+	}
 	
 	return test_project(m_idx, 0, ty, tx, flg, 0, 0);
 }
 
-/* Checks the number of hostile in the area of a spell, minus the number of non-hostiles */
-static int check_aoe(int attack, int m_idx)
+/**
+ * Checks the number of hostile in the area of a spell, minus the number of
+ * non-hostiles.
+ *
+ * All breaths test alike, as do all of a monster's balls and all beams, so
+ * "known" holds the answer for each kind of attack once it has been found
+ * while the monster chooses its spell.
+ */
+static int check_aoe(int attack, int m_idx, int *known)
 {	
 	int rad = 1;
 	monster_type *m_ptr = &m_list[m_idx];
@@ -353,7 +467,9 @@ static int check_aoe(int attack, int m_idx)
 	case RSF_BRTH_ALL:
 	case RSF_ARC_HFIRE:
 	case RSF_ARC_FORCE:
-	    return test_breath(m_idx);
+	    if (known[AOE_BREATH] == AOE_UNKNOWN)
+	        known[AOE_BREATH] = test_breath(m_idx);
+	    return known[AOE_BREATH];
 	/* Test Spellpower sized balls.  This varies based on element, so this is an estimate */
 	case RSF_BALL_ACID:
 	case RSF_BALL_ELEC:
@@ -378,12 +494,16 @@ static int check_aoe(int attack, int m_idx)
 		} else {
 		    rad = 4;
 		}
-		return test_ball(m_idx, rad);
+		if (known[AOE_BALL] == AOE_UNKNOWN)
+		    known[AOE_BALL] = test_ball(m_idx, rad);
+		return known[AOE_BALL];
 	/* Test Beams */
 	case RSF_BEAM_ELEC:
 	case RSF_BEAM_ICE:
 	case RSF_BEAM_NETHR:
-	    return test_beam(m_idx);
+	    if (known[AOE_BEAM] == AOE_UNKNOWN)
+	        known[AOE_BEAM] = test_beam(m_idx);
+	    return known[AOE_BEAM];
 	}
 	
 	/* Everything else */
@@ -591,28 +711,62 @@ static byte side_dirs[20][8] = {
  */
 int get_scent(int y, int x)
 {
-	int age;
-	int scent;
+	u32b age;
 
 	/* Check Bounds */
 	if (!(in_bounds(y, x)))
 		return (-1);
 
-	/* Sent trace? */
-	scent = cave_when[y][x];
-
 	/* No scent at all */
-	if (!scent)
+	if (!cave_when[y][x])
 		return (-1);
 
 	/* Get age of scent */
-	age = scent - scent_when;
+	age = scent_turn - cave_when[y][x];
+
+	/* Scent has faded away */
+	if (age > SCENT_MAX_AGE)
+		return (-1);
 
 	/* Return the age of the scent */
 	return (age);
 }
 
 
+/**
+ * Which terrain stops the monster following the noise flow, as a mask of
+ * FLOW_AVOID_* bits.  This follows the rules of "cave_passable_mon()",
+ * using only the race (so a strong flyer is assumed able to cross lava).
+ */
+int monster_flow_avoid(const monster_type * m_ptr)
+{
+	monster_race *r_ptr = &r_info[m_ptr->r_idx];
+	int avoid = 0;
+
+	/* Flyers cross water and lava */
+	if (rf_has(r_ptr->flags, RF_FLYING))
+		return 0;
+
+	/* Only fiery creatures will cross lava */
+	if (!rf_has(r_ptr->flags, RF_IM_FIRE))
+		avoid |= FLOW_AVOID_FIRE;
+
+	/* Earthbound demons, firebreathers and "red" elementals avoid water */
+	if (rsf_has(r_ptr->spell_flags, RSF_BRTH_FIRE) ||
+		strchr("uU", r_ptr->d_char) ||
+		(strchr("E", r_ptr->d_char) && ((r_ptr->d_attr == TERM_RED) ||
+										 (r_ptr->d_attr == TERM_L_RED))))
+		avoid |= FLOW_AVOID_WATER;
+
+	/* Some monsters can do nothing about a closed door */
+	if (!rf_has(r_ptr->flags, RF_OPEN_DOOR) &&
+		!rf_has(r_ptr->flags, RF_BASH_DOOR))
+		avoid |= FLOW_AVOID_DOORS;
+
+	return avoid;
+}
+
+
 /**
  * Can the monster catch a whiff of the character?
  *
@@ -1386,6 +1540,8 @@ int choose_ranged_attack(int m_idx, bool archery_only, int shape_rate)
 	int best_spell = 0, best_spell_rating = 0;
 	int cur_spell_rating;
 
+	int aoe_known[AOE_MAX] = { AOE_UNKNOWN, AOE_UNKNOWN, AOE_UNKNOWN };
+
 	/* Extract the racial spell flags f4 = r_ptr->flags4; f5 = r_ptr->flags5;
 	 * f6 = r_ptr->flags6; f7 = r_ptr->flags7; */
 	rsf_copy(mon_spells, r_ptr->spell_flags);
@@ -1554,7 +1710,7 @@ int choose_ranged_attack(int m_idx, bool archery_only, int shape_rate)
 				(cur_spell_rating * breath_hp) / breath_maxhp;
 
 		/* Bonus if it will hit several enemies or penality if it hits allies */
-		cur_spell_rating += 5 * check_aoe(i, m_idx);
+		cur_spell_rating += 5 * check_aoe(i, m_idx, aoe_known);
         
         /* Bonus if want summon and this spell is helpful */
 		if (spell_desire[i][D_SUMM] && want_summon)
@@ -2116,6 +2272,10 @@ static void get_move_advance(monster_type * m_ptr, int *ty, int *tx)
 
 	monster_race *r_ptr = &r_info[m_ptr->r_idx];
 
+	/* The flow layer this monster can follow */
+	byte (*flow)[DUNGEON_WID] =
+		cave_flow[flow_layer_index(monster_flow_avoid(m_ptr))];
+
 	/* Monster can go through rocks - head straight for target */
 	if ((rf_has(r_ptr->flags, RF_PASS_WALL))
 		|| (rf_has(r_ptr->flags, RF_KILL_WALL))) {
@@ -2144,7 +2304,7 @@ static void get_move_advance(monster_type * m_ptr, int *ty, int *tx)
 	}
 
 	/* If we can hear noises, advance towards them */
-	if (cave_cost[y1][x1]) {
+	if (flow[y1][x1]) {
 		use_psound = TRUE;
 	}
 
@@ -2192,7 +2352,7 @@ static void get_move_advance(monster_type * m_ptr, int *ty, int *tx)
 
 		/* We're using sound */
 		else {
-			int cost = cave_cost[y][x];
+			int cost = flow[y][x];
 
 			/* Accept louder sounds */
 			if ((cost == 0) || (lowest_cost < cost))
@@ -2492,9 +2652,14 @@ static bool get_move_retreat(monster_type * m_ptr, int *ty, int *tx)
 	bool dummy;
 	
 	/* Target's location */
-	int hy = m_list[m_ptr->hostile].fy;
-	int hx = m_list[m_ptr->hostile].fx;
+	int hy = p_ptr->py;
+	int hx = p_ptr->px;
 
+	/* If the target is a monster, use those co-ords */
+	if (m_ptr->hostile > 0) {
+		hy = m_list[m_ptr->hostile].fy;
+		hx = m_list[m_ptr->hostile].fx;
+	}
 
 	/* If the monster is well away from danger, let it relax. */
 	if (m_ptr->cdis >= FLEE_RANGE) {
@@ -3034,8 +3199,6 @@ static bool get_move(monster_type * m_ptr, int *ty, int *tx, bool * fear,
 			 * calculated this turn, calculate it now.
 			 */
 			if (p_ptr->vulnerability == 0) {
-				feature_type *f_ptr;
-
 				/* Count passable grids next to target */
 				for (i = 0; i < 8; i++) {
 					y = targ_y + ddy_ddd[i];
@@ -3046,8 +3209,7 @@ static bool get_move(monster_type * m_ptr, int *ty, int *tx, bool * fear,
 						continue;
 
 					/* Count passable grids */
-					f_ptr = &f_info[cave_feat[y][x]];
-					if (tf_has(f_ptr->flags, TF_PASSABLE))
+					if (cave_passable(y, x))
 						p_ptr->vulnerability++;
 				}
 
@@ -3069,8 +3231,7 @@ static bool get_move(monster_type * m_ptr, int *ty, int *tx, bool * fear,
 			/* Character is insufficiently vulnerable */
 			if (p_ptr->vulnerability <= 4) {
 				/* If we're in sight, find a hiding place */
-				if (sqinfo_has
-					(cave_info[m_ptr->fy][m_ptr->fx], SQUARE_SEEN)) {
+				if (square_has(m_ptr->fy, m_ptr->fx, SQUARE_SEEN)) {
 					/* Find a safe spot to lurk in */
 					if (get_move_retreat(m_ptr, ty, tx)) {
 						*fear = TRUE;
@@ -3400,7 +3561,7 @@ static void make_confused_move(monster_type * m_ptr, int y, int x)
 	f_ptr = &f_info[feat];
 
 	/* Check visibility */
-	if ((m_ptr->ml) && sqinfo_has(cave_info[y][x], SQUARE_SEEN))
+	if ((m_ptr->ml) && square_has(y, x, SQUARE_SEEN))
 		seen = TRUE;
 
 
@@ -3766,9 +3927,9 @@ static bool make_move(monster_type * m_ptr, int *ty, int *tx, bool fear,
 
 				/* Monster can't be seen, and is not in a "seen" grid. */
 				if ((!m_ptr->ml)
-					&& (!sqinfo_has(cave_info[oy][ox], SQUARE_SEEN))) {
+					&& (!square_has(oy, ox, SQUARE_SEEN))) {
 					/* Do not enter a "seen" grid */
-					if (sqinfo_has(cave_info[ny][nx], SQUARE_SEEN)) {
+					if (square_has(ny, nx, SQUARE_SEEN)) {
 						moves_data[i].move_chance = 0;
 						continue;
 					}
@@ -4326,16 +4487,23 @@ static void apply_monster_trap(monster_type * m_ptr, int y, int x,
 		}
 
 		else if (t_ptr->t_idx == MTRAP_GENOCIDE) {
-			int i;
+			int i, j, n;
 			char typ = r_ptr->d_char;
 
 			if (m_ptr->ml)
 				msg("%s vanishes!", m_name);
 
+			/* Find the monsters near the trap */
+			n = monster_near_list(y, x, 5, MON_ANY_FACTION, temp_m_idx);
+
 			/* Delete the monsters of that "type" */
-			for (i = 1; i < m_max; i++) {
-				monster_type *n_ptr = &m_list[i];
-				monster_race *r1_ptr = &r_info[n_ptr->r_idx];
+			for (j = 0; j < n; j++) {
+				monster_type *n_ptr;
+				monster_race *r1_ptr;
+
+				i = temp_m_idx[j];
+				n_ptr = &m_list[i];
+				r1_ptr = &r_info[n_ptr->r_idx];
 
 				/* Paranoia -- Skip dead monsters */
 				if (!n_ptr->r_idx)
@@ -4350,18 +4518,12 @@ static void apply_monster_trap(monster_type * m_ptr, int y, int x,
 					continue;
 
 				/* Ignore monsters in icky squares */
-				if (sqinfo_has
-					(cave_info[n_ptr->fy][n_ptr->fx], SQUARE_ICKY))
-					continue;
-
-				/* Ignore monsters too far away */
-				if (distance(n_ptr->fy, n_ptr->fx, y, x) > 5)
+				if (square_has(n_ptr->fy, n_ptr->fx, SQUARE_ICKY))
 					continue;
 
 				/* Delete the monster */
 				delete_monster_idx(i);
 			}
-
 		}
 
 		/* Other traps (sturdy, net, spirit) default to 75% of normal damage */
@@ -4524,12 +4686,12 @@ static void process_move(monster_type * m_ptr, int ty, int tx, bool bash)
 	/* Glyphs */
 	if (cave_trap_specific(ny, nx, RUNE_PROTECT)) {
 		/* Describe observable breakage */
-		if (sqinfo_has(cave_info[ny][nx], SQUARE_MARK)) {
+		if (square_has(ny, nx, SQUARE_MARK)) {
 			msg("The rune of protection is broken!");
 		}
 
 		/* Forget the rune */
-		sqinfo_off(cave_info[ny][nx], SQUARE_MARK);
+		square_off(ny, nx, SQUARE_MARK);
 
 		/* Break the rune */
 		remove_trap_kind(ny, nx, FALSE, RUNE_PROTECT);
@@ -4558,7 +4720,7 @@ static void process_move(monster_type * m_ptr, int ty, int tx, bool bash)
 			did_kill_wall = TRUE;
 
 			/* Forget the wall */
-			sqinfo_off(cave_info[ny][nx], SQUARE_MARK);
+			square_off(ny, nx, SQUARE_MARK);
 
 			/* Notice */
 			if (outside)
@@ -4567,7 +4729,7 @@ static void process_move(monster_type * m_ptr, int ty, int tx, bool bash)
 				cave_set_feat(ny, nx, FEAT_FLOOR);
 
 			/* Note changes to grid - but only if actually seen */
-			if (sqinfo_has(cave_info[ny][nx], SQUARE_SEEN))
+			if (square_has(ny, nx, SQUARE_SEEN))
 				do_view = TRUE;
 		}
 
@@ -4594,7 +4756,7 @@ static void process_move(monster_type * m_ptr, int ty, int tx, bool bash)
 					cave_set_feat(ny, nx, FEAT_OPEN);
 
 				/* Handle viewable doors */
-				if (sqinfo_has(cave_info[ny][nx], SQUARE_SEEN))
+				if (square_has(ny, nx, SQUARE_SEEN))
 					do_view = TRUE;
 
 				/* Disturb */
@@ -4720,7 +4882,7 @@ static void process_move(monster_type * m_ptr, int ty, int tx, bool bash)
 					did_kill_wall = TRUE;
 
 					/* Forget the wall */
-					sqinfo_off(cave_info[yy][xx], SQUARE_MARK);
+					square_off(yy, xx, SQUARE_MARK);
 
 					/* Notice */
 					if (outside)
@@ -4729,7 +4891,7 @@ static void process_move(monster_type * m_ptr, int ty, int tx, bool bash)
 						cave_set_feat(yy, xx, FEAT_FLOOR);
 
 					/* Note changes to grid - but only if actually seen */
-					if (sqinfo_has(cave_info[yy][xx], SQUARE_SEEN))
+					if (square_has(yy, xx, SQUARE_SEEN))
 						do_view = TRUE;
 				}
 
@@ -4799,7 +4961,7 @@ static void process_move(monster_type * m_ptr, int ty, int tx, bool bash)
 		if (cave_trap_specific(ny, nx, RUNE_EXPLOSIVE))
 		{
 		    explode(GF_FIRE, ny, nx, damroll(3, p_ptr->lev) + 3 * p_ptr->lev, 3);
-		    if (sqinfo_has(cave_info[ny][nx], SQUARE_MARK)) {
+		    if (square_has(ny, nx, SQUARE_MARK)) {
 		    	msg("The explosive rune detinates!");
 		    }
 
@@ -4808,7 +4970,7 @@ static void process_move(monster_type * m_ptr, int ty, int tx, bool bash)
 		    if(randint1(2) == 1)
 		    {
 		    	/* Forget the rune */
-		    	sqinfo_off(cave_info[ny][nx], SQUARE_MARK);
+		    	square_off(ny, nx, SQUARE_MARK);
 
 		    	/* Break the rune */
 		    	remove_trap_kind(ny, nx, FALSE, RUNE_EXPLOSIVE);
@@ -5084,7 +5246,7 @@ static void process_monster(monster_type * m_ptr)
 	int scan_range = (MODE(SMALL_DEVICE) ? r_ptr->aaf / 2 : r_ptr->aaf);
 	bool fear = FALSE;
 
-	bool bash;
+	bool bash = FALSE;
 
 	/* Assume the monster is able to perceive the player. */
 	bool aware = TRUE;
@@ -5111,7 +5273,7 @@ static void process_monster(monster_type * m_ptr)
 	/* Some target sanity checking */
 	if(m_ptr->hostile == cave_m_idx[m_ptr->fy][m_ptr->fx])
 	    m_ptr->hostile = 0;
-    if(!m_list[m_ptr->hostile].r_idx)
+    if((m_ptr->hostile > 0) && !m_list[m_ptr->hostile].r_idx)
         m_ptr->hostile = 0;
     
     /* Avoid fighting allies */
@@ -5135,7 +5297,8 @@ static void process_monster(monster_type * m_ptr)
         if(m_ptr->threat <= damroll(1, r_ptr->level))
             m_ptr->hostile = 0;
     }
-    if(m_ptr->group == m_list[m_ptr->hostile].group) {
+    if((m_ptr->hostile >= 0) &&
+       (m_ptr->group == m_list[m_ptr->hostile].group)) {
         m_ptr->threat -= m_ptr->threat / 4;
         if(m_ptr->threat <= damroll(1, r_ptr->level))
             m_ptr->hostile = 0;
@@ -5188,7 +5351,7 @@ static void process_monster(monster_type * m_ptr)
 		if ((m_ptr->cdis >= FLEE_RANGE) && (m_ptr->cdis > scan_range)
 			&& (!m_ptr->ty) && (!m_ptr->tx)) {
 			/* Monster cannot smell the character */
-			if (!cave_when[m_ptr->fy][m_ptr->fx])
+			if (get_scent(m_ptr->fy, m_ptr->fx) == -1)
 				m_ptr->mflag &= ~(MFLAG_ACTV);
 			else if (!monster_can_smell(m_ptr))
 				m_ptr->mflag &= ~(MFLAG_ACTV);
@@ -5206,7 +5369,7 @@ static void process_monster(monster_type * m_ptr)
 			m_ptr->mflag |= (MFLAG_ACTV);
 
 		/* The monster is catching too much of a whiff to ignore */
-		else if (cave_when[m_ptr->fy][m_ptr->fx]) {
+		else if (get_scent(m_ptr->fy, m_ptr->fx) != -1) {
 			if (monster_can_smell(m_ptr))
 				m_ptr->mflag |= (MFLAG_ACTV);
 		}
@@ -5219,7 +5382,7 @@ static void process_monster(monster_type * m_ptr)
 
 
 	/* Hack -- Always redraw the current target monster health bar */
-	if (p_ptr->health_who == cave_m_idx[m_ptr->fy][m_ptr->fx])
+	if (health_tracked() == cave_m_idx[m_ptr->fy][m_ptr->fx])
 		p_ptr->redraw |= (PR_HEALTH | PR_MON_MANA);
 
 
@@ -6000,7 +6163,7 @@ static void recover_monster(monster_type * m_ptr, bool regen)
 
 
 	/* Hack -- Update the health bar (always) */
-	if (p_ptr->health_who == cave_m_idx[m_ptr->fy][m_ptr->fx])
+	if (health_tracked() == cave_m_idx[m_ptr->fy][m_ptr->fx])
 		p_ptr->redraw |= (PR_HEALTH | PR_MON_MANA);
 }
 
@@ -64,15 +64,15 @@ enum
 
 #define RF_SIZE                FLAG_SIZE(RF_MAX)
 
-#define rf_has(f, flag)        flag_has_dbg(f, RF_SIZE, flag, #f, #flag)
+#define rf_has(f, flag)        flag_has_fast(f, RF_SIZE, flag)
 #define rf_next(f, flag)       flag_next(f, RF_SIZE, flag)
 #define rf_is_empty(f)         flag_is_empty(f, RF_SIZE)
 #define rf_is_full(f)          flag_is_full(f, RF_SIZE)
 #define rf_is_inter(f1, f2)    flag_is_inter(f1, f2, RF_SIZE)
 #define rf_is_subset(f1, f2)   flag_is_subset(f1, f2, RF_SIZE)
 #define rf_is_equal(f1, f2)    flag_is_equal(f1, f2, RF_SIZE)
-#define rf_on(f, flag)         flag_on_dbg(f, RF_SIZE, flag, #f, #flag)
-#define rf_off(f, flag)        flag_off(f, RF_SIZE, flag)
+#define rf_on(f, flag)         flag_on_fast(f, RF_SIZE, flag)
+#define rf_off(f, flag)        flag_off_fast(f, RF_SIZE, flag)
 #define rf_wipe(f)             flag_wipe(f, RF_SIZE)
 #define rf_setall(f)           flag_setall(f, RF_SIZE)
 #define rf_negate(f)           flag_negate(f, RF_SIZE)
@@ -108,15 +108,15 @@ enum
 
 #define RSF_SIZE               FLAG_SIZE(RSF_MAX)
 
-#define rsf_has(f, flag)       flag_has_dbg(f, RSF_SIZE, flag, #f, #flag)
+#define rsf_has(f, flag)       flag_has_fast(f, RSF_SIZE, flag)
 #define rsf_next(f, flag)      flag_next(f, RSF_SIZE, flag)
 #define rsf_is_empty(f)        flag_is_empty(f, RSF_SIZE)
 #define rsf_is_full(f)         flag_is_full(f, RSF_SIZE)
 #define rsf_is_inter(f1, f2)   flag_is_inter(f1, f2, RSF_SIZE)
 #define rsf_is_subset(f1, f2)  flag_is_subset(f1, f2, RSF_SIZE)
 #define rsf_is_equal(f1, f2)   flag_is_equal(f1, f2, RSF_SIZE)
-#define rsf_on(f, flag)        flag_on_dbg(f, RSF_SIZE, flag, #f, #flag)
-#define rsf_off(f, flag)       flag_off(f, RSF_SIZE, flag)
+#define rsf_on(f, flag)        flag_on_fast(f, RSF_SIZE, flag)
+#define rsf_off(f, flag)       flag_off_fast(f, RSF_SIZE, flag)
 #define rsf_wipe(f)            flag_wipe(f, RSF_SIZE)
 #define rsf_setall(f)          flag_setall(f, RSF_SIZE)
 #define rsf_negate(f)          flag_negate(f, RSF_SIZE)
@@ -286,6 +286,25 @@ enum faction_reaction {
 /*** Maximum range for threat gain ***/
 #define MAX_THREAT_RANGE 30
 
+/*** Monster bucket index ***/
+
+/*
+ * Monsters are filed by location in buckets of 8x8 grids, so the monsters
+ * in a region can be found without scanning the whole monster list
+ */
+#define MON_BUCKET_SHIFT 3
+#define MON_BUCKET_HGT ((DUNGEON_HGT >> MON_BUCKET_SHIFT) + 1)
+#define MON_BUCKET_WID ((DUNGEON_WID >> MON_BUCKET_SHIFT) + 1)
+
+/* Bucket queries with this faction list monsters of every faction */
+#define MON_ANY_FACTION -1
+
+/* Words of the bitmap that marks monsters already listed by a query */
+#define MON_MARK_WORDS ((z_info->m_max + 31) / 32)
+
+/* Cost of walking the index per monster, in monster list scan steps */
+#define MON_WALK_COST 3
+
 /*** Special damage sources for threat ***/
 #define SOURCE_ENVIRONMENTAL 0
 #define SOURCE_PLAYER -1
@@ -570,6 +589,9 @@ extern void delete_monster(int y, int x);
 extern void compact_monsters(int size);
 extern void wipe_m_list(void);
 extern s16b m_pop(void);
+extern u32b monster_handle(int m_idx);
+extern int monster_handle_idx(u32b handle);
+extern void get_mon_num_forget(void);
 extern errr get_mon_num_prep(void);
 extern s16b get_mon_num(int level);
 extern s16b get_mon_num_quick(int level);
@@ -582,6 +604,9 @@ extern void lore_treasure(int m_idx, int num_item, int num_gold);
 extern void update_mon(int m_idx, bool full);
 extern void update_monsters(bool full);
 extern s16b monster_carry(int m_idx, object_type *j_ptr);
+extern int monster_rect_list(int y1, int x1, int y2, int x2, int faction, s16b *who);
+extern int monster_near_list(int y, int x, int range, int faction, s16b *who);
+extern bool monster_near_scan(int y, int x, int range);
 extern void monster_swap(int y1, int x1, int y2, int x2);
 extern s16b player_place(int y, int x);
 extern s16b monster_place(int y, int x, monster_type *n_ptr);
@@ -602,6 +627,7 @@ extern bool make_attack_ranged(monster_type *m_ptr, int attack);
 
 /* monmove.c */
 extern int get_scent(int y, int x);
+extern int monster_flow_avoid(const monster_type *m_ptr);
 extern int choose_ranged_attack(int m_idx, bool archery_only, int shape_rate);
 extern bool cave_exist_mon(monster_race *r_ptr, int y, int x, 
                            bool occupied_ok);
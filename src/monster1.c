@@ -3019,37 +3019,25 @@ int get_reaction(int attacker, int defender)
 
 void cause_threat(int y, int x, int source, u16b faction, int amount, int target, bool onlySameFaction)
 {
-    int checkX = x - MAX_THREAT_RANGE - 1; /* First loop adds 1, so counteract this */
-	int checkY = y - MAX_THREAT_RANGE;
+    int i, n;
 	
 	/* If the source is environmental (0), don't bother at all */
 	/* Hack: Unless it's onlySameFaction, then it'a a player order */
 	if ((source == SOURCE_ENVIRONMENTAL) && !onlySameFaction)
 	    return;
 	
-	while(checkY <= DUNGEON_HGT) {
+	/* Find the monsters in range, only of our own faction if need be */
+	n = monster_near_list(y, x, MAX_THREAT_RANGE,
+						  onlySameFaction ? faction : MON_ANY_FACTION,
+						  temp_m_idx);
+	
+	for (i = 0; i < n; i++) {
 	    int currDist;
-		int mid;
+		int mid = temp_m_idx[i];
 		int threatIncrease = 0;
-		monster_type *m_ptr;
-		
-		/* Check the next square */
-		checkX++;
-		
-		/* Check if we've gone too far to the right and move to the next line */
-		if(checkX > x + MAX_THREAT_RANGE) {
-		    checkX = x - MAX_THREAT_RANGE;
-			checkY++;
-			if (checkY > y + MAX_THREAT_RANGE)
-			    break;
-		}
-		
-		/* Get the monster ID */
-		mid = cave_m_idx[checkY][checkX];
-		
-		/* Skip empty cells and the player */
-		if(mid <= 0)
-		    continue;
+		monster_type *m_ptr = &m_list[mid];
+		int checkY = m_ptr->fy;
+		int checkX = m_ptr->fx;
 		    
 		/* Skip the source */
 		if(mid == source)
@@ -3058,17 +3046,6 @@ void cause_threat(int y, int x, int source, u16b faction, int amount, int target
 		/* Get the distance from the threat's point of origin */
 		currDist = distance(checkY, checkX, y, x);
 		
-		/* If we're out of range, move on */
-		if(currDist > MAX_THREAT_RANGE)
-		    continue;
-		
-		/* Get the monster's information */
-		m_ptr = &m_list[mid];
-		
-		/* If only affecting our own faction, skip monsters in other factions */
-		if(onlySameFaction && (m_ptr->faction != faction))
-		    continue;
-		
 		/* If we aren't only affecting our faction, ignore friends and allies that aren't directly affected */
 		if((!get_reaction(m_ptr->faction, faction) == REACT_HOSTILE) && (mid != target) && !onlySameFaction)
 		    continue;
@@ -33,6 +33,207 @@
 #include "types.h"
 
 
+/**
+ * Return the number of the bucket of the monster index for grid (y, x)
+ */
+static int monster_bucket(int y, int x)
+{
+	return ((y >> MON_BUCKET_SHIFT) * MON_BUCKET_WID + (x >> MON_BUCKET_SHIFT));
+}
+
+/**
+ * File a monster in the bucket for its location
+ */
+static void monster_bucket_add(int m_idx)
+{
+	monster_type *m_ptr = &m_list[m_idx];
+	int b = monster_bucket(m_ptr->fy, m_ptr->fx);
+
+	mon_bucket_next[m_idx] = mon_bucket[b];
+	mon_bucket[b] = m_idx;
+	mon_bucket_count[b]++;
+}
+
+/**
+ * Take a monster out of the bucket for its location
+ */
+static void monster_bucket_remove(int m_idx)
+{
+	monster_type *m_ptr = &m_list[m_idx];
+	int b = monster_bucket(m_ptr->fy, m_ptr->fx);
+	s16b *link = &mon_bucket[b];
+
+	while (*link && (*link != m_idx))
+		link = &mon_bucket_next[*link];
+
+	/* Paranoia */
+	if (*link) {
+		*link = mon_bucket_next[m_idx];
+		mon_bucket_count[b]--;
+	}
+}
+
+/**
+ * Is the monster of the given faction and within distance range of (y, x),
+ * or if range is negative, in the rectangle from (y1, x1) to (y2, x2)?
+ *
+ * Every grid within distance range of (y, x) is in the rectangle, so the
+ * distance test alone will do when there is one.
+ */
+static bool monster_in_area(const monster_type *m_ptr, int y1, int x1,
+							int y2, int x2, int y, int x, int range,
+							int faction)
+{
+	if ((faction != MON_ANY_FACTION) && (m_ptr->faction != faction))
+		return (FALSE);
+
+	if (range >= 0)
+		return (distance(y, x, m_ptr->fy, m_ptr->fx) <= range);
+
+	return ((m_ptr->fy >= y1) && (m_ptr->fy <= y2) &&
+			(m_ptr->fx >= x1) && (m_ptr->fx <= x2));
+}
+
+/**
+ * Would a plain scan of the monster list find the monsters in the rectangle
+ * from (y1, x1) to (y2, x2) as quickly as walking the monster index?
+ *
+ * Walking the index costs a look at each bucket that overlaps the rectangle,
+ * and about MON_WALK_COST times as much per monster filed in those buckets
+ * as a scan costs per monster.
+ */
+static bool monster_rect_scan(int y1, int x1, int y2, int x2)
+{
+	int by, bx;
+	int by1 = MAX(y1, 0) >> MON_BUCKET_SHIFT;
+	int bx1 = MAX(x1, 0) >> MON_BUCKET_SHIFT;
+	int by2 = MIN(y2, DUNGEON_HGT - 1) >> MON_BUCKET_SHIFT;
+	int bx2 = MIN(x2, DUNGEON_WID - 1) >> MON_BUCKET_SHIFT;
+	int cost = (by2 - by1 + 1) * (bx2 - bx1 + 1);
+
+	if (cost >= m_max)
+		return (TRUE);
+
+	for (by = by1; by <= by2; by++) {
+		for (bx = bx1; bx <= bx2; bx++) {
+			cost += MON_WALK_COST * mon_bucket_count[by * MON_BUCKET_WID + bx];
+
+			if (cost >= m_max)
+				return (TRUE);
+		}
+	}
+
+	return (FALSE);
+}
+
+/**
+ * Would a plain scan of the monster list find the monsters within distance
+ * range of (y, x) as quickly as monster_near_list()?  Callers that go on to
+ * visit every monster found can then do the scan themselves, and save
+ * listing them first.
+ */
+bool monster_near_scan(int y, int x, int range)
+{
+	return (monster_rect_scan(y - range, x - range, y + range, x + range));
+}
+
+/**
+ * List the monsters for monster_rect_list() and monster_near_list()
+ */
+static int monster_area_list(int y1, int x1, int y2, int x2, int y, int x,
+							 int range, int faction, s16b *who)
+{
+	int by, bx, w;
+	int n = 0;
+
+	/* Stay on the map */
+	if (y1 < 0)
+		y1 = 0;
+	if (x1 < 0)
+		x1 = 0;
+	if (y2 > DUNGEON_HGT - 1)
+		y2 = DUNGEON_HGT - 1;
+	if (x2 > DUNGEON_WID - 1)
+		x2 = DUNGEON_WID - 1;
+
+	/* Scan the monster list if that is as quick */
+	if (monster_rect_scan(y1, x1, y2, x2)) {
+		int i;
+
+		for (i = 1; i < m_max; i++) {
+			monster_type *m_ptr = &m_list[i];
+
+			/* Skip dead monsters */
+			if (!m_ptr->r_idx)
+				continue;
+
+			if (monster_in_area(m_ptr, y1, x1, y2, x2, y, x, range, faction))
+				who[n++] = i;
+		}
+
+		return (n);
+	}
+
+	/* Otherwise mark the monsters in the buckets that overlap the rectangle */
+	for (by = y1 >> MON_BUCKET_SHIFT; by <= y2 >> MON_BUCKET_SHIFT; by++) {
+		for (bx = x1 >> MON_BUCKET_SHIFT; bx <= x2 >> MON_BUCKET_SHIFT;
+			 bx++) {
+			int i;
+
+			for (i = mon_bucket[by * MON_BUCKET_WID + bx]; i;
+				 i = mon_bucket_next[i]) {
+				/* Buckets on the edge overhang the area */
+				if (monster_in_area(&m_list[i], y1, x1, y2, x2, y, x, range,
+									faction))
+					mon_bucket_mark[i / 32] |= 1UL << (i % 32);
+			}
+		}
+	}
+
+	/* List the marked monsters in index order, clearing the marks */
+	for (w = 0; w <= (m_max - 1) / 32; w++) {
+		u32b word = mon_bucket_mark[w];
+		int i;
+
+		if (!word)
+			continue;
+
+		mon_bucket_mark[w] = 0;
+
+		for (i = w * 32; word; i++, word >>= 1)
+			if (word & 1)
+				who[n++] = i;
+	}
+
+	return (n);
+}
+
+/**
+ * List the monsters in the rectangle from (y1, x1) to (y2, x2) inclusive,
+ * in index order, so callers see them in the order a scan of the whole
+ * monster list would.  Only monsters of the given faction are listed,
+ * unless the faction is MON_ANY_FACTION.
+ *
+ * The list must have room for m_max monsters; temp_m_idx will do, unless
+ * something may make another query while the list is still in use.
+ * Return the number listed.
+ */
+int monster_rect_list(int y1, int x1, int y2, int x2, int faction, s16b *who)
+{
+	return (monster_area_list(y1, x1, y2, x2, 0, 0, -1, faction, who));
+}
+
+/**
+ * List the monsters within distance "range" of (y, x), as for
+ * monster_rect_list().  Return the number listed.
+ */
+int monster_near_list(int y, int x, int range, int faction, s16b *who)
+{
+	return (monster_area_list(y - range, x - range, y + range, x + range,
+							  y, x, range, faction, who));
+}
+
+
 /**
  * Delete a monster by index.
  *
@@ -59,6 +260,10 @@ void delete_monster_idx(int i)
 	/* Hack -- Reduce the racial counter */
 	r_ptr->cur_num--;
 
+	/* A unique may be available again */
+	if (rf_has(r_ptr->flags, RF_UNIQUE))
+		get_mon_num_forget();
+
 	/* Remove as pet */
 	if (m_ptr->pet_num >= 0)
 	{
@@ -75,7 +280,7 @@ void delete_monster_idx(int i)
 		target_set_monster(0);
 
 	/* Hack -- remove tracked monster */
-	if (p_ptr->health_who == i)
+	if (health_tracked() == i)
 		health_track(0);
 
 
@@ -114,6 +319,16 @@ void delete_monster_idx(int i)
 	}
 
 
+	/* Take it out of its bucket */
+	monster_bucket_remove(i);
+
+	/* Free the index (unless it already was) */
+	if (m_ptr->r_idx) {
+		m_gen[i]++;
+		if (m_free_num < z_info->m_max)
+			m_free[m_free_num++] = i;
+	}
+
 	/* Wipe the Monster */
 	(void) WIPE(m_ptr, monster_type);
 
@@ -188,14 +403,23 @@ static void compact_monsters_aux(int i1, int i2)
 		target_set_monster(&m_list[i2]);
 
 	/* Hack -- Update the health bar */
-	if (p_ptr->health_who == i1)
-		p_ptr->health_who = i2;
+	if (health_tracked() == i1)
+		health_track(i2);
+
+	/* Take it out of its bucket */
+	monster_bucket_remove(i1);
 
 	/* Hack -- move monster */
 	(void) COPY(&m_list[i2], &m_list[i1], monster_type);
 
+	/* File it under the new index */
+	monster_bucket_add(i2);
+
 	/* Hack -- wipe hole */
 	(void) WIPE(&m_list[i1], monster_type);
+
+	/* The monster has left its old index */
+	m_gen[i1]++;
 }
 
 
@@ -294,6 +518,9 @@ void compact_monsters(int size)
 		/* Compress "m_max" */
 		m_max--;
 	}
+
+	/* There are no holes left */
+	m_free_num = 0;
 }
 
 
@@ -338,17 +565,28 @@ void wipe_m_list(void)
 
 		/* Wipe the Monster */
 		(void) WIPE(m_ptr, monster_type);
+		m_gen[i]++;
 	}
 
 	/* Hack - wipe the player */
 	cave_m_idx[p_ptr->py][p_ptr->px] = 0;
 
+	/* Empty the buckets */
+	C_WIPE(mon_bucket, MON_BUCKET_HGT * MON_BUCKET_WID, s16b);
+	C_WIPE(mon_bucket_count, MON_BUCKET_HGT * MON_BUCKET_WID, s16b);
+
+	/* Uniques are all available again */
+	get_mon_num_forget();
+
 	/* Reset "m_max" */
 	m_max = 1;
 
 	/* Reset "m_cnt" */
 	m_cnt = 0;
 
+	/* No free indexes */
+	m_free_num = 0;
+
 	/* Hack -- reset "reproducer" count */
 	num_repro = 0;
 
@@ -371,6 +609,9 @@ void wipe_m_list(void)
 /**
  * Acquires and returns the index of a "free" monster.
  *
+ * Indexes freed by delete_monster_idx() are reused first, so that the
+ * monster list need not be compacted while the level is played.
+ *
  * This routine should almost never fail, but it *can* happen.
  */
 s16b m_pop(void)
@@ -378,6 +619,21 @@ s16b m_pop(void)
 	int i;
 
 
+	/* Reuse a freed index */
+	while (m_free_num) {
+		i = m_free[--m_free_num];
+
+		/* Skip indexes compacted away or already reused */
+		if ((i >= m_max) || m_list[i].r_idx)
+			continue;
+
+		/* Count monsters */
+		m_cnt++;
+
+		/* Use this monster */
+		return (i);
+	}
+
 	/* Normal allocation */
 	if (m_max < z_info->m_max) {
 		/* Access the next hole */
@@ -422,17 +678,68 @@ s16b m_pop(void)
 }
 
 
+/**
+ * Get a handle on a monster, which stays good while the monster keeps its
+ * index; it goes stale when the monster dies or is moved by compaction.
+ */
+u32b monster_handle(int m_idx)
+{
+	return (((u32b) m_gen[m_idx] << 16) | m_idx);
+}
+
+
+/**
+ * Get the index of the monster a handle refers to, or 0 if it has gone
+ */
+int monster_handle_idx(u32b handle)
+{
+	int m_idx = handle & 0xFFFF;
+
+	if (!m_idx || (m_idx >= m_max) || !m_list[m_idx].r_idx)
+		return (0);
+
+	if (m_gen[m_idx] != (handle >> 16))
+		return (0);
+
+	return (m_idx);
+}
+
+
+/**
+ * The generation level, boosted level, stage and map the monster alias
+ * table was built for; mon_num_level is -1 when there is no such table
+ */
+static int mon_num_level = -1;
+static int mon_num_temp_level;
+static int mon_num_stage;
+static int mon_num_depth;
+static int mon_num_map;
+
+
+/**
+ * Forget the monster alias table, because the final probabilities it was
+ * built from may no longer be right (for example, a unique has appeared,
+ * died, or the table has been used for something else)
+ */
+void get_mon_num_forget(void)
+{
+	mon_num_level = -1;
+}
+
+
 /**
  * Apply a "monster restriction function" to the "monster allocation table"
  */
 errr get_mon_num_prep(void)
 {
 	int i;
+	bool changed = FALSE;
 
 	/* Scan the allocation table */
 	for (i = 0; i < alloc_race_size; i++) {
 		/* Get the entry */
 		alloc_entry *entry = &alloc_race_table[i];
+		byte prob2 = entry->prob2;
 
 		/* Accept monsters which pass the restriction, if any */
 		if (!get_mon_num_hook || (*get_mon_num_hook) (entry->index)) {
@@ -445,13 +752,251 @@ errr get_mon_num_prep(void)
 			/* Decline this monster */
 			entry->prob2 = 0;
 		}
+
+		if (entry->prob2 != prob2)
+			changed = TRUE;
 	}
 
+	/* The alias table only survives if the restriction made no difference */
+	if (changed)
+		get_mon_num_forget();
+
 	/* Success */
 	return (0);
 }
 
 
+/**
+ * Build the alias table for the final monster probabilities in "prob3".
+ *
+ * Each entry gets a column of height alloc_race_total; entry i fills
+ * alloc_race_cut[i] of its own column, and the rest of the column is given
+ * to entry alloc_race_alias[i].  Picking a column and a height at random
+ * then gives every entry exactly its share of the total (Vose's method,
+ * in integers so that nothing is lost to rounding).
+ */
+static void get_mon_num_alias(void)
+{
+	alloc_entry *table = alloc_race_table;
+	u32b *cut = alloc_race_cut;
+	u32b total = alloc_race_total;
+	int n = alloc_race_size;
+	s16b *work;
+	int small = 0, large = n;
+	int i;
+
+	/* Columns under height go at the front, the rest at the back */
+	work = C_ZNEW(n, s16b);
+	for (i = 0; i < n; i++) {
+		cut[i] = table[i].prob3 * n;
+		alloc_race_alias[i] = i;
+
+		if (cut[i] < total)
+			work[small++] = i;
+		else
+			work[--large] = i;
+	}
+
+	/* Fill each short column from a tall one */
+	while (small && (large < n)) {
+		int s = work[--small];
+		int l = work[large++];
+
+		alloc_race_alias[s] = l;
+		cut[l] -= total - cut[s];
+
+		if (cut[l] < total)
+			work[small++] = l;
+		else
+			work[--large] = l;
+	}
+
+	/* The columns left over are exactly full */
+	while (small)
+		cut[work[--small]] = total;
+	while (large < n)
+		cut[work[large++]] = total;
+
+	FREE(work);
+}
+
+
+/**
+ * Draw an entry from the monster alias table
+ */
+static s16b get_mon_num_draw(void)
+{
+	int i = randint0(alloc_race_size);
+	u32b value = randint0(alloc_race_total);
+
+	if (value < alloc_race_cut[i])
+		return (alloc_race_table[i].index);
+
+	return (alloc_race_table[alloc_race_alias[i]].index);
+}
+
+
+/**
+ * Calculate the "prob3" field of the monster allocation table for the
+ * given level (which sets how rare low-level monsters are) and boosted
+ * level (the deepest monster allowed), and the alias table to draw from it.
+ */
+static void get_mon_num_calc(int level, int temp_level)
+{
+	int i;
+
+	int r_idx;
+
+	monster_race *r_ptr;
+
+	alloc_entry *table = alloc_race_table;
+
+	/* Low-level monsters avoid the deep dungeon. */
+	int depth_rare = 2 * level / 3;
+	int depth_very_rare = level / 3;
+
+
+	/* Reset sum of final monster probabilities. */
+	alloc_race_total = 0L;
+
+	/* Process probabilities */
+	for (i = 0; i < alloc_race_size; i++) {
+		/* Assume no probability */
+		table[i].prob3 = 0;
+
+		/* Ignore illegal monsters */
+		if (!table[i].prob2)
+			continue;
+
+		/* Monsters are sorted by depth */
+		if (table[i].level > temp_level)
+			continue;
+
+		/* Hack -- No town monsters in dungeon */
+		if ((p_ptr->depth != 0) && (table[i].level < 1))
+			continue;
+
+		/* Get the monster index */
+		r_idx = table[i].index;
+
+		/* Get the actual race */
+		r_ptr = &r_info[r_idx];
+
+		/* Hack -- some monsters are unique */
+		if ((rf_has(r_ptr->flags, RF_UNIQUE))
+			&& (r_ptr->cur_num >= r_ptr->max_num))
+			continue;
+
+		/* Forced-depth monsters only appear at their level. Usually. */
+		if ((rf_has(r_ptr->flags, RF_FORCE_DEPTH))
+			&& (r_ptr->level != p_ptr->depth)) {
+			/* Hack for questors on FAnilla map */
+			if (!MAP(FANILLA) || (r_ptr->level >= 99)
+				|| (!rf_has(r_ptr->flags, RF_QUESTOR)))
+				continue;
+		}
+		
+		/* Hack - handle dungeon specific -NRM- */
+		if (!MAP(FANILLA)) {
+			if ((rf_has(r_ptr->flags, RF_RUDH))
+				&& (stage_map[p_ptr->stage][LOCALITY] != AMON_RUDH))
+				continue;
+			
+			if ((rf_has(r_ptr->flags, RF_NARGOTHROND))
+				&& (stage_map[p_ptr->stage][LOCALITY] != NARGOTHROND))
+				continue;
+
+			if ((rf_has(r_ptr->flags, RF_DUNGORTHEB))
+				&& (stage_map[p_ptr->stage][LOCALITY] !=
+					NAN_DUNGORTHEB))
+				continue;
+
+			if ((rf_has(r_ptr->flags, RF_GAURHOTH))
+				&& (stage_map[p_ptr->stage][LOCALITY] !=
+					TOL_IN_GAURHOTH))
+				continue;
+		}
+
+		if ((rf_has(r_ptr->flags, RF_ANGBAND))
+			&& (stage_map[p_ptr->stage][LOCALITY] != ANGBAND))
+			continue;
+
+		/* Hack - dungeon-only monsters */
+		if ((rf_has(r_ptr->flags, RF_DUNGEON))
+			&& (stage_map[p_ptr->stage][STAGE_TYPE] != CAVE))
+			continue;
+
+		/* Hack - choose flying monsters for mountaintop */
+		if ((stage_map[p_ptr->stage][LOCALITY] == MOUNTAIN_TOP)
+			&& !(rf_has(r_ptr->flags, RF_FLYING)))
+			continue;
+
+		/* Accept */
+		table[i].prob3 = table[i].prob2;
+
+		/* Now modifications for locality etc follow -NRM- */
+
+		/* Nan Dungortheb is spiderland, bad for humans and humanoids */
+		if (stage_map[p_ptr->stage][LOCALITY] == NAN_DUNGORTHEB) {
+			if (r_ptr->d_char == 'S')
+				table[i].prob3 *= 5;
+			if ((r_ptr->d_char == 'p') || (r_ptr->d_char == 'h'))
+				table[i].prob3 /= 3;
+		}
+
+		/* Tol-In-Gaurhoth is full of wolves and undead */
+		if (stage_map[p_ptr->stage][LOCALITY] == TOL_IN_GAURHOTH) {
+			if (r_ptr->d_char == 'C')
+				table[i].prob3 *= 4;
+			else if (rf_has(r_ptr->flags, RF_UNDEAD))
+				table[i].prob3 *= 2;
+		}
+
+		/* Most animals don't like desert and mountains */
+		if ((stage_map[p_ptr->stage][STAGE_TYPE] == DESERT)
+			|| (stage_map[p_ptr->stage][STAGE_TYPE] == MOUNTAIN)) {
+			if ((r_ptr->d_char == 'R') || (r_ptr->d_char == 'J')
+				|| (r_ptr->d_char == 'c'))
+				table[i].prob3 *= 2;
+			else if (rf_has(r_ptr->flags, RF_ANIMAL))
+				table[i].prob3 /= 2;
+		}
+
+		/* Most animals do like forest */
+		if (stage_map[p_ptr->stage][STAGE_TYPE] == FOREST) {
+			if (r_ptr->d_char == 'R')
+				table[i].prob3 /= 2;
+			else if ((rf_has(r_ptr->flags, RF_ANIMAL))
+					 && (r_ptr->d_char != 'Z'))
+				table[i].prob3 *= 2;
+		}
+
+
+
+		/* Keep low-level monsters rare */
+		if (table[i].level < depth_rare)
+			table[i].prob3 /= 4;
+		if (table[i].level < depth_very_rare)
+			table[i].prob3 /= 4;
+
+		/* Sum up probabilities */
+		alloc_race_total += table[i].prob3;
+	}
+
+	/* Remember what the table is for */
+	mon_num_level = level;
+	mon_num_temp_level = temp_level;
+	mon_num_stage = p_ptr->stage;
+	mon_num_depth = p_ptr->depth;
+	mon_num_map = p_ptr->map;
+
+	/* Nothing to draw */
+	if (alloc_race_total == 0)
+		return;
+
+	get_mon_num_alias();
+}
+
 
 /**
  * Choose a monster race that seems "appropriate" to the given level
@@ -464,7 +1009,9 @@ errr get_mon_num_prep(void)
  * This function uses the "prob2" field of the "monster allocation table",
  * and various local information, to calculate the "prob3" field of the
  * same table, which is then used to choose an "appropriate" monster, in
- * a relatively efficient manner.
+ * a relatively efficient manner.  The alias table built from "prob3" is
+ * kept until the level, the restriction or the uniques available change,
+ * so repeated calls at the same level draw in constant time.
  *
  * Note that "town" monsters will *only* be created in the town, and
  * "normal" monsters will *never* be created in the town, unless the
@@ -482,22 +1029,11 @@ errr get_mon_num_prep(void)
  */
 s16b get_mon_num(int level)
 {
-	int i, d;
-
-	int r_idx;
+	int d;
 
-	long value;
 	int failure = 0;
 	int temp_level = level;
 
-	monster_race *r_ptr;
-
-	alloc_entry *table = alloc_race_table;
-
-	/* Low-level monsters avoid the deep dungeon. */
-	int depth_rare = 2 * level / 3;
-	int depth_very_rare = level / 3;
-
 
 	/* Sometimes, monsters in the dungeon can be out of depth */
 	if (p_ptr->depth != 0) {
@@ -528,132 +1064,12 @@ s16b get_mon_num(int level)
 
 	/* Try hard to find a suitable monster */
 	while (TRUE) {
-		/* Reset sum of final monster probabilities. */
-		alloc_race_total = 0L;
-
-		/* Process probabilities */
-		for (i = 0; i < alloc_race_size; i++) {
-			/* Assume no probability */
-			table[i].prob3 = 0;
-
-			/* Ignore illegal monsters */
-			if (!table[i].prob2)
-				continue;
-
-			/* Monsters are sorted by depth */
-			if (table[i].level > temp_level)
-				continue;
-
-			/* Hack -- No town monsters in dungeon */
-			if ((p_ptr->depth != 0) && (table[i].level < 1))
-				continue;
-
-			/* Get the monster index */
-			r_idx = table[i].index;
-
-			/* Get the actual race */
-			r_ptr = &r_info[r_idx];
-
-			/* Hack -- some monsters are unique */
-			if ((rf_has(r_ptr->flags, RF_UNIQUE))
-				&& (r_ptr->cur_num >= r_ptr->max_num))
-				continue;
-
-			/* Forced-depth monsters only appear at their level. Usually. */
-			if ((rf_has(r_ptr->flags, RF_FORCE_DEPTH))
-				&& (r_ptr->level != p_ptr->depth)) {
-				/* Hack for questors on FAnilla map */
-				if (!MAP(FANILLA) || (r_ptr->level >= 99)
-					|| (!rf_has(r_ptr->flags, RF_QUESTOR)))
-					continue;
-			}
-			
-			/* Hack - handle dungeon specific -NRM- */
-			if (!MAP(FANILLA)) {
-				if ((rf_has(r_ptr->flags, RF_RUDH))
-					&& (stage_map[p_ptr->stage][LOCALITY] != AMON_RUDH))
-					continue;
-				
-				if ((rf_has(r_ptr->flags, RF_NARGOTHROND))
-					&& (stage_map[p_ptr->stage][LOCALITY] != NARGOTHROND))
-					continue;
-
-				if ((rf_has(r_ptr->flags, RF_DUNGORTHEB))
-					&& (stage_map[p_ptr->stage][LOCALITY] !=
-						NAN_DUNGORTHEB))
-					continue;
-
-				if ((rf_has(r_ptr->flags, RF_GAURHOTH))
-					&& (stage_map[p_ptr->stage][LOCALITY] !=
-						TOL_IN_GAURHOTH))
-					continue;
-			}
-
-			if ((rf_has(r_ptr->flags, RF_ANGBAND))
-				&& (stage_map[p_ptr->stage][LOCALITY] != ANGBAND))
-				continue;
-
-			/* Hack - dungeon-only monsters */
-			if ((rf_has(r_ptr->flags, RF_DUNGEON))
-				&& (stage_map[p_ptr->stage][STAGE_TYPE] != CAVE))
-				continue;
-
-			/* Hack - choose flying monsters for mountaintop */
-			if ((stage_map[p_ptr->stage][LOCALITY] == MOUNTAIN_TOP)
-				&& !(rf_has(r_ptr->flags, RF_FLYING)))
-				continue;
-
-			/* Accept */
-			table[i].prob3 = table[i].prob2;
-
-			/* Now modifications for locality etc follow -NRM- */
-
-			/* Nan Dungortheb is spiderland, bad for humans and humanoids */
-			if (stage_map[p_ptr->stage][LOCALITY] == NAN_DUNGORTHEB) {
-				if (r_ptr->d_char == 'S')
-					table[i].prob3 *= 5;
-				if ((r_ptr->d_char == 'p') || (r_ptr->d_char == 'h'))
-					table[i].prob3 /= 3;
-			}
-
-			/* Tol-In-Gaurhoth is full of wolves and undead */
-			if (stage_map[p_ptr->stage][LOCALITY] == TOL_IN_GAURHOTH) {
-				if (r_ptr->d_char == 'C')
-					table[i].prob3 *= 4;
-				else if (rf_has(r_ptr->flags, RF_UNDEAD))
-					table[i].prob3 *= 2;
-			}
-
-			/* Most animals don't like desert and mountains */
-			if ((stage_map[p_ptr->stage][STAGE_TYPE] == DESERT)
-				|| (stage_map[p_ptr->stage][STAGE_TYPE] == MOUNTAIN)) {
-				if ((r_ptr->d_char == 'R') || (r_ptr->d_char == 'J')
-					|| (r_ptr->d_char == 'c'))
-					table[i].prob3 *= 2;
-				else if (rf_has(r_ptr->flags, RF_ANIMAL))
-					table[i].prob3 /= 2;
-			}
-
-			/* Most animals do like forest */
-			if (stage_map[p_ptr->stage][STAGE_TYPE] == FOREST) {
-				if (r_ptr->d_char == 'R')
-					table[i].prob3 /= 2;
-				else if ((rf_has(r_ptr->flags, RF_ANIMAL))
-						 && (r_ptr->d_char != 'Z'))
-					table[i].prob3 *= 2;
-			}
-
-
-
-			/* Keep low-level monsters rare */
-			if (table[i].level < depth_rare)
-				table[i].prob3 /= 4;
-			if (table[i].level < depth_very_rare)
-				table[i].prob3 /= 4;
-
-			/* Sum up probabilities */
-			alloc_race_total += table[i].prob3;
-		}
+		/* Recalculate the probabilities unless they are still good */
+		if ((mon_num_level != level) || (mon_num_temp_level != temp_level)
+			|| (mon_num_stage != p_ptr->stage)
+			|| (mon_num_depth != p_ptr->depth)
+			|| (mon_num_map != p_ptr->map))
+			get_mon_num_calc(level, temp_level);
 
 		/* No legal monsters */
 		if (alloc_race_total == 0) {
@@ -677,20 +1093,7 @@ s16b get_mon_num(int level)
 	}
 
 	/* Pick a monster */
-	value = randint0(alloc_race_total);
-
-	/* Find the monster */
-	for (i = 0; i < alloc_race_size; i++) {
-		/* Found the entry */
-		if (value < table[i].prob3)
-			break;
-
-		/* Decrement */
-		value = value - table[i].prob3;
-	}
-
-	/* Result */
-	return (table[i].index);
+	return (get_mon_num_draw());
 }
 
 
@@ -719,6 +1122,10 @@ s16b get_mon_num_quick(int level)
 		return (get_mon_num(level));
 
 
+	/* Draw from the alias table if it still matches the probabilities */
+	if (mon_num_level >= 0)
+		return (get_mon_num_draw());
+
 	/* Pick a monster */
 	value = randint0(alloc_race_total);
 
@@ -1825,7 +2232,7 @@ void update_mon(int m_idx, bool full)
 			light_spot(fy, fx);
 
 			/* Update health bar as needed */
-			if (p_ptr->health_who == m_idx)
+			if (health_tracked() == m_idx)
 				p_ptr->redraw |= (PR_HEALTH | PR_MON_MANA);
 
 			/* Hack -- Count "fresh" sightings */
@@ -1849,7 +2256,7 @@ void update_mon(int m_idx, bool full)
 			light_spot(fy, fx);
 
 			/* Update health bar as needed */
-			if (p_ptr->health_who == m_idx)
+			if (health_tracked() == m_idx)
 				p_ptr->redraw |= (PR_HEALTH | PR_MON_MANA);
 
 			/* Redraw stuff */
@@ -2004,7 +2411,7 @@ bool is_detected(int y, int x)
 			continue;
 
 		/* Return false if undetected */
-		if (!sqinfo_has(cave_info[yy][xx], SQUARE_DTRAP))
+		if (!square_has(yy, xx, SQUARE_DTRAP))
 			return (FALSE);
 	}
 
@@ -2041,8 +2448,10 @@ void monster_swap(int y1, int x1, int y2, int x2)
 		m_ptr = &m_list[m1];
 
 		/* Move monster */
+		monster_bucket_remove(m1);
 		m_ptr->fy = y2;
 		m_ptr->fx = x2;
+		monster_bucket_add(m1);
 
 		/* Update monster */
 		update_mon(m1, TRUE);
@@ -2064,8 +2473,10 @@ void monster_swap(int y1, int x1, int y2, int x2)
 		m_ptr = &m_list[m2];
 
 		/* Move monster */
+		monster_bucket_remove(m2);
 		m_ptr->fy = y1;
 		m_ptr->fx = x1;
+		monster_bucket_add(m2);
 
 		/* Update monster */
 		update_mon(m2, TRUE);
@@ -2087,7 +2498,7 @@ void monster_swap(int y1, int x1, int y2, int x2)
 		bool old_dtrap, new_dtrap;
 
 		/* Calculate changes in dtrap status */
-		old_dtrap = sqinfo_has(cave_info[y1][x1], SQUARE_DTRAP);
+		old_dtrap = square_has(y1, x1, SQUARE_DTRAP);
 		new_dtrap = is_detected(y2, x2);
 
 		/* Note the change in the detect status */
@@ -2182,6 +2593,9 @@ s16b monster_place(int y, int x, monster_type * n_ptr)
 		m_ptr->fy = y;
 		m_ptr->fx = x;
 
+		/* File it by location */
+		monster_bucket_add(m_idx);
+
 		/* Update the monster */
 		update_mon(m_idx, TRUE);
 
@@ -2202,6 +2616,10 @@ s16b monster_place(int y, int x, monster_type * n_ptr)
             
         /* Count racial occurances */
 		r_ptr->cur_num++;
+
+		/* A unique is no longer available */
+		if (rf_has(r_ptr->flags, RF_UNIQUE))
+			get_mon_num_forget();
 	}
 
 	/* Result */
@@ -2362,6 +2780,9 @@ static bool place_monster_one(int y, int x, int r_idx, bool slp, u16b summon_fac
 	/* Clean out the monster */
 	(void) WIPE(n_ptr, monster_type);
 
+	/* Not a pet */
+	n_ptr->pet_num = -1;
+
 
 	/* Save the race */
 	n_ptr->r_idx = r1_idx;
@@ -2504,7 +2925,7 @@ static bool place_monster_one(int y, int x, int r_idx, bool slp, u16b summon_fac
 		k = randint0(chance + 20);
 		if ((k > 20) || (stage_map[p_ptr->stage][STAGE_TYPE] == CAVE)
 			|| (p_ptr->themed_level == THEME_WARLORDS)
-			|| sqinfo_has(cave_info[y][x], SQUARE_ICKY))
+			|| square_has(y, x, SQUARE_ICKY))
 			n_ptr->hostile = -1;
 		else
 			n_ptr->hostile = 0;
@@ -2945,7 +3366,7 @@ bool alloc_monster(int dis, bool slp, bool quick)
 
 		/* Do not put random monsters in marked rooms. */
 		if ((!character_dungeon)
-			&& sqinfo_has(cave_info[y][x], SQUARE_TEMP))
+			&& square_has(y, x, SQUARE_TEMP))
 			continue;
 
 		/* Accept far away grids */
@@ -4579,7 +5000,7 @@ bool mon_take_hit(int m_idx, int dam, bool * fear, const char *note, int source)
 		return (FALSE);
 
 	/* Redraw (later) if needed */
-	if (p_ptr->health_who == m_idx)
+	if (health_tracked() == m_idx)
 		p_ptr->redraw |= (PR_HEALTH);
 
 	/* Wake it up */
@@ -4720,6 +5141,7 @@ bool mon_take_hit(int m_idx, int dam, bool * fear, const char *note, int source)
 			char real_name[120];
 
 			r_ptr->max_num--;
+			get_mon_num_forget();
 
 			/* write note for player ghosts */
 			if (rf_has(r_ptr->flags, RF_PLAYER_GHOST)) {
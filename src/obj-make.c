@@ -29,16 +29,103 @@
 #include "types.h"
 
 
+/**
+ * The restrictions (and required tval and depth, which they may depend on)
+ * that the rows of alloc_kind_cum were built for
+ */
+static bool (*kind_cum_hook[ALLOC_KIND_CACHE]) (int k_idx);
+static byte kind_cum_tval[ALLOC_KIND_CACHE];
+static int kind_cum_depth[ALLOC_KIND_CACHE];
+static bool kind_cum_used[ALLOC_KIND_CACHE];
+
+/**
+ * The row of alloc_kind_cum for the current restriction, or -1 if none has
+ * been chosen yet; and the next row to be replaced
+ */
+static int kind_cum_row = -1;
+static int kind_cum_next = 0;
+
+
+/**
+ * Count the entries of an allocation table (which is sorted by depth) that
+ * are no deeper than the given level
+ */
+static int alloc_level_count(const alloc_entry *table, int size, int level)
+{
+	int lo = 0, hi = size;
+
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+
+		if (table[mid].level > level)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+
+	return (lo);
+}
+
+
+/**
+ * Find the first of the first "size" running totals which is more than
+ * "value"; this is the entry a linear walk subtracting each probability
+ * from "value" would stop at.
+ */
+static int alloc_cum_find(const u32b *cum, int size, long value)
+{
+	int lo = 0, hi = size - 1;
+
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+
+		if ((long) cum[mid] > value)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+
+	return (lo);
+}
+
+
 /**
  * Apply a "object restriction function" to the "object allocation table"
+ *
+ * The running totals of the probabilities of objects passing the
+ * restriction are kept, so that going back to a restriction used
+ * recently (usually none, "good" objects or a required tval) costs
+ * nothing.  Restrictions may only depend on the object kind,
+ * "required_tval" and the current depth.
  */
 errr get_obj_num_prep(void)
 {
 	int i;
+	u32b *cum;
+	u32b total = 0;
 
 	/* Get the entry */
 	alloc_entry *table = alloc_kind_table;
 
+	/* Use the kept totals if we have them */
+	for (i = 0; i < ALLOC_KIND_CACHE; i++) {
+		if (kind_cum_used[i] && (kind_cum_hook[i] == get_obj_num_hook)
+			&& (kind_cum_tval[i] == required_tval)
+			&& (kind_cum_depth[i] == p_ptr->depth)) {
+			kind_cum_row = i;
+			return (0);
+		}
+	}
+
+	/* Replace the oldest row */
+	kind_cum_row = kind_cum_next;
+	kind_cum_next = (kind_cum_next + 1) % ALLOC_KIND_CACHE;
+	kind_cum_used[kind_cum_row] = TRUE;
+	kind_cum_hook[kind_cum_row] = get_obj_num_hook;
+	kind_cum_tval[kind_cum_row] = required_tval;
+	kind_cum_depth[kind_cum_row] = p_ptr->depth;
+	cum = &alloc_kind_cum[kind_cum_row * alloc_kind_size];
+
 	/* Scan the allocation table */
 	for (i = 0; i < alloc_kind_size; i++) {
 		/* Accept objects which pass the restriction, if any */
@@ -52,6 +139,10 @@ errr get_obj_num_prep(void)
 			/* Decline this object */
 			table[i].prob2 = 0;
 		}
+
+		/* Running total */
+		total += table[i].prob2;
+		cum[i] = total;
 	}
 
 	/* Success */
@@ -63,10 +154,10 @@ errr get_obj_num_prep(void)
 /**
  * Choose an object kind that seems "appropriate" to the given level
  *
- * This function uses the "prob2" field of the "object allocation table",
- * and various local information, to calculate the "prob3" field of the
- * same table, which is then used to choose an "appropriate" object, in
- * a relatively efficient manner.
+ * This function uses the running totals of the "prob2" field of the
+ * "object allocation table" for the current restriction to choose an
+ * "appropriate" object by binary search.  Only when opening a chest,
+ * which forbids further chests, are the totals worked out afresh.
  *
  * It is (slightly) more likely to acquire an object of the given level
  * than one of a lower level.  This is done by choosing several objects
@@ -77,13 +168,12 @@ errr get_obj_num_prep(void)
  */
 s16b get_obj_num(int level)
 {
-	int i, j, p;
-
-	int k_idx;
+	int i, j, p, n;
 
 	long value, total;
 
-	object_kind *k_ptr;
+	u32b *cum;
+	u32b *chest_cum = NULL;
 
 	alloc_entry *table = alloc_kind_table;
 
@@ -95,53 +185,42 @@ s16b get_obj_num(int level)
 			level += randint1(20) + randint1(level / 2);
 	}
 
+	/* Make sure the running totals are ready */
+	if (kind_cum_row < 0)
+		get_obj_num_prep();
+	cum = &alloc_kind_cum[kind_cum_row * alloc_kind_size];
 
-	/* Reset total */
-	total = 0L;
-
-	/* Process probabilities */
-	for (i = 0; i < alloc_kind_size; i++) {
-		/* Objects are sorted by depth */
-		if (table[i].level > level)
-			break;
-
-		/* Default */
-		table[i].prob3 = 0;
-
-		/* Access the index */
-		k_idx = table[i].index;
-
-		/* Access the actual kind */
-		k_ptr = &k_info[k_idx];
-
-		/* Hack -- prevent embedded chests */
-		if (opening_chest && (k_ptr->tval == TV_CHEST))
-			continue;
+	/* Objects are sorted by depth */
+	n = alloc_level_count(table, alloc_kind_size, level);
 
-		/* Accept */
-		table[i].prob3 = table[i].prob2;
+	/* Hack -- prevent embedded chests */
+	if (opening_chest && n) {
+		u32b sum = 0;
 
-		/* Total */
-		total += table[i].prob3;
+		chest_cum = C_ZNEW(n, u32b);
+		for (i = 0; i < n; i++) {
+			if (k_info[table[i].index].tval != TV_CHEST)
+				sum += cum[i] - (i ? cum[i - 1] : 0);
+			chest_cum[i] = sum;
+		}
+		cum = chest_cum;
 	}
 
+	/* Total */
+	total = n ? cum[n - 1] : 0L;
+
 	/* No legal objects */
-	if (total <= 0)
+	if (total <= 0) {
+		FREE(chest_cum);
 		return (0);
+	}
 
 
 	/* Pick an object */
 	value = randint0(total);
 
 	/* Find the object */
-	for (i = 0; i < alloc_kind_size; i++) {
-		/* Found the entry */
-		if (value < table[i].prob3)
-			break;
-
-		/* Decrement */
-		value = value - table[i].prob3;
-	}
+	i = alloc_cum_find(cum, n, value);
 
 
 	/* Power boost */
@@ -161,14 +240,7 @@ s16b get_obj_num(int level)
 		value = randint0(total);
 
 		/* Find the object */
-		for (i = 0; i < alloc_kind_size; i++) {
-			/* Found the entry */
-			if (value < table[i].prob3)
-				break;
-
-			/* Decrement */
-			value = value - table[i].prob3;
-		}
+		i = alloc_cum_find(cum, n, value);
 
 		/* Keep the "best" one */
 		if (table[i].level < table[j].level)
@@ -184,20 +256,15 @@ s16b get_obj_num(int level)
 		value = randint0(total);
 
 		/* Find the object */
-		for (i = 0; i < alloc_kind_size; i++) {
-			/* Found the entry */
-			if (value < table[i].prob3)
-				break;
-
-			/* Decrement */
-			value = value - table[i].prob3;
-		}
+		i = alloc_cum_find(cum, n, value);
 
 		/* Keep the "best" one */
 		if (table[i].level < table[j].level)
 			i = j;
 	}
 
+	FREE(chest_cum);
+
 	/* Hack - keep level for jewellery generation */
 	j_level = table[i].level;
 
@@ -343,6 +410,84 @@ bool good_ego(const ego_item_type * e_ptr)
 	return TRUE;
 }
 
+/**
+ * The base types and powers (-1 cursed, 1 not cursed, 0 either) that the
+ * rows of alloc_ego_cum were built for, and the next row to be replaced
+ */
+static byte ego_cum_tval[ALLOC_EGO_CACHE];
+static byte ego_cum_sval[ALLOC_EGO_CACHE];
+static int ego_cum_power[ALLOC_EGO_CACHE];
+static bool ego_cum_used[ALLOC_EGO_CACHE];
+static int ego_cum_next = 0;
+
+
+/**
+ * Find the running totals of the probabilities of the ego-items of the
+ * given power which can be made from an object, working them out if they
+ * are not kept.
+ */
+static u32b *ego_cum_get(const object_type *o_ptr, int power)
+{
+	int i, j, row;
+	u32b *cum;
+	u32b total = 0;
+
+	alloc_entry *table = alloc_ego_table;
+
+	/* Only the sign of the power matters */
+	power = (power > 0) ? 1 : ((power < 0) ? -1 : 0);
+
+	/* Use the kept totals if we have them */
+	for (row = 0; row < ALLOC_EGO_CACHE; row++) {
+		if (ego_cum_used[row] && (ego_cum_tval[row] == o_ptr->tval)
+			&& (ego_cum_sval[row] == o_ptr->sval)
+			&& (ego_cum_power[row] == power))
+			return (&alloc_ego_cum[row * alloc_ego_size]);
+	}
+
+	/* Replace the oldest row */
+	row = ego_cum_next;
+	ego_cum_next = (ego_cum_next + 1) % ALLOC_EGO_CACHE;
+	ego_cum_used[row] = TRUE;
+	ego_cum_tval[row] = o_ptr->tval;
+	ego_cum_sval[row] = o_ptr->sval;
+	ego_cum_power[row] = power;
+	cum = &alloc_ego_cum[row * alloc_ego_size];
+
+	/* Process probabilities */
+	for (i = 0; i < alloc_ego_size; i++) {
+		/* Get the actual kind */
+		ego_item_type *e_ptr = &e_info[table[i].index];
+
+		/* Running total so far */
+		cum[i] = total;
+
+		/* If we force good/great, don't create cursed */
+		if ((power > 0) && (!good_ego(e_ptr)))
+			continue;
+
+		/* If we force cursed, don't create good */
+		if ((power < 0) && good_ego(e_ptr))
+			continue;
+
+		/* Test if this is a legal ego-item type for this object */
+		for (j = 0; j < EGO_TVALS_MAX; j++) {
+			/* Require identical base type */
+			if ((o_ptr->tval == e_ptr->tval[j])
+				&& (o_ptr->sval >= e_ptr->min_sval[j])
+				&& (o_ptr->sval <= e_ptr->max_sval[j])) {
+				/* Accept */
+				total += table[i].prob2;
+				cum[i] = total;
+				break;
+			}
+		}
+	}
+
+	return (cum);
+}
+
+
 /**
  * Attempt to change an object into an ego-item -MWK-
  * Better only called by apply_magic().
@@ -357,13 +502,13 @@ bool good_ego(const ego_item_type * e_ptr)
  */
 static int make_ego_item(object_type * o_ptr, int power)
 {
-	int i, j, level;
+	int i, n, level;
 
 	int e_idx;
 
 	long value, total;
 
-	ego_item_type *e_ptr;
+	u32b *cum;
 
 	alloc_entry *table = alloc_ego_table;
 
@@ -385,50 +530,14 @@ static int make_ego_item(object_type * o_ptr, int power)
 		}
 	}
 
-	/* Reset total */
-	total = 0L;
-
-	/* Process probabilities */
-	for (i = 0; i < alloc_ego_size; i++) {
-		/* Default */
-		table[i].prob3 = 0;
-
-		/* Objects are sorted by depth */
-		if (table[i].level > level)
-			continue;
-
-		/* Get the index */
-		e_idx = table[i].index;
+	/* Get the probabilities */
+	cum = ego_cum_get(o_ptr, power);
 
-		/* Get the actual kind */
-		e_ptr = &e_info[e_idx];
+	/* Ego-items are sorted by depth */
+	n = alloc_level_count(table, alloc_ego_size, level);
 
-		/* If we force good/great, don't create cursed */
-		if ((power > 0) && (!good_ego(e_ptr)))
-			continue;
-
-		/* If we force cursed, don't create good */
-		if ((power < 0) && good_ego(e_ptr))
-			continue;
-
-		/* Test if this is a legal ego-item type for this object */
-		for (j = 0; j < EGO_TVALS_MAX; j++) {
-			/* Require identical base type */
-			if (o_ptr->tval == e_ptr->tval[j]) {
-				/* Require sval in bounds, lower */
-				if (o_ptr->sval >= e_ptr->min_sval[j]) {
-					/* Require sval in bounds, upper */
-					if (o_ptr->sval <= e_ptr->max_sval[j]) {
-						/* Accept */
-						table[i].prob3 = table[i].prob2;
-					}
-				}
-			}
-		}
-
-		/* Total */
-		total += table[i].prob3;
-	}
+	/* Total */
+	total = n ? cum[n - 1] : 0L;
 
 	/* No legal ego-items -- create a normal unenchanted one */
 	if (total == 0)
@@ -439,14 +548,7 @@ static int make_ego_item(object_type * o_ptr, int power)
 	value = randint0(total);
 
 	/* Find the object */
-	for (i = 0; i < alloc_ego_size; i++) {
-		/* Found the entry */
-		if (value < table[i].prob3)
-			break;
-
-		/* Decrement */
-		value = value - table[i].prob3;
-	}
+	i = alloc_cum_find(cum, n, value);
 
 	/* We have one */
 	e_idx = (byte) table[i].index;
@@ -1048,6 +1048,21 @@ void excise_object_idx(int o_idx)
 }
 
 
+/*
+ * Put the index of an object about to be wiped on the free list
+ */
+static void object_free_idx(int o_idx)
+{
+	/* Paranoia -- never free an index twice */
+	if (!o_list[o_idx].k_idx)
+		return;
+
+	o_gen[o_idx]++;
+	if (o_free_num < z_info->o_max)
+		o_free[o_free_num++] = o_idx;
+}
+
+
 /*
  * Delete a dungeon object
  *
@@ -1075,6 +1090,9 @@ void delete_object_idx(int o_idx)
 		light_spot(y, x);
 	}
 
+	/* Free the index */
+	object_free_idx(o_idx);
+
 	/* Wipe the object */
 	object_wipe(j_ptr);
 
@@ -1107,6 +1125,9 @@ void delete_object(int y, int x)
 		/* Get the next object */
 		next_o_idx = o_ptr->next_o_idx;
 
+		/* Free the index */
+		object_free_idx(this_o_idx);
+
 		/* Wipe the object */
 		object_wipe(o_ptr);
 
@@ -1189,6 +1210,9 @@ static void compact_objects_aux(int i1, int i2)
 
 	/* Hack -- wipe hole */
 	object_wipe(o_ptr);
+
+	/* The object has left its old index */
+	o_gen[i1]++;
 }
 
 
@@ -1233,6 +1257,9 @@ void compact_objects(int size)
 			/* Compress "o_max" */
 			o_max--;
 		}
+
+		/* There are no holes left */
+		o_free_num = 0;
 		return;
 	}
 
@@ -1378,6 +1405,7 @@ void wipe_o_list(void)
 
 		/* Wipe the object */
 		(void) WIPE(o_ptr, object_type);
+		o_gen[i]++;
 	}
 
 	/* Reset "o_max" */
@@ -1385,12 +1413,18 @@ void wipe_o_list(void)
 
 	/* Reset "o_cnt" */
 	o_cnt = 0;
+
+	/* No free indexes */
+	o_free_num = 0;
 }
 
 
 /*
  * Get and return the index of a "free" object.
  *
+ * Indexes freed by deleting objects are reused first, so that the object
+ * list need not be compacted while the level is played.
+ *
  * This routine should almost never fail, but in case it does,
  * we must be sure to handle "failure" of this routine.
  */
@@ -1399,6 +1433,21 @@ s16b o_pop(void)
 	int i;
 
 
+	/* Reuse a freed index */
+	while (o_free_num) {
+		i = o_free[--o_free_num];
+
+		/* Skip indexes compacted away or already reused */
+		if ((i >= o_max) || o_list[i].k_idx)
+			continue;
+
+		/* Count objects */
+		o_cnt++;
+
+		/* Use this object */
+		return (i);
+	}
+
 	/* Initial allocation */
 	if (o_max < z_info->o_max) {
 		/* Get next space */
@@ -1443,6 +1492,33 @@ s16b o_pop(void)
 }
 
 
+/*
+ * Get a handle on an object, which stays good while the object keeps its
+ * index; it goes stale when the object is deleted or moved by compaction.
+ */
+u32b object_handle(int o_idx)
+{
+	return (((u32b) o_gen[o_idx] << 16) | o_idx);
+}
+
+
+/*
+ * Get the index of the object a handle refers to, or 0 if it has gone
+ */
+int object_handle_idx(u32b handle)
+{
+	int o_idx = handle & 0xFFFF;
+
+	if (!o_idx || (o_idx >= o_max) || !o_list[o_idx].k_idx)
+		return (0);
+
+	if (o_gen[o_idx] != (handle >> 16))
+		return (0);
+
+	return (o_idx);
+}
+
+
 /*
  * Get the first object at a dungeon location
  * or NULL if there isn't one.
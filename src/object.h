@@ -25,6 +25,14 @@
  */
 #define GREAT_EGO	25
 
+/**
+ * The number of object restrictions, and of ego-item base types, whose
+ * cumulative allocation tables are kept (see get_obj_num_prep() and
+ * make_ego_item() in obj-make.c)
+ */
+#define ALLOC_KIND_CACHE	8
+#define ALLOC_EGO_CACHE		8
+
 struct player;
 typedef struct autoinscription autoinscription;
 
@@ -285,15 +293,15 @@ enum
 
 #define OF_SIZE                FLAG_SIZE(OF_MAX)
 
-#define of_has(f, flag)        flag_has_dbg(f, OF_SIZE, flag, #f, #flag)
+#define of_has(f, flag)        flag_has_fast(f, OF_SIZE, flag)
 #define of_next(f, flag)       flag_next(f, OF_SIZE, flag)
 #define of_is_empty(f)         flag_is_empty(f, OF_SIZE)
 #define of_is_full(f)          flag_is_full(f, OF_SIZE)
 #define of_is_inter(f1, f2)    flag_is_inter(f1, f2, OF_SIZE)
 #define of_is_subset(f1, f2)   flag_is_subset(f1, f2, OF_SIZE)
 #define of_is_equal(f1, f2)    flag_is_equal(f1, f2, OF_SIZE)
-#define of_on(f, flag)         flag_on_dbg(f, OF_SIZE, flag, #f, #flag)
-#define of_off(f, flag)        flag_off(f, OF_SIZE, flag)
+#define of_on(f, flag)         flag_on_fast(f, OF_SIZE, flag)
+#define of_off(f, flag)        flag_off_fast(f, OF_SIZE, flag)
 #define of_wipe(f)             flag_wipe(f, OF_SIZE)
 #define of_setall(f)           flag_setall(f, OF_SIZE)
 #define of_negate(f)           flag_negate(f, OF_SIZE)
@@ -323,15 +331,15 @@ enum
 
 #define CF_SIZE                FLAG_SIZE(CF_MAX)
 
-#define cf_has(f, flag)        flag_has_dbg(f, CF_SIZE, flag, #f, #flag)
+#define cf_has(f, flag)        flag_has_fast(f, CF_SIZE, flag)
 #define cf_next(f, flag)       flag_next(f, CF_SIZE, flag)
 #define cf_is_empty(f)         flag_is_empty(f, CF_SIZE)
 #define cf_is_full(f)          flag_is_full(f, CF_SIZE)
 #define cf_is_inter(f1, f2)    flag_is_inter(f1, f2, CF_SIZE)
 #define cf_is_subset(f1, f2)   flag_is_subset(f1, f2, CF_SIZE)
 #define cf_is_equal(f1, f2)    flag_is_equal(f1, f2, CF_SIZE)
-#define cf_on(f, flag)         flag_on_dbg(f, CF_SIZE, flag, #f, #flag)
-#define cf_off(f, flag)        flag_off(f, CF_SIZE, flag)
+#define cf_on(f, flag)         flag_on_fast(f, CF_SIZE, flag)
+#define cf_off(f, flag)        flag_off_fast(f, CF_SIZE, flag)
 #define cf_wipe(f)             flag_wipe(f, CF_SIZE)
 #define cf_setall(f)           flag_setall(f, CF_SIZE)
 #define cf_negate(f)           flag_negate(f, CF_SIZE)
@@ -356,15 +364,15 @@ enum
 
 #define KF_SIZE                FLAG_SIZE(KF_MAX)
 
-#define kf_has(f, flag)        flag_has_dbg(f, KF_SIZE, flag, #f, #flag)
+#define kf_has(f, flag)        flag_has_fast(f, KF_SIZE, flag)
 #define kf_next(f, flag)       flag_next(f, KF_SIZE, flag)
 #define kf_is_empty(f)         flag_is_empty(f, KF_SIZE)
 #define kf_is_full(f)          flag_is_full(f, KF_SIZE)
 #define kf_is_inter(f1, f2)    flag_is_inter(f1, f2, KF_SIZE)
 #define kf_is_subset(f1, f2)   flag_is_subset(f1, f2, KF_SIZE)
 #define kf_is_equal(f1, f2)    flag_is_equal(f1, f2, KF_SIZE)
-#define kf_on(f, flag)         flag_on_dbg(f, KF_SIZE, flag, #f, #flag)
-#define kf_off(f, flag)        flag_off(f, KF_SIZE, flag)
+#define kf_on(f, flag)         flag_on_fast(f, KF_SIZE, flag)
+#define kf_off(f, flag)        flag_off_fast(f, KF_SIZE, flag)
 #define kf_wipe(f)             flag_wipe(f, KF_SIZE)
 #define kf_setall(f)           flag_setall(f, KF_SIZE)
 #define kf_negate(f)           flag_negate(f, KF_SIZE)
@@ -389,15 +397,15 @@ enum
 
 #define IF_SIZE                FLAG_SIZE(IF_MAX)
 
-#define if_has(f, flag)        flag_has_dbg(f, IF_SIZE, flag, #f, #flag)
+#define if_has(f, flag)        flag_has_fast(f, IF_SIZE, flag)
 #define if_next(f, flag)       flag_next(f, IF_SIZE, flag)
 #define if_is_empty(f)         flag_is_empty(f, IF_SIZE)
 #define if_is_full(f)          flag_is_full(f, IF_SIZE)
 #define if_is_inter(f1, f2)    flag_is_inter(f1, f2, IF_SIZE)
 #define if_is_subset(f1, f2)   flag_is_subset(f1, f2, IF_SIZE)
 #define if_is_equal(f1, f2)    flag_is_equal(f1, f2, IF_SIZE)
-#define if_on(f, flag)         flag_on_dbg(f, IF_SIZE, flag, #f, #flag)
-#define if_off(f, flag)        flag_off(f, IF_SIZE, flag)
+#define if_on(f, flag)         flag_on_fast(f, IF_SIZE, flag)
+#define if_off(f, flag)        flag_off_fast(f, IF_SIZE, flag)
 #define if_wipe(f)             flag_wipe(f, IF_SIZE)
 #define if_setall(f)           flag_setall(f, IF_SIZE)
 #define if_negate(f)           flag_negate(f, IF_SIZE)
@@ -810,6 +818,8 @@ void delete_object(int y, int x);
 void compact_objects(int size);
 void wipe_o_list(void);
 s16b o_pop(void);
+u32b object_handle(int o_idx);
+int object_handle_idx(u32b handle);
 object_type *get_first_object(int y, int x);
 object_type *get_next_object(const object_type *o_ptr);
 s32b object_value(const object_type *o_ptr);
@@ -22,6 +22,13 @@
  * Each hook has a list of specs, which are essentially named formal parameters;
  * when we run a particular hook across a line, each spec in the hook is
  * assigned a value.
+ *
+ * Each line is copied into a buffer owned by the parser and split up in
+ * place, and the values live in an array owned by the parser, so parsing a
+ * line allocates nothing once the buffers are big enough.  Symbol and string
+ * values point into the line buffer, and are only good until the next line.
+ * All the tokenizing state is kept in the parser, so parsers do not get in
+ * each other's way.
  */
 
 
@@ -98,12 +105,19 @@ struct parser_value {
 	} u;
 };
 
+/**
+ * Number of chains in a parser's table of directives; a power of two
+ */
+#define PARSER_HOOK_BUCKETS	64
+
 struct parser_hook {
 	struct parser_hook *next;
+	struct parser_hook *hash_next;	/* Next hook in the same chain */
 	enum parser_error (*func)(struct parser *p);
 	char *dir;
 	struct parser_spec *fhead;
 	struct parser_spec *ftail;
+	size_t nspecs;
 };
 
 struct parser {
@@ -112,9 +126,16 @@ struct parser {
 	unsigned int colno;
 	char errmsg[1024];
 	struct parser_hook *hooks;
+	struct parser_hook *hook_table[PARSER_HOOK_BUCKETS];
 	struct parser_value *fhead;
 	struct parser_value *ftail;
 	void *priv;
+
+	char *line;			/* Copy of the current line, split in place */
+	size_t line_size;
+	char *pos;			/* Where the next field starts */
+	struct parser_value *values;	/* Values for the current line */
+	size_t values_size;
 };
 
 struct parser *parser_new(void) {
@@ -122,28 +143,57 @@ struct parser *parser_new(void) {
 	return p;
 }
 
+/**
+ * Hash a directive to its chain in a parser's table of directives
+ */
+static unsigned int hook_hash(const char *dir) {
+	unsigned int hash = 2166136261U;
+
+	while (*dir)
+		hash = (hash ^ (byte) *dir++) * 16777619U;
+
+	return hash & (PARSER_HOOK_BUCKETS - 1);
+}
+
+/**
+ * Find the hook for a directive.  Each chain holds the most recently
+ * registered hooks first, so a hook supersedes earlier ones for the same
+ * directive.
+ */
 static struct parser_hook *findhook(struct parser *p, const char *dir) {
-	struct parser_hook *h = p->hooks;
+	struct parser_hook *h = p->hook_table[hook_hash(dir)];
 	while (h)
 	{
 		if (!strcmp(h->dir, dir))
 			break;
-		h = h->next;
+		h = h->hash_next;
 	}
 	return h;
 }
 
-static void parser_freeold(struct parser *p) {
-	struct parser_value *v;
-	while (p->fhead)
-	{
-		int t = p->fhead->spec.type & ~PARSE_T_OPT;
-		v = (struct parser_value *)p->fhead->spec.next;
-		if (t == PARSE_T_SYM || t == PARSE_T_STR)
-			mem_free(p->fhead->u.sval);
-		mem_free(p->fhead);
-		p->fhead = v;
+/**
+ * Split the next token off the string at *pos, in the manner of strtok():
+ * leading delimiters are skipped, and the token is ended at the next one,
+ * after which *pos is left.  An empty "delim" takes the rest of the string.
+ */
+static char *next_token(char **pos, const char *delim) {
+	char *s = *pos;
+	char *end;
+
+	if (!s)
+		return NULL;
+
+	s += strspn(s, delim);
+	if (!*s) {
+		*pos = s;
+		return NULL;
 	}
+
+	end = s + strcspn(s, delim);
+	if (*end)
+		*end++ = '\0';
+	*pos = end;
+	return s;
 }
 
 static bool parse_random(const char *str, random_value *bonus) {
@@ -248,18 +298,15 @@ static bool parse_random(const char *str, random_value *bonus) {
 
 /* This is a bit long and should probably be refactored a bit. */
 enum parser_error parser_parse(struct parser *p, const char *line) {
-	char *cline;
 	char *tok;
 	struct parser_hook *h;
 	struct parser_spec *s;
 	struct parser_value *v;
-	char *sp = NULL;
+	size_t len;
 
 	assert(p);
 	assert(line);
 
-	parser_freeold(p);
-
 	p->lineno++;
 	p->colno = 1;
 	p->fhead = NULL;
@@ -271,11 +318,17 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	if (!*line || *line == '#')
 		return PARSE_ERROR_NONE;
 
-	cline = string_make(line);
+	/* Copy the line, growing the buffer if need be */
+	len = strlen(line) + 1;
+	if (len > p->line_size) {
+		p->line_size = MAX(len, 2 * p->line_size);
+		p->line = mem_realloc(p->line, p->line_size);
+	}
+	memcpy(p->line, line, len);
+	p->pos = p->line;
 
-	tok = strtok(cline, ":");
+	tok = next_token(&p->pos, ":");
 	if (!tok) {
-		mem_free(cline);
 		p->error = PARSE_ERROR_MISSING_FIELD;
 		return PARSE_ERROR_MISSING_FIELD;
 	}
@@ -284,10 +337,11 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	if (!h) {
         my_strcpy(p->errmsg, tok, sizeof(p->errmsg));
 		p->error = PARSE_ERROR_UNDEFINED_DIRECTIVE;
-		mem_free(cline);
 		return PARSE_ERROR_UNDEFINED_DIRECTIVE;
 	}
 
+	v = p->values;
+
 	/* There's a little bit of trickiness here to account for optional
 	 * types. The optional flag has a bit assigned to it in the spec's type
 	 * tag; we compute a temporary type for the spec with that flag removed
@@ -299,30 +353,27 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 		/* These types are tokenized on ':'; strings are not tokenized
 		 * at all (i.e., they consume the remainder of the line) */
 		if (t == PARSE_T_INT || t == PARSE_T_SYM || t == PARSE_T_RAND || t == PARSE_T_UINT) {
-			tok = strtok(sp, ":");
-			sp = NULL;
+			tok = next_token(&p->pos, ":");
 		} else if (t == PARSE_T_CHAR) {
-			tok = strtok(sp, "");
+			/* A char is followed by a ':' if anything */
+			tok = next_token(&p->pos, "");
 			if (tok)
-				sp = tok + 2;
+				p->pos = tok[1] ? tok + 2 : tok + 1;
 		} else {
-			tok = strtok(sp, "");
-			sp = NULL;
+			tok = next_token(&p->pos, "");
 		}
 		if (!tok)
 		{
 			if (!(s->type & PARSE_T_OPT)) {
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_MISSING_FIELD;
-				mem_free(cline);
 				return PARSE_ERROR_MISSING_FIELD;
 			}
 			break;
 		}
 
-		/* Allocate a value node, parse out its value, and link it into
-		 * the value list. */
-		v = mem_alloc(sizeof *v);
+		/* Take the next value node, parse out its value, and link it
+		 * into the value list. */
 		v->spec.next = NULL;
 		v->spec.type = s->type;
 		v->spec.name = s->name;
@@ -332,8 +383,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 			v->u.ival = strtol(tok, &z, 0);
 			if (z == tok)
 			{
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_NUMBER;
 				return PARSE_ERROR_NOT_NUMBER;
@@ -345,8 +394,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 			v->u.uval = strtoul(tok, &z, 0);
 			if (z == tok || *tok == '-')
 			{
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_NUMBER;
 				return PARSE_ERROR_NOT_NUMBER;
@@ -358,14 +405,12 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 		}
 		else if (t == PARSE_T_SYM || t == PARSE_T_STR)
 		{
-			v->u.sval = string_make(tok);
+			v->u.sval = tok;
 		}
 		else if (t == PARSE_T_RAND)
 		{
 			if (!parse_random(tok, &v->u.rval))
 			{
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_RANDOM;
 				return PARSE_ERROR_NOT_RANDOM;
@@ -375,11 +420,9 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 			p->fhead = v;
 		else
 			p->ftail->spec.next = &v->spec;
-		p->ftail = v;
+		p->ftail = v++;
 	}
 
-	mem_free(cline);
-
 	p->error = h->func(p);
 	return p->error;
 }
@@ -428,7 +471,8 @@ static void clean_specs(struct parser_hook *h) {
 
 void parser_destroy(struct parser *p) {
 	struct parser_hook *h;
-	parser_freeold(p);
+	mem_free(p->line);
+	mem_free(p->values);
 	while (p->hooks)
 	{
 		h = p->hooks->next;
@@ -448,22 +492,23 @@ static errr parse_specs(struct parser_hook *h, char *fmt) {
 	assert(h);
 	assert(fmt);
 
-	name = strtok(fmt, " ");
+	name = next_token(&fmt, " ");
 	if (!name)
 		return -EINVAL;
 	h->dir = string_make(name);
 	h->fhead = NULL;
 	h->ftail = NULL;
+	h->nspecs = 0;
 	while (name)
 	{
 		/* Lack of a type is legal; that means we're at the end of the
 		 * line. */
-		stype = strtok(NULL, " ");
+		stype = next_token(&fmt, " ");
 		if (!stype)
 			break;
 
 		/* Lack of a name, on the other hand... */
-		name = strtok(NULL, " ");
+		name = next_token(&fmt, " ");
 		if (!name)
 		{
 			clean_specs(h);
@@ -499,6 +544,7 @@ static errr parse_specs(struct parser_hook *h, char *fmt) {
 		else
 			h->fhead = s;
 		h->ftail = s;
+		h->nspecs++;
 	}
 
 	return 0;
@@ -528,6 +574,16 @@ errr parser_reg(struct parser *p, const char *fmt,
 
 	p->hooks = h;
 	mem_free(cfmt);
+
+	h->hash_next = p->hook_table[hook_hash(h->dir)];
+	p->hook_table[hook_hash(h->dir)] = h;
+
+	/* Make room for the values of the longest hook */
+	if (h->nspecs > p->values_size) {
+		p->values_size = h->nspecs;
+		p->values = mem_realloc(p->values, p->values_size * sizeof(*p->values));
+	}
+
 	return 0;
 }
 
@@ -662,14 +718,134 @@ void cleanup_parser(struct file_parser *fp)
 	fp->cleanup();
 }
 
-int lookup_flag(const char **flag_table, const char *flag_name) {
-	int i = FLAG_START;
+/**
+ * The most name tables which can be indexed
+ */
+#define MAX_NAME_INDEXES	32
 
-	while (flag_table[i] && !streq(flag_table[i], flag_name))
-		i++;
+/**
+ * An index of a table of names (such as the flag names made from the
+ * list-*-flags.h headers), sorted for binary searching
+ */
+struct name_index {
+	const char **table;	/* The table */
+	int *order;		/* Its entries, sorted by name then position */
+	int num;
+};
+
+static struct name_index name_indexes[MAX_NAME_INDEXES];
+static int num_name_indexes;
+static struct name_index *name_index_last;	/* The last one looked in */
+
+/**
+ * Sort comparison for name_index_get(), which keeps equal names in table
+ * order so that a search finds the first of them
+ */
+static const char **name_sort_table;
+
+static int name_cmp(const void *a, const void *b) {
+	int ia = *(const int *) a;
+	int ib = *(const int *) b;
+	int c = strcmp(name_sort_table[ia], name_sort_table[ib]);
+
+	return c ? c : ia - ib;
+}
+
+/**
+ * Find the index of the names in table[start] to table[start + num - 1],
+ * making it the first time the table is looked in.  A negative "num" means
+ * the names run up to a NULL.
+ */
+static struct name_index *name_index_get(const char **table, int start,
+										 int num) {
+	struct name_index *ni;
+	int i;
+
+	/* Lookups tend to come in runs on the same table */
+	if (name_index_last && (name_index_last->table == table))
+		return name_index_last;
+
+	for (i = 0; i < num_name_indexes; i++)
+		if (name_indexes[i].table == table)
+			return (name_index_last = &name_indexes[i]);
+
+	if (num_name_indexes == MAX_NAME_INDEXES)
+		return NULL;
+
+	if (num < 0)
+		for (num = 0; table[start + num]; num++)
+			;
+
+	ni = &name_indexes[num_name_indexes++];
+	ni->table = table;
+	ni->num = num;
+	ni->order = mem_alloc(MAX(num, 1) * sizeof(*ni->order));
+	for (i = 0; i < num; i++)
+		ni->order[i] = start + i;
+
+	name_sort_table = table;
+	qsort(ni->order, num, sizeof(*ni->order), name_cmp);
+
+	return (name_index_last = ni);
+}
+
+/**
+ * Find the position of "name" in table[start] to table[start + num - 1],
+ * or return -1 if it is not there; a negative "num" means the names run up
+ * to a NULL.  The first of several is found.
+ *
+ * Each table gets a sorted index the first time it is looked in, so it must
+ * not change afterwards.
+ */
+int lookup_table_name(const char **table, int start, int num,
+                      const char *name) {
+	struct name_index *ni = name_index_get(table, start, num);
+	int lo = 0, hi;
+
+	/* Out of indexes, so just look through the table */
+	if (!ni) {
+		int i;
+		for (i = start; (num < 0) ? (table[i] != NULL) : (i < start + num);
+			 i++)
+			if (streq(table[i], name))
+				return i;
+		return -1;
+	}
+
+	/* Find the first entry not before the name */
+	hi = ni->num;
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+
+		if (strcmp(table[ni->order[mid]], name) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if ((lo < ni->num) && streq(table[ni->order[lo]], name))
+		return ni->order[lo];
+
+	return -1;
+}
+
+/**
+ * Free the name indexes
+ */
+void cleanup_name_indexes(void) {
+	int i;
+
+	for (i = 0; i < num_name_indexes; i++)
+		mem_free(name_indexes[i].order);
+	num_name_indexes = 0;
+	name_index_last = NULL;
+}
+
+int lookup_flag(const char **flag_table, const char *flag_name) {
+	int i = lookup_table_name(flag_table, FLAG_START, -1, flag_name);
 
 	/* End of table reached without match */
-	if (!flag_table[i]) i = FLAG_END;
+	if (i < 0) i = FLAG_END;
 
 	return i;
 }
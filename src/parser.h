@@ -106,10 +106,14 @@ extern enum parser_error ignored(struct parser *p);
  */
 extern bool parser_hasval(struct parser *p, const char *name);
 
-/** Returns the symbol named `name`. This symbol must exist. */
+/** Returns the symbol named `name`. This symbol must exist. It is only valid
+ * until the next line is parsed, so copy it to keep it.
+ */
 extern const char *parser_getsym(struct parser *p, const char *name);
 
-/** Returns the string named `name`. This symbol must exist. */
+/** Returns the string named `name`. This symbol must exist. It is only valid
+ * until the next line is parsed, so copy it to keep it.
+ */
 extern const char *parser_getstr(struct parser *p, const char *name);
 
 /** Returns the integer named `name`. This symbol must exist. */
@@ -135,6 +139,9 @@ extern void parser_setstate(struct parser *p, unsigned int col, const char *msg)
 errr run_parser(struct file_parser *fp);
 errr parse_file(struct parser *p, const char *filename);
 void cleanup_parser(struct file_parser *fp);
+int lookup_table_name(const char **table, int start, int num,
+                      const char *name);
+void cleanup_name_indexes(void);
 int lookup_flag(const char **flag_table, const char *flag_name);
 errr grab_flag(bitflag *flags, const size_t size, const char **flag_table, const char *flag_name);
 errr remove_flag(bitflag *flags, const size_t size, const char **flag_table, const char *flag_name);
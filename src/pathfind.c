@@ -27,20 +27,42 @@
 
 /****** Pathfinding code ******/
 /**
- * Maximum size around the player to consider in the pathfinder
+ * Maximum length of a path.  No shortest path can be longer than the
+ * number of grids in the level.
  */
-#define MAX_PF_RADIUS 50
+#define MAX_PF_LENGTH (DUNGEON_HGT * DUNGEON_WID)
+
+char pf_result[MAX_PF_LENGTH];
+int pf_result_index;
 
 /**
- * Maximum distance to consider in the pathfinder
+ * Pathfinder search marks.  A grid has only been reached by the current
+ * search if its stamp matches "pf_search"; this saves wiping the whole
+ * level before every search.
  */
-#define MAX_PF_LENGTH 250
+static u16b pf_stamp[DUNGEON_HGT][DUNGEON_WID];
+static u16b pf_search;
 
-static int terrain[MAX_PF_RADIUS][MAX_PF_RADIUS];
-char pf_result[MAX_PF_LENGTH];
-int pf_result_index;
+/**
+ * Steps from the character, and the direction of the last step, on the
+ * best known path to each reached grid
+ */
+static u16b pf_dist[DUNGEON_HGT][DUNGEON_WID];
+static byte pf_dir[DUNGEON_HGT][DUNGEON_WID];
+
+/**
+ * Binary heap of grids still to be searched, ordered by estimated path
+ * length, and the position of each reached grid in it (-1 once a grid
+ * has been searched, or cannot be entered)
+ */
+static u16b pf_heap[DUNGEON_HGT * DUNGEON_WID];
+static int pf_heap_n;
+static s16b pf_heap_pos[DUNGEON_HGT][DUNGEON_WID];
 
-static int ox, oy, ex, ey;
+/**
+ * Target of the current search
+ */
+static int pf_goal_y, pf_goal_x;
 
 bool is_valid_pf(int y, int x)
 {
@@ -48,7 +70,7 @@ bool is_valid_pf(int y, int x)
 	int feat = cave_feat[y][x];
 
 	/* Hack -- assume unvisited is permitted */
-	if (!sqinfo_has(cave_info[y][x], SQUARE_MARK))
+	if (!square_has(y, x, SQUARE_MARK))
 		return (TRUE);
 
 	/* Get mimiced feat */
@@ -73,149 +95,196 @@ bool is_valid_pf(int y, int x)
 	return (TRUE);
 }
 
-static void fill_terrain_info(void)
+/**
+ * Estimated length of the shortest path through a grid.  Every step
+ * costs the same, diagonals included, so the distance left is at least
+ * the larger of the two offsets to the target.  Ties go to the grid
+ * nearer the target.
+ */
+static int pf_estimate(u16b grid)
+{
+	int y = GRID_Y(grid);
+	int x = GRID_X(grid);
+	int left = MAX(ABS(pf_goal_y - y), ABS(pf_goal_x - x));
+
+	return ((pf_dist[y][x] + left) * DUNGEON_WID + left);
+}
+
+/**
+ * Put a grid at a given position in the heap
+ */
+static void pf_heap_set(int i, u16b grid)
 {
-	int i, j;
+	pf_heap[i] = grid;
+	pf_heap_pos[GRID_Y(grid)][GRID_X(grid)] = i;
+}
 
-	ox = MAX(p_ptr->px - MAX_PF_RADIUS / 2, 0);
-	oy = MAX(p_ptr->py - MAX_PF_RADIUS / 2, 0);
+/**
+ * Move the grid at heap position i up until its parent is no worse
+ */
+static void pf_heap_up(int i)
+{
+	u16b grid = pf_heap[i];
+	int key = pf_estimate(grid);
 
-	ex = MIN(p_ptr->px + MAX_PF_RADIUS / 2 - 1, DUNGEON_WID);
-	ey = MIN(p_ptr->py + MAX_PF_RADIUS / 2 - 1, DUNGEON_HGT);
+	while (i > 0) {
+		int parent = (i - 1) / 2;
 
-	for (i = 0; i < MAX_PF_RADIUS * MAX_PF_RADIUS; i++)
-		terrain[0][i] = -1;
+		if (pf_estimate(pf_heap[parent]) <= key)
+			break;
 
-	for (j = oy; j < ey; j++)
-		for (i = ox; i < ex; i++)
-			if (is_valid_pf(j, i))
-				terrain[j - oy][i - ox] = MAX_PF_LENGTH;
+		pf_heap_set(i, pf_heap[parent]);
+		i = parent;
+	}
 
-	terrain[p_ptr->py - oy][p_ptr->px - ox] = 1;
+	pf_heap_set(i, grid);
 }
 
-#define MARK_DISTANCE(c,d) if ((c <= MAX_PF_LENGTH) && (c > d)) \
-                              { c = d; try_again = (TRUE); }
+/**
+ * Move the grid at heap position i down until its children are no better
+ */
+static void pf_heap_down(int i)
+{
+	u16b grid = pf_heap[i];
+	int key = pf_estimate(grid);
+
+	while (2 * i + 1 < pf_heap_n) {
+		int child = 2 * i + 1;
 
-bool findpath(int y, int x)
+		if ((child + 1 < pf_heap_n)
+			&& (pf_estimate(pf_heap[child + 1]) < pf_estimate(pf_heap[child])))
+			child++;
+
+		if (key <= pf_estimate(pf_heap[child]))
+			break;
+
+		pf_heap_set(i, pf_heap[child]);
+		i = child;
+	}
+
+	pf_heap_set(i, grid);
+}
+
+/**
+ * Take the most promising grid off the heap
+ */
+static u16b pf_heap_pop(void)
 {
-	int i, j, k, dir, starty = 0, startx = 0, start_index;
-	bool try_again;
-	int cur_distance;
-	int findir[] = { 1, 4, 7, 8, 9, 6, 3, 2 };
+	u16b grid = pf_heap[0];
 
-	fill_terrain_info();
+	pf_heap_pos[GRID_Y(grid)][GRID_X(grid)] = -1;
 
-	terrain[p_ptr->py - oy][p_ptr->px - ox] = 1;
+	if (--pf_heap_n > 0) {
+		pf_heap_set(0, pf_heap[pf_heap_n]);
+		pf_heap_down(0);
+	}
 
-	if ((x >= ox) && (x < ex) && (y >= oy) && (y < ey)) {
-		if ((cave_m_idx[y][x] > 0) && (m_list[cave_m_idx[y][x]].ml)) {
-			terrain[y - oy][x - ox] = MAX_PF_LENGTH;
-		}
-		/* else if (terrain[y - oy][x - ox] != MAX_PF_LENGTH) { bell("Target
-		 * blocked"); return (FALSE); } */
-		terrain[y - oy][x - ox] = MAX_PF_LENGTH;
-	} else {
+	return (grid);
+}
+
+/**
+ * Find the shortest known path from the character to (y, x), and store
+ * it in pf_result as a string of directions, last step first.
+ *
+ * This is an A* search over the whole level, so far away targets (such
+ * as mouse clicks across the map) can be reached.  Grids the character
+ * has not seen are assumed to be passable; the target itself is always
+ * allowed.
+ */
+bool findpath(int y, int x)
+{
+	int py = p_ptr->py;
+	int px = p_ptr->px;
+
+	bool found = FALSE;
+
+	if (!in_bounds_fully(y, x)) {
 		bell("Target out of range.");
 		return (FALSE);
 	}
 
-	if (terrain[y - oy][x - ox] == -1) {
-		bell("Target space forbidden");
-		return (FALSE);
+	/* Start a new search, wiping the stamps when the count wraps */
+	if (!++pf_search) {
+		C_WIPE(pf_stamp, DUNGEON_HGT * DUNGEON_WID, u16b);
+		pf_search = 1;
 	}
 
+	pf_goal_y = y;
+	pf_goal_x = x;
+
+	/* Start from the character */
+	pf_stamp[py][px] = pf_search;
+	pf_dist[py][px] = 0;
+	pf_dir[py][px] = 5;
+	pf_heap_n = 1;
+	pf_heap_set(0, GRID(py, px));
+
+	while (pf_heap_n) {
+		u16b grid = pf_heap_pop();
+		int gy = GRID_Y(grid);
+		int gx = GRID_X(grid);
+		int dist = pf_dist[gy][gx] + 1;
+		int dir;
+
+		/* The first time the target comes off the heap, the path is done */
+		if ((gy == y) && (gx == x)) {
+			found = TRUE;
+			break;
+		}
 
-	/* 
-	 * And now starts the very naive and very 
-	 * inefficient pathfinding algorithm
-	 */
-	do {
-		try_again = (FALSE);
-		for (j = oy + 1; j < ey - 1; j++)
-			for (i = ox + 1; i < ex - 1; i++) {
-				cur_distance = terrain[j - oy][i - ox] + 1;
-				if ((cur_distance > 0) && (cur_distance < MAX_PF_LENGTH)) {
-					for (dir = 1; dir < 10; dir++) {
-						if (dir == 5)
-							continue;
-						MARK_DISTANCE(terrain[j - oy + ddy[dir]]
-									  [i - ox + ddx[dir]], cur_distance);
-					}
-				}
+		for (dir = 1; dir < 10; dir++) {
+			int ny = gy + ddy[dir];
+			int nx = gx + ddx[dir];
+
+			if ((dir == 5) || !in_bounds_fully(ny, nx))
+				continue;
+
+			/* Grid already reached */
+			if (pf_stamp[ny][nx] == pf_search) {
+				/* Ignore finished grids and longer paths */
+				if ((pf_heap_pos[ny][nx] < 0) || (pf_dist[ny][nx] <= dist))
+					continue;
+
+				/* Shorten the path */
+				pf_dist[ny][nx] = dist;
+				pf_dir[ny][nx] = dir;
+				pf_heap_up(pf_heap_pos[ny][nx]);
+				continue;
 			}
-		if (terrain[y - oy][x - ox] < MAX_PF_LENGTH)
-			try_again = (FALSE);
-	} while (try_again);
+
+			pf_stamp[ny][nx] = pf_search;
+
+			/* Ignore known obstacles, but not at the target */
+			if (((ny != y) || (nx != x)) && !is_valid_pf(ny, nx)) {
+				pf_heap_pos[ny][nx] = -1;
+				continue;
+			}
+
+			/* Add the grid to the heap */
+			pf_dist[ny][nx] = dist;
+			pf_dir[ny][nx] = dir;
+			pf_heap_set(pf_heap_n++, GRID(ny, nx));
+			pf_heap_up(pf_heap_n - 1);
+		}
+	}
 
 	/* Failure */
-	if (terrain[y - oy][x - ox] == MAX_PF_LENGTH) {
+	if (!found) {
 		bell("Target space unreachable.");
 		return (FALSE);
 	}
 
-	/* Success */
-	i = x;
-	j = y;
-
+	/* Success -- walk back from the target, recording the steps */
 	pf_result_index = 0;
 
-	while ((i != p_ptr->px) || (j != p_ptr->py)) {
-		int xdiff = i - p_ptr->px, ydiff = j - p_ptr->py;
-
-		cur_distance = terrain[j - oy][i - ox] - 1;
-
-		/* Starting direction */
-		if (xdiff < 0)
-			startx = 1;
-		else if (xdiff > 0)
-			startx = -1;
-		else
-			startx = 0;
-
-		if (ydiff < 0)
-			starty = 1;
-		else if (ydiff > 0)
-			starty = -1;
-		else
-			starty = 0;
-
-		for (dir = 1; dir < 10; dir++)
-			if ((ddx[dir] == startx) && (ddy[dir] == starty))
-				break;
-
-		/* Should never happend */
-		if ((dir % 5) == 0) {
-			bell("Wtf ?");
-			return (FALSE);
-		}
-
-		for (start_index = 0; findir[start_index % 8] != dir;
-			 start_index++);
-
-		for (k = 0; k < 5; k++) {
-			dir = findir[(start_index + k) % 8];
-			if (terrain[j - oy + ddy[dir]][i - ox + ddx[dir]]
-				== cur_distance)
-				break;
-			dir = findir[(8 + start_index - k) % 8];
-			if (terrain[j - oy + ddy[dir]][i - ox + ddx[dir]]
-				== cur_distance)
-				break;
-		}
+	while ((y != py) || (x != px)) {
+		int dir = pf_dir[y][x];
 
-		/* Should never happend */
-		if (k == 5) {
-			bell("Heyyy !");
-			return (FALSE);
-		}
-
-		pf_result[pf_result_index++] = '0' + (char) (10 - dir);
-		i += ddx[dir];
-		j += ddy[dir];
-		starty = 0;
-		startx = 0;
+		pf_result[pf_result_index++] = '0' + (char) dir;
+		y -= ddy[dir];
+		x -= ddx[dir];
 	}
+
 	pf_result_index--;
 	return (TRUE);
 }
@@ -243,7 +312,7 @@ static int see_wall(int dir, int y, int x)
 		return (FALSE);
 
 	/* Unknown walls are not known walls */
-	if (!sqinfo_has(cave_info[y][x], SQUARE_MARK))
+	if (!square_has(y, x, SQUARE_MARK))
 		return (FALSE);
 
 	/* Default */
@@ -779,7 +848,7 @@ static bool run_test(void)
 		inv = TRUE;
 
 		/* Check memorized grids */
-		if (sqinfo_has(cave_info[row][col], SQUARE_MARK)) {
+		if (square_has(row, col, SQUARE_MARK)) {
 			bool notice = TRUE;
 
 			/* Examine the terrain */
@@ -914,7 +983,7 @@ static bool run_test(void)
 
 			/* Unknown grid or non-wall */
 			/* Was: cave_floor_bold(row, col) */
-			if (!sqinfo_has(cave_info[row][col], SQUARE_MARK)
+			if (!square_has(row, col, SQUARE_MARK)
 				|| !tf_has(f_ptr->flags, TF_ROCK)) {
 				/* Looking to break right */
 				if (p_ptr->run_break_right)
@@ -939,7 +1008,7 @@ static bool run_test(void)
 
 			/* Unknown grid or non-wall */
 			/* Was: cave_floor_bold(row, col) */
-			if (!sqinfo_has(cave_info[row][col], SQUARE_MARK)
+			if (!square_has(row, col, SQUARE_MARK)
 				|| !tf_has(f_ptr->flags, TF_ROCK)) {
 				/* Looking to break left */
 				if (p_ptr->run_break_left)
@@ -1045,7 +1114,7 @@ void run_step(int dir)
 				x = p_ptr->px + ddx[pf_result[pf_result_index] - '0'];
 
 				/* Known wall */
-				if (sqinfo_has(cave_info[y][x], SQUARE_MARK)
+				if (square_has(y, x, SQUARE_MARK)
 					&& !is_valid_pf(y, x)) {
 					disturb(0, 0);
 					p_ptr->running_withpathfind = FALSE;
@@ -1066,7 +1135,7 @@ void run_step(int dir)
 				x = p_ptr->px + ddx[pf_result[pf_result_index] - '0'];
 
 				/* Known wall */
-				if (sqinfo_has(cave_info[y][x], SQUARE_MARK)
+				if (square_has(y, x, SQUARE_MARK)
 					&& !is_valid_pf(y, x)) {
 					disturb(0, 0);
 					p_ptr->running_withpathfind = FALSE;
@@ -1078,7 +1147,7 @@ void run_step(int dir)
 				x = x + ddx[pf_result[pf_result_index - 1] - '0'];
 
 				/* Known wall */
-				if (sqinfo_has(cave_info[y][x], SQUARE_MARK)
+				if (square_has(y, x, SQUARE_MARK)
 					&& !is_valid_pf(y, x)) {
 					p_ptr->running_withpathfind = FALSE;
 
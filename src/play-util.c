@@ -285,34 +285,25 @@ bool add_pet(monster_type *m_ptr)
 	return FALSE;
 }
 
-/* Move all valid pets to the left of pet_list.  Once you hit one null, the
-   rest are null too.  Returns the number of valid pets. */
+/* Move all valid pets to the left of pet_list, keeping their order, so
+   that once you hit one null, the rest are null too.  Returns the number
+   of valid pets. */
 
 int compact_pets(void)
 {
-	int i, curr, last;
-	monster_type* tmp_ptr;
+	int i, curr = 0;
 
 	/* Compact the list by moving all non-blank entries to the left */
-	/* compact_pets_aux(p_ptr->pet_list, 0, MAX_NUM_PETS); */
-	curr = 0;
-	last = MAX_NUM_PETS;
-	while (curr < last)
+	for (i = 0; i < MAX_NUM_PETS; i++)
 	{
-	    while (p_ptr->pet_list[last] == 0)
-	        last--;
-        while (p_ptr->pet_list[curr] != 0)
-            curr++;
-        if (curr < last)
-        {
-            tmp_ptr = p_ptr->pet_list[last];
-            p_ptr->pet_list[last] = p_ptr->pet_list[curr];
-            p_ptr->pet_list[curr] = tmp_ptr;
-        }
-    }
+		if (p_ptr->pet_list[i])
+			p_ptr->pet_list[curr++] = p_ptr->pet_list[i];
+	}
+	for (i = curr; i < MAX_NUM_PETS; i++)
+		p_ptr->pet_list[i] = 0;
 
 	/* Update the indexes of all pets */
-	for (i = 0; i < MAX_NUM_PETS; i++)
+	for (i = 0; i < curr; i++)
 	{
 		p_ptr->pet_list[i]->pet_num = i;
 	}
@@ -337,15 +337,15 @@ enum
 #define PF_NO_SPECIALTY		255
 
 
-#define pf_has(f, flag)        flag_has_dbg(f, PF_SIZE, flag, #f, #flag)
+#define pf_has(f, flag)        flag_has_fast(f, PF_SIZE, flag)
 #define pf_next(f, flag)       flag_next(f, PF_SIZE, flag)
 #define pf_is_empty(f)         flag_is_empty(f, PF_SIZE)
 #define pf_is_full(f)          flag_is_full(f, PF_SIZE)
 #define pf_is_inter(f1, f2)    flag_is_inter(f1, f2, PF_SIZE)
 #define pf_is_subset(f1, f2)   flag_is_subset(f1, f2, PF_SIZE)
 #define pf_is_equal(f1, f2)    flag_is_equal(f1, f2, PF_SIZE)
-#define pf_on(f, flag)         flag_on_dbg(f, PF_SIZE, flag, #f, #flag)
-#define pf_off(f, flag)        flag_off(f, PF_SIZE, flag)
+#define pf_on(f, flag)         flag_on_fast(f, PF_SIZE, flag)
+#define pf_off(f, flag)        flag_off_fast(f, PF_SIZE, flag)
 #define pf_wipe(f)             flag_wipe(f, PF_SIZE)
 #define pf_setall(f)           flag_setall(f, PF_SIZE)
 #define pf_negate(f)           flag_negate(f, PF_SIZE)
@@ -612,7 +612,7 @@ typedef struct player {
     s16b equip_cnt;	/**< Number of items in equipment */
     s16b pack_size_reduce;	/**< Amount of space the quiver uses up. */
 
-    s16b health_who;	/**< Health bar trackee */
+    u32b health_who;	/**< Handle on the health bar trackee, or 0 */
 
     s16b monster_race_idx;		/**< Monster race trackee */
 
@@ -96,9 +96,11 @@ bool quest_check(const struct monster *m) {
 
 	/* Mark Sauron's other forms as dead */
 	if (((r_ptr->level == 85) || (r_ptr->level == 99))
-		&& rf_has(r_ptr->flags, RF_QUESTOR))
+		&& rf_has(r_ptr->flags, RF_QUESTOR)) {
 		for (i = 1; i < 4; i++)
 			r_info[m->r_idx - i].max_num--;
+		get_mon_num_forget();
+	}
 
 	/* Make a staircase for Morgoth (or Sauron) */
 	if ((r_ptr->level == 100) || (r_ptr->level == 99))
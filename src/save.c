@@ -926,7 +926,7 @@ void wr_dungeon(void)
 		for (y = 0; y < DUNGEON_HGT; y++) {
 			for (x = 0; x < DUNGEON_WID; x++) {
 				/* Extract the important cave_info flags */
-				tmp8u = cave_info[y][x][i];
+				tmp8u = square_get_byte(y, x, i);
 
 				/* If the run is broken, or too full, flush it */
 				if ((tmp8u != prev_char) || (count == MAX_UCHAR)) {
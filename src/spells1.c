@@ -87,6 +87,9 @@ s16b poly_r_idx(int base_idx, bool shapechange)
 
 
 
+	/* The alias table will no longer match the final probabilities */
+	get_mon_num_forget();
+
 	/* Reset sum of final monster probabilities. */
 	alloc_race_total = 0L;
 
@@ -241,7 +244,7 @@ void teleport_away(int m_idx, int dis)
 	monster_swap(oy, ox, ny, nx);
 
 	/* Clear the cave_temp flag (the "project()" code may have set it). */
-	sqinfo_off(cave_info[ny][nx], SQUARE_TEMP);
+	square_off(ny, nx, SQUARE_TEMP);
 }
 
 
@@ -523,7 +526,7 @@ static void thrust_away(int who, int t_y, int t_x, int grids_away)
 	}
 
 	/* Clear the cave_temp flag (the "project()" code may have set it). */
-	sqinfo_off(cave_info[y][x], SQUARE_TEMP);
+	square_off(y, x, SQUARE_TEMP);
 }
 
 /**
@@ -595,7 +598,7 @@ void teleport_player(int dis, bool safe)
 					continue;
 
 				/* No teleporting into vaults and such */
-				if (sqinfo_has(cave_info[y][x], SQUARE_ICKY))
+				if (square_has(y, x, SQUARE_ICKY))
 					continue;
 			} else {
 				/* Require any terrain capable of holding the player. */
@@ -671,7 +674,7 @@ void teleport_player(int dis, bool safe)
 	}
 
 	/* Clear the cave_temp flag (the "project()" code may have set it). */
-	sqinfo_off(cave_info[y][x], SQUARE_TEMP);
+	square_off(y, x, SQUARE_TEMP);
 
 	/* Handle stuff XXX XXX XXX */
 	if (safe)
@@ -840,7 +843,7 @@ void teleport_player_to(int ny, int nx, bool friendly)
 	}
 
 	/* Clear the cave_temp flag (the "project()" code may have set it). */
-	sqinfo_off(cave_info[y][x], SQUARE_TEMP);
+	square_off(y, x, SQUARE_TEMP);
 
 	/* Handle stuff XXX XXX XXX */
 	handle_stuff(p_ptr);
@@ -3193,17 +3196,17 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 		{
 			/* Mark the lava grid for (possible) later alteration */
 			if (tf_has(f_ptr->flags, TF_FIERY) && (dist <= 1))
-			   sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+			   square_on(y, x, SQUARE_TEMP);
             
             /* Mark the burning tree for (possible) later alteration */
             if (tf_has(f_ptr->flags, TF_BURNING))
-               sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+               square_on(y, x, SQUARE_TEMP);
                
             /* can make pools.  See "project_t()", */
             if (dist <= ((typ == GF_WATER) ? 4 : 1)) {
 				/* Mark the floor grid for (possible) later alteration. */
 				if (tf_has(f_ptr->flags, TF_FLOOR))
-					sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+					square_on(y, x, SQUARE_TEMP);
 			}
 			break;
 
@@ -3212,15 +3215,15 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 		{
 			/* Mark the lava grid for (possible) later alteration. */
 			if (tf_has(f_ptr->flags, TF_FREEZE) && (dist <= 1))
-				sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+				square_on(y, x, SQUARE_TEMP);
 			
 			/* Mark the water grid for (possible) later alteration. */
 			if (tf_has(f_ptr->flags, TF_WATERY))
-			   sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+			   square_on(y, x, SQUARE_TEMP);
 			   
             /* Mark the floor grid for (possible) later alteration. */
             if (tf_has(f_ptr->flags, TF_FLOOR))
-               sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+               square_on(y, x, SQUARE_TEMP);
                
 			break;
 		}
@@ -3230,7 +3233,7 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 		{
 			/* Mark the water grid for (possible) later alteration. */
 			if (tf_has(f_ptr->flags, TF_WATERY))
-			   sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+			   square_on(y, x, SQUARE_TEMP);
 			   break;
 		}
 
@@ -3242,12 +3245,12 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 		{
 			if (dist <= 1) {
 				/* Mark the grid for (possible) later alteration. */
-				sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+				square_on(y, x, SQUARE_TEMP);
 			}
 			/* Burning trees is easier */
 			else if (tf_has(f_ptr->flags, TF_TREE))
 			{
-				sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+				square_on(y, x, SQUARE_TEMP);
 			}
 			break;
 		}
@@ -3256,12 +3259,12 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 	case GF_SUN:
         {
         	if (tf_has(f_ptr->flags, TF_TREE))
-        	    sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+        	    square_on(y, x, SQUARE_TEMP);
      	    if (tf_has(f_ptr->flags, TF_WATERY))
-     	        sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+     	        square_on(y, x, SQUARE_TEMP);
      	        
  	        /* Turn on the light */
-			sqinfo_on(cave_info[y][x], SQUARE_GLOW);
+			square_on(y, x, SQUARE_GLOW);
 
 			/* Grid is in line of sight */
 			if (player_has_los_bold(y, x)) {
@@ -3281,7 +3284,7 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 			/* Don't alter chaos terrain - it's already the chaotic ideal */
 			if ((!tf_has(f_ptr->flags, TF_CHAOS)) && (dist <= 1)) {
 				/* Mark the grid for (possible) later alteration. */
-				sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+				square_on(y, x, SQUARE_TEMP);
 			}
 			break;
 		}
@@ -3290,9 +3293,9 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 	case GF_MAKE_HARMONY:
 		{
 			if(tf_has(f_ptr->flags, TF_FLOOR))
-			    sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+			    square_on(y, x, SQUARE_TEMP);
             if(tf_has(f_ptr->flags, TF_CHAOS))
-                sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+                square_on(y, x, SQUARE_TEMP);
             break;
         }
         
@@ -3351,7 +3354,7 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 				}
 
 				/* Forget the door */
-				sqinfo_off(cave_info[y][x], SQUARE_MARK);
+				square_off(y, x, SQUARE_MARK);
 
 				/* Destroy the feature */
 				if (outside)
@@ -3414,13 +3417,13 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 				/* Granite */
 				if (tf_has(f_ptr->flags, TF_GRANITE)) {
 					/* Message */
-					if (sqinfo_has(cave_info[y][x], SQUARE_MARK)) {
+					if (square_has(y, x, SQUARE_MARK)) {
 						msg("The wall turns into mud.");
 						obvious = TRUE;
 					}
 
 					/* Forget the wall */
-					sqinfo_off(cave_info[y][x], SQUARE_MARK);
+					square_off(y, x, SQUARE_MARK);
 
 					/* Destroy the wall */
 					if (outside)
@@ -3432,14 +3435,14 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 				/* Quartz / Magma with treasure */
 				else if (tf_has(f_ptr->flags, TF_GOLD)) {
 					/* Message */
-					if (sqinfo_has(cave_info[y][x], SQUARE_MARK)) {
+					if (square_has(y, x, SQUARE_MARK)) {
 						msg("The vein turns into mud.");
 						msg("You have found something!");
 						obvious = TRUE;
 					}
 
 					/* Forget the wall */
-					sqinfo_off(cave_info[y][x], SQUARE_MARK);
+					square_off(y, x, SQUARE_MARK);
 
 					/* Destroy the wall */
 					if (outside)
@@ -3455,13 +3458,13 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 				else if (tf_has(f_ptr->flags, TF_MAGMA) ||
 						 tf_has(f_ptr->flags, TF_QUARTZ)) {
 					/* Message */
-					if (sqinfo_has(cave_info[y][x], SQUARE_MARK)) {
+					if (square_has(y, x, SQUARE_MARK)) {
 						msg("The vein turns into mud.");
 						obvious = TRUE;
 					}
 
 					/* Forget the wall */
-					sqinfo_off(cave_info[y][x], SQUARE_MARK);
+					square_off(y, x, SQUARE_MARK);
 
 					/* Destroy the wall */
 					if (outside)
@@ -3473,13 +3476,13 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 				/* Rubble */
 				else if (tf_has(f_ptr->flags, TF_ROCK)) {
 					/* Message */
-					if (sqinfo_has(cave_info[y][x], SQUARE_MARK)) {
+					if (square_has(y, x, SQUARE_MARK)) {
 						msg("The rubble turns into mud.");
 						obvious = TRUE;
 					}
 
 					/* Forget the wall */
-					sqinfo_off(cave_info[y][x], SQUARE_MARK);
+					square_off(y, x, SQUARE_MARK);
 
 					/* Destroy the rubble */
 					if (outside)
@@ -3504,13 +3507,13 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 			/* Destroy doors (and secret doors) */
 			else if (tf_has(f_ptr->flags, TF_DOOR_ANY)) {
 				/* Hack -- special message */
-				if (sqinfo_has(cave_info[y][x], SQUARE_MARK)) {
+				if (square_has(y, x, SQUARE_MARK)) {
 					msg("The door turns into mud!");
 					obvious = TRUE;
 				}
 
 				/* Forget the wall */
-				sqinfo_off(cave_info[y][x], SQUARE_MARK);
+				square_off(y, x, SQUARE_MARK);
 
 				/* Destroy the feature */
 				if (outside)
@@ -3541,13 +3544,13 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 				/* Granite */
 				if (tf_has(f_ptr->flags, TF_GRANITE)) {
 					/* Message */
-					if (sqinfo_has(cave_info[y][x], SQUARE_MARK)) {
+					if (square_has(y, x, SQUARE_MARK)) {
 						msg("The wall turns into a tree.");
 						obvious = TRUE;
 					}
 
 					/* Forget the wall */
-					sqinfo_off(cave_info[y][x], SQUARE_MARK);
+					square_off(y, x, SQUARE_MARK);
 
 					/* Destroy the wall */
 					if (randint0(1))
@@ -3559,14 +3562,14 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 				/* Quartz / Magma with treasure */
 				else if (tf_has(f_ptr->flags, TF_GOLD)) {
 					/* Message */
-					if (sqinfo_has(cave_info[y][x], SQUARE_MARK)) {
+					if (square_has(y, x, SQUARE_MARK)) {
 						msg("A tree bursts from the vein.");
 						msg("You have found something!");
 						obvious = TRUE;
 					}
 
 					/* Forget the wall */
-					sqinfo_off(cave_info[y][x], SQUARE_MARK);
+					square_off(y, x, SQUARE_MARK);
 
 					/* Destroy the wall */
 					if (randint0(1))
@@ -3582,13 +3585,13 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 				else if (tf_has(f_ptr->flags, TF_MAGMA) ||
 						 tf_has(f_ptr->flags, TF_QUARTZ)) {
 					/* Message */
-					if (sqinfo_has(cave_info[y][x], SQUARE_MARK)) {
+					if (square_has(y, x, SQUARE_MARK)) {
 						msg("Roots burst from the vein and grow to a tree.");
 						obvious = TRUE;
 					}
 
 					/* Forget the wall */
-					sqinfo_off(cave_info[y][x], SQUARE_MARK);
+					square_off(y, x, SQUARE_MARK);
 
 					/* Destroy the wall */
 					if (randint0(1))
@@ -3600,13 +3603,13 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 				/* Rubble */
 				else if (tf_has(f_ptr->flags, TF_ROCK)) {
 					/* Message */
-					if (sqinfo_has(cave_info[y][x], SQUARE_MARK)) {
+					if (square_has(y, x, SQUARE_MARK)) {
 						msg("A tree grows out of the rubble.");
 						obvious = TRUE;
 					}
 
 					/* Forget the wall */
-					sqinfo_off(cave_info[y][x], SQUARE_MARK);
+					square_off(y, x, SQUARE_MARK);
 
 					/* Destroy the rubble */
 					if (randint0(1))
@@ -3631,13 +3634,13 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 			/* Destroy doors (and secret doors) */
 			else if (tf_has(f_ptr->flags, TF_DOOR_ANY)) {
 				/* Hack -- special message */
-				if (sqinfo_has(cave_info[y][x], SQUARE_MARK)) {
+				if (square_has(y, x, SQUARE_MARK)) {
 					msg("The wooden door grows back into a tree!");
 					obvious = TRUE;
 				}
 
 				/* Forget the wall */
-				sqinfo_off(cave_info[y][x], SQUARE_MARK);
+				square_off(y, x, SQUARE_MARK);
 
 				/* Destroy the feature */
 				if (randint0(1))
@@ -3666,7 +3669,7 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 			cave_set_feat(y, x, FEAT_DOOR_HEAD + 0x00);
 
 			/* Observe */
-			if (sqinfo_has(cave_info[y][x], SQUARE_MARK))
+			if (square_has(y, x, SQUARE_MARK))
 				obvious = TRUE;
 
 			/* Update the visuals */
@@ -3694,14 +3697,14 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
     		if (tf_has(f_ptr->flags, TF_TREE))
     		{
     			/* Message */
-    			if (sqinfo_has(cave_info[y][x], SQUARE_MARK))
+    			if (square_has(y, x, SQUARE_MARK))
     			{
 				    msg("The tree turns to stone and blocks the path.");
 				    obvious = TRUE;
 				}
 				
 				/* Forget the tree */
-				sqinfo_off(cave_info[y][x], SQUARE_MARK);
+				square_off(y, x, SQUARE_MARK);
 				
 				/* Destroy the tree */
 				cave_set_feat(y, x, FEAT_WALL_SOLID);
@@ -3722,7 +3725,7 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 				msg("You cast a binding spell on the door.");
 
 				/* Hack - maximum jamming. */
-				cave_feat[y][x] = FEAT_DOOR_TAIL;
+				cave_set_feat(y, x, FEAT_DOOR_TAIL);
 			}
 		}
 
@@ -3731,7 +3734,7 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 	case GF_LIGHT:
 		{
 			/* Turn on the light */
-			sqinfo_on(cave_info[y][x], SQUARE_GLOW);
+			square_on(y, x, SQUARE_GLOW);
 
 			/* Grid is in line of sight */
 			if (player_has_los_bold(y, x)) {
@@ -3751,13 +3754,13 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 	case GF_DARK:
 		{
 			/* Turn off the light */
-			sqinfo_off(cave_info[y][x], SQUARE_GLOW);
+			square_off(y, x, SQUARE_GLOW);
 
 			/* Hack -- Forget "boring" grids */
 			if (tf_has(f_ptr->flags, TF_FLOOR)
-				&& !sqinfo_has(cave_info[y][x], SQUARE_TRAP)) {
+				&& !square_has(y, x, SQUARE_TRAP)) {
 				/* Forget */
-				sqinfo_off(cave_info[y][x], SQUARE_MARK);
+				square_off(y, x, SQUARE_MARK);
 			}
 
 			/* Grid is in line of sight */
@@ -3780,11 +3783,11 @@ static bool project_f(int who, int y, int x, int dist, int dam, int typ)
 		{
 			if(tf_has(f_ptr->flags, TF_FLOOR))
 			{
-				if(sqinfo_has(cave_info[y][x], SQUARE_MARK))
+				if(square_has(y, x, SQUARE_MARK))
 				    obvious = TRUE;
                 
                 /* Replace the empty square */
-                sqinfo_off(cave_info[y][x], SQUARE_MARK);
+                square_off(y, x, SQUARE_MARK);
                 cave_set_feat(y, x, FEAT_WIND);
                 
             }
@@ -4942,7 +4945,7 @@ static bool project_m(int who, int y, int x, u32b dam, int typ, int flg)
     		if (seen)
     		    obvious = TRUE;
 		    /* Square must be lit */
-		    if (!sqinfo_has(cave_info[y][x], SQUARE_GLOW))
+		    if (!square_has(y, x, SQUARE_GLOW))
 		       dam = 0;
  		   
  		   /* Damage is light based */
@@ -5044,7 +5047,7 @@ static bool project_m(int who, int y, int x, u32b dam, int typ, int flg)
 			}
 
 			/* Mark grid for later processing. */
-			sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+			square_on(y, x, SQUARE_TEMP);
 
 			break;
 		}
@@ -5065,7 +5068,7 @@ static bool project_m(int who, int y, int x, u32b dam, int typ, int flg)
 			}
 
 			/* Mark grid for later processing. */
-			sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+			square_on(y, x, SQUARE_TEMP);
 
 			break;
 		}
@@ -5095,7 +5098,7 @@ static bool project_m(int who, int y, int x, u32b dam, int typ, int flg)
 			}
 
 			/* Mark grid for later processing. */
-			sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+			square_on(y, x, SQUARE_TEMP);
 
 			break;
 		}
@@ -5159,7 +5162,7 @@ static bool project_m(int who, int y, int x, u32b dam, int typ, int flg)
 			}
 
 			/* Mark grid for later processing. */
-			sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+			square_on(y, x, SQUARE_TEMP);
 
 			break;
 		}
@@ -5179,7 +5182,7 @@ static bool project_m(int who, int y, int x, u32b dam, int typ, int flg)
 			}
 
 			/* Mark grid for later processing. */
-			sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+			square_on(y, x, SQUARE_TEMP);
 
 			break;
 		}
@@ -5226,7 +5229,7 @@ static bool project_m(int who, int y, int x, u32b dam, int typ, int flg)
 			}
 
 			/* Mark grid for later processing. */
-			sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+			square_on(y, x, SQUARE_TEMP);
 
 			break;
 		}
@@ -5405,7 +5408,7 @@ static bool project_m(int who, int y, int x, u32b dam, int typ, int flg)
 	                p_ptr->alignment++;
 	                
                 /* Redraw (later) is needed */
-                if (p_ptr->health_who == cave_m_idx[y][x])
+                if (health_tracked() == cave_m_idx[y][x])
                     p_ptr->redraw |= (PR_HEALTH);
                 
                 /* Message */
@@ -5450,7 +5453,7 @@ static bool project_m(int who, int y, int x, u32b dam, int typ, int flg)
 	                p_ptr->alignment++;
 	                
                 /* Redraw (later) is needed */
-                if (p_ptr->health_who == cave_m_idx[y][x])
+                if (health_tracked() == cave_m_idx[y][x])
                     p_ptr->redraw |= (PR_HEALTH);
                 
                 /* Message */
@@ -5490,7 +5493,7 @@ static bool project_m(int who, int y, int x, u32b dam, int typ, int flg)
         	    p_ptr->alignment++;
         	    
         	    /* Redraw later, if needed */
-        	    if (p_ptr->health_who == cave_m_idx[y][x])
+        	    if (health_tracked() == cave_m_idx[y][x])
         	        p_ptr->redraw |= (PR_HEALTH);
     	        
     	        /* No "real" damage */
@@ -5686,7 +5689,7 @@ static bool project_m(int who, int y, int x, u32b dam, int typ, int flg)
 			    p_ptr->alignment++;
             
             /* Redraw (later) if needed */
-			if (p_ptr->health_who == cave_m_idx[y][x])
+			if (health_tracked() == cave_m_idx[y][x])
 				p_ptr->redraw |= (PR_HEALTH);
 
 			/* Message */
@@ -6409,7 +6412,7 @@ static bool project_m(int who, int y, int x, u32b dam, int typ, int flg)
 	case GF_AWAY_UNDEAD:
 		{
 			/* Mark grid for later processing. */
-			sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+			square_on(y, x, SQUARE_TEMP);
 
 			/* No damage */
 			dam = 0;
@@ -6421,7 +6424,7 @@ static bool project_m(int who, int y, int x, u32b dam, int typ, int flg)
 	case GF_AWAY_EVIL:
 		{
 			/* Mark grid for later processing. */
-			sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+			square_on(y, x, SQUARE_TEMP);
 
 			/* No damage */
 			dam = 0;
@@ -6434,7 +6437,7 @@ static bool project_m(int who, int y, int x, u32b dam, int typ, int flg)
 	case GF_AWAY_ALL:
 		{
 			/* Mark grid for later processing. */
-			sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+			square_on(y, x, SQUARE_TEMP);
 
 			/* No damage */
 			dam = 0;
@@ -6927,7 +6930,7 @@ static bool project_m(int who, int y, int x, u32b dam, int typ, int flg)
       	        }
       	        
       	        /* Ignore monsters in icky squares */
-				if (sqinfo_has(cave_info[m_ptr->fy][m_ptr->fx], SQUARE_ICKY))
+				if (square_has(m_ptr->fy, m_ptr->fx, SQUARE_ICKY))
 				{
 					note = " is beyond your ability to affect it.";
 					obvious = FALSE;
@@ -7306,7 +7309,7 @@ static bool project_m(int who, int y, int x, u32b dam, int typ, int flg)
 	/* If another monster did the damage, hurt the monster by hand */
 	if (who > 0) {
 		/* Redraw (later) if needed */
-		if (p_ptr->health_who == cave_m_idx[y][x])
+		if (health_tracked() == cave_m_idx[y][x])
 			p_ptr->redraw |= (PR_HEALTH);
 
 		/* Wake the monster up */
@@ -7577,7 +7580,7 @@ static bool project_p(int who, int d, int y, int x, int dam, int typ)
 	}
 
 	/* Hack - Darkness protects those who serve it. */
-	if (!sqinfo_has(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW)
+	if (!square_has(p_ptr->py, p_ptr->px, SQUARE_GLOW)
 		&& (!is_daylight)
 		&& (p_ptr->cur_light <= 0) && (player_has(PF_UNLIGHT)))
 		terrain_adjustment -= dam / 4;
@@ -8288,7 +8291,7 @@ static bool project_p(int who, int d, int y, int x, int dam, int typ)
 		/* Brighten -- as light, but only on lit squares */
     case GF_BRIGHTEN:
     	{
-    		if(!sqinfo_has(cave_info[y][x], SQUARE_GLOW))
+    		if(!square_has(y, x, SQUARE_GLOW))
     		{
     			dam = 0;
     			break;
@@ -8610,7 +8613,7 @@ static bool project_p(int who, int d, int y, int x, int dam, int typ)
 			take_hit(dam, killer, who);
 
 			/* Mark grid for later processing. */
-			sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+			square_on(y, x, SQUARE_TEMP);
 
 			break;
 		}
@@ -8655,7 +8658,7 @@ static bool project_p(int who, int d, int y, int x, int dam, int typ)
 			take_hit(dam, killer, who);
 
 			/* Mark grid for later processing. */
-			sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+			square_on(y, x, SQUARE_TEMP);
 
 			break;
 		}
@@ -8732,7 +8735,7 @@ static bool project_p(int who, int d, int y, int x, int dam, int typ)
 				notice_other(IF_RES_CONFU, 0);
 
 			/* Mark grid for later processing. */
-			sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+			square_on(y, x, SQUARE_TEMP);
 
 			break;
 		}
@@ -8749,7 +8752,7 @@ static bool project_p(int who, int d, int y, int x, int dam, int typ)
 			take_hit(dam, killer, who);
 
 			/* Mark grid for later processing. */
-			sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+			square_on(y, x, SQUARE_TEMP);
 
 			break;
 		}
@@ -8799,7 +8802,7 @@ static bool project_p(int who, int d, int y, int x, int dam, int typ)
 			take_hit(dam, killer, who);
 
 			/* Mark grid for later processing. */
-			sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+			square_on(y, x, SQUARE_TEMP);
 
 			break;
 		}
@@ -8967,7 +8970,7 @@ static bool project_p(int who, int d, int y, int x, int dam, int typ)
 			}
 
 			/* Mark grid for later processing. */
-			sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+			square_on(y, x, SQUARE_TEMP);
 
 			/* Drain Exp */
 			if (!p_resist_good(P_RES_CHAOS) || !p_resist_good(P_RES_NETHR)) {
@@ -9086,11 +9089,11 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
 	const char *note = NULL;
 
 	/* Only process marked grids. */
-	if (!sqinfo_has(cave_info[y][x], SQUARE_TEMP))
+	if (!square_has(y, x, SQUARE_TEMP))
 		return (FALSE);
 
 	/* Clear the cave_temp flag. */
-	sqinfo_off(cave_info[y][x], SQUARE_TEMP);
+	square_off(y, x, SQUARE_TEMP);
 
 
 	/* Projection will be affecting a player. */
@@ -9134,7 +9137,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
 				if (tf_has(f_ptr->flags, TF_FIERY)) {
 
 					/* Forget the lava */
-					sqinfo_off(cave_info[y][x], SQUARE_MARK);
+					square_off(y, x, SQUARE_MARK);
 
 					/* Destroy the lava */
 					if (randint1(3) != 1) {
@@ -9160,7 +9163,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
     			if (dam > randint1(900) + 300)
     			{
     				/* Forget the lava */
-    				sqinfo_off(cave_info[y][x], SQUARE_MARK);
+    				square_off(y, x, SQUARE_MARK);
     				
     				/* Destroy the lava */
     				if (randint1(3) != 1)
@@ -9181,7 +9184,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
 	        	if (dam > randint1(30) + 10)
 	        	{
 	        		/* Forget the water */
-	        		sqinfo_off(cave_info[y][x], SQUARE_MARK);
+	        		square_off(y, x, SQUARE_MARK);
 	        		
 	        		/* Replace the water */
 	        		cave_set_feat(y, x, FEAT_ICE);
@@ -9195,7 +9198,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
 	        	if (dam > randint1(80))
 	        	{
 	        		/* Forget the floor */
-	        		sqinfo_off(cave_info[y][x], SQUARE_MARK);
+	        		square_off(y, x, SQUARE_MARK);
 	        		
 	        		/* Replace the floor */
 	        		cave_set_feat(y, x, FEAT_ICE);
@@ -9217,7 +9220,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
 					|| (cave_feat[y][x] == FEAT_RUBBLE)) {
 
 					/* Forget the floor or rubble. */
-					sqinfo_off(cave_info[y][x], SQUARE_MARK);
+					square_off(y, x, SQUARE_MARK);
 
 					/* Make lava. */
 					cave_set_feat(y, x, FEAT_LAVA);
@@ -9244,7 +9247,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
 				 * evaporate, as Smaug found out the hard way. */
 				if (dam > randint1(600 + k * 300) + 200) {
 					/* Forget the water */
-					sqinfo_off(cave_info[y][x], SQUARE_MARK);
+					square_off(y, x, SQUARE_MARK);
 
 					/* Destroy the water */
 					if (outside)
@@ -9258,7 +9261,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
 			if ((tf_has(f_ptr->flags, TF_TREE)) &&
 				(dam > randint1(300) + 10)) {
 				/* Forget the tree */
-				sqinfo_off(cave_info[y][x], SQUARE_MARK);
+				square_off(y, x, SQUARE_MARK);
 
 				/* Burn the tree */
 				cave_set_feat(y, x, FEAT_TREE_BURN);
@@ -9276,7 +9279,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
 				if (dam > randint1(50) + 30)
 				{
 					/* Forget the ice */
-					sqinfo_off(cave_info[y][x], SQUARE_MARK);
+					square_off(y, x, SQUARE_MARK);
 					
 					/* Melt the ice */
 					cave_set_feat(y, x, FEAT_WATER);
@@ -9293,7 +9296,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
 			if ((tf_has(f_ptr->flags, TF_TREE)) &&
 				(dam > randint1(300) + 100)) {
 				/* Forget the tree */
-				sqinfo_off(cave_info[y][x], SQUARE_MARK);
+				square_off(y, x, SQUARE_MARK);
 
 				/* Burn the tree */
 				cave_set_feat(y, x, FEAT_TREE_BURN);
@@ -9317,7 +9320,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
 				/* Water isn't easy to evaporate */
 				if (dam > randint1(600 + k * 300) + 250) {
 					/* Forget the water */
-					sqinfo_off(cave_info[y][x], SQUARE_MARK);
+					square_off(y, x, SQUARE_MARK);
 
 					/* Destroy the water */
 					if (outside)
@@ -9333,7 +9336,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
 				if (dam > randint1(60) + 40)
 				{
 					/* Forget the ice */
-					sqinfo_off(cave_info[y][x], SQUARE_MARK);
+					square_off(y, x, SQUARE_MARK);
 					
 					/* Melt the ice */
 					cave_set_feat(y, x, FEAT_WATER);
@@ -9341,7 +9344,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
 			}
 			
 			/* Light the square */
-			sqinfo_on(cave_info[y][x], SQUARE_GLOW);
+			square_on(y, x, SQUARE_GLOW);
 			
 			break;
 		}
@@ -9441,7 +9444,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
 				/* If enough water available, make pool. */
 				if ((dam + (k * 20)) > 40 + (randint0(300))) {
 					/* Forget the floor */
-					sqinfo_off(cave_info[y][x], SQUARE_MARK);
+					square_off(y, x, SQUARE_MARK);
 
 					/* Create water */
 					cave_set_feat(y, x, FEAT_WATER);
@@ -9456,7 +9459,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
     			if (dam > randint1(900) + 300 - ((typ == GF_WATER) ? 200 : 0))
     			{
     				/* Forget the lava */
-    				sqinfo_off(cave_info[y][x], SQUARE_MARK);
+    				square_off(y, x, SQUARE_MARK);
     				
     				/* Destroy the lava */
     				if (randint1(3) != 1)
@@ -9481,7 +9484,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
     			if (randint1(2) == 1)
     			{
     				/* Forget the floor */
-    				sqinfo_off(cave_info[y][x], SQUARE_MARK);
+    				square_off(y, x, SQUARE_MARK);
     				
     				/* Create the wind */
     				cave_set_feat(y, x, FEAT_WIND);
@@ -9545,7 +9548,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
 				if(tf_has(f_ptr->flags, TF_HARMONY))
 				{
 					/* Remove Harmony terrain */
-					sqinfo_off(cave_info[y][x], SQUARE_MARK);
+					square_off(y, x, SQUARE_MARK);
 					cave_set_feat(y, x, FEAT_FLOOR);
 				}
 
@@ -9637,7 +9640,7 @@ static bool project_t(int who, int y, int x, int dam, int typ, int flg)
     		/* Consistently makes Harmonious Terrain */
     		if (tf_has(f_ptr->flags, TF_FLOOR))
     		{
-    			sqinfo_off(cave_info[y][x], SQUARE_MARK);
+    			square_off(y, x, SQUARE_MARK);
     			cave_set_feat(y, x, FEAT_HARMONY);
     		}
     		break;
@@ -10011,11 +10014,10 @@ bool project(int who, int rad, int source_y, int source_x, int y, int x, int dam
 
 				int ny = GRID_Y(path_g[i]);
 				int nx = GRID_X(path_g[i]);
-				feature_type *f_ptr = &f_info[cave_feat[ny][nx]];
 
 
 				/* Hack -- Balls explode before reaching walls. */
-				if (!tf_has(f_ptr->flags, TF_PASSABLE) && (rad > 0))
+				if (!cave_passable(ny, nx) && (rad > 0))
 					break;
 
 				/* Advance */
@@ -10141,7 +10143,7 @@ bool project(int who, int rad, int source_y, int source_x, int y, int x, int dam
 		 */
 		for (y = y0 - rad; y <= y0 + rad; y++) {
 			for (x = x0 - rad; x <= x0 + rad; x++) {
-				feature_type *f_ptr = &f_info[cave_feat[y][x]];
+				feature_type *f_ptr;
 
 				/* Center grid has already been stored. */
 				if ((y == y0) && (x == x0))
@@ -10155,6 +10157,8 @@ bool project(int who, int rad, int source_y, int source_x, int y, int x, int dam
 				if (!in_bounds(y, x))
 					continue;
 
+				f_ptr = &f_info[cave_feat[y][x]];
+
 				/* Some explosions are allowed to affect one layer of walls */
 				/* All explosions can affect one layer of rubble or trees -BR- */
 				if ((flg & (PROJECT_THRU)) ||
@@ -10454,7 +10458,7 @@ bool project(int who, int rad, int source_y, int source_x, int y, int x, int dam
 		x = gx[i];
 
 		/* Grid must be marked. */
-		if (!sqinfo_has(cave_info[y][x], SQUARE_TEMP))
+		if (!square_has(y, x, SQUARE_TEMP))
 			continue;
 
 		/* Affect marked grid */
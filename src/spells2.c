@@ -522,7 +522,7 @@ void dimen_door(void)
 	/* Test for empty floor, forbid vaults or too large a distance, and insure
 	 * that this spell is never certain. */
 	if (!cave_empty_bold(ny, nx)
-		|| sqinfo_has(cave_info[ny][nx], SQUARE_ICKY)
+		|| square_has(ny, nx, SQUARE_ICKY)
 		|| (distance(ny, nx, p_ptr->py, p_ptr->px) > 25)
 		|| (randint0(p_ptr->lev) == 0)) {
 		msg("You fail to exit the astral plane correctly!");
@@ -568,7 +568,7 @@ void dimen_door_los(void)
 	/* Test for empty floor, forbid vaults or too large a distance, and insure
 	 * that this spell is never certain. */
 	if (!cave_empty_bold(ny, nx)
-		|| sqinfo_has(cave_info[ny][nx], SQUARE_ICKY)
+		|| square_has(ny, nx, SQUARE_ICKY)
 		|| (distance(ny, nx, p_ptr->py, p_ptr->px) > 25)
 		|| (randint0(p_ptr->lev) == 0)) {
 		msg("You fail to exit the astral plane correctly!");
@@ -611,8 +611,8 @@ void wood_walk(void)
 	    /* Test for a tree */
 		/* Only trees the player is aware of count */
 	    inTree = (tf_has(f_ptr->flags, TF_TREE) 
-			&& ((sqinfo_has(cave_info[ny][nx], SQUARE_SEEN))
-			|| (sqinfo_has(cave_info[ny][nx], SQUARE_MARK))));
+			&& ((square_has(ny, nx, SQUARE_SEEN))
+			|| (square_has(ny, nx, SQUARE_MARK))));
 	    if(!inTree)
 	    {
 		    bell("You can only exit at a tree!");
@@ -623,7 +623,7 @@ void wood_walk(void)
 	/* Test for empty floor, forbid vaults or too large a distance, and insure
 	 * that this spell is never certain. */
 	if (!cave_empty_bold(ny, nx)
-		|| sqinfo_has(cave_info[ny][nx], SQUARE_ICKY)
+		|| square_has(ny, nx, SQUARE_ICKY)
 		|| (distance(ny, nx, p_ptr->py, p_ptr->px) > 25)
 		|| (randint0(p_ptr->lev) == 0)) {
 		msg("You fail to exit the astral plane correctly!");
@@ -813,13 +813,13 @@ void magic_spiking(void)
 
 		/* Convert "locked" to "stuck" XXX XXX XXX */
 		if (!tf_has(f_ptr->flags, TF_DOOR_JAMMED)) {
-			cave_feat[y][x] += 0x08;
+			cave_set_feat(y, x, cave_feat[y][x] + 0x08);
 		}
 
 		/* Add three magical spikes to the door. */
 		for (i = 0; i < 3; i++) {
 			if (cave_feat[y][x] != FEAT_DOOR_TAIL) {
-				cave_feat[y][x] += 0x01;
+				cave_set_feat(y, x, cave_feat[y][x] + 0x01);
 			}
 		}
 	}
@@ -1761,7 +1761,7 @@ bool detect_traps(int range, bool show)
 					detect = TRUE;
 
 				/* Mark grid as detected */
-				sqinfo_on(cave_info[y][x], SQUARE_DTRAP);
+				square_on(y, x, SQUARE_DTRAP);
 			}
 		}
 	}
@@ -1775,9 +1775,9 @@ bool detect_traps(int range, bool show)
 
 				/* see if this grid is on the edge */
 				if (dtrap_edge(y, x)) {
-					sqinfo_on(cave_info[y][x], SQUARE_DEDGE);
+					square_on(y, x, SQUARE_DEDGE);
 				} else {
-					sqinfo_off(cave_info[y][x], SQUARE_DEDGE);
+					square_off(y, x, SQUARE_DEDGE);
 				}
 				
 				/* Redraw */
@@ -1839,7 +1839,7 @@ bool detect_doors(int range, bool show)
 				/* Detect doors */
 				if (tf_has(f_ptr->flags, TF_DOOR_ANY)) {
 					/* Hack -- Memorize */
-					sqinfo_on(cave_info[y][x], SQUARE_MARK);
+					square_on(y, x, SQUARE_MARK);
 
 					/* Redraw */
 					light_spot(y, x);
@@ -1897,7 +1897,7 @@ bool detect_stairs(int range, bool show)
 				if (tf_has(f_ptr->flags, TF_STAIR) ||
 					tf_has(f_ptr->flags, TF_PATH)) {
 					/* Hack -- Memorize */
-					sqinfo_on(cave_info[y][x], SQUARE_MARK);
+					square_on(y, x, SQUARE_MARK);
 
 					/* Redraw */
 					light_spot(y, x);
@@ -1951,20 +1951,20 @@ bool detect_treasure(int range, bool show)
 				/* Notice embedded gold */
 				if (cave_feat[y][x] == FEAT_MAGMA_H) {
 					/* Expose the gold */
-					cave_feat[y][x] = FEAT_MAGMA_K;
+					cave_set_feat(y, x, FEAT_MAGMA_K);
 				}
 
 				/* Notice embedded gold */
 				if (cave_feat[y][x] == FEAT_QUARTZ_H) {
 					/* Expose the gold */
-					cave_feat[y][x] = FEAT_QUARTZ_K;
+					cave_set_feat(y, x, FEAT_QUARTZ_K);
 				}
 
 				/* Magma/Quartz + Known Gold */
 				if ((cave_feat[y][x] == FEAT_MAGMA_K)
 					|| (cave_feat[y][x] == FEAT_QUARTZ_K)) {
 					/* Hack -- Memorize */
-					sqinfo_on(cave_info[y][x], SQUARE_MARK);
+					square_on(y, x, SQUARE_MARK);
 
 					/* Redraw */
 					light_spot(y, x);
@@ -2211,12 +2211,38 @@ bool detect_objects_magic(int range, bool show)
 }
 
 
+/**
+ * List the monsters within range of the player for detection in temp_m_idx,
+ * setting n to the number listed, and return the list.
+ *
+ * When the monster index would not beat it, return NULL, with n set to
+ * m_max, and the caller scans the whole monster list itself, as detection
+ * always used to, rather than have it scanned once to build the list and
+ * the list read again.
+ */
+static s16b *detect_monster_list(int range, int *n)
+{
+	int py = p_ptr->py;
+	int px = p_ptr->px;
+
+	if (monster_near_scan(py, px, range)) {
+		*n = m_max;
+		return (NULL);
+	}
+
+	*n = monster_near_list(py, px, range, MON_ANY_FACTION, temp_m_idx);
+	return (temp_m_idx);
+}
+
+
 /**
  * Detect all "normal" monsters within range
  */
 bool detect_monsters_normal(int range, bool show)
 {
-	int i, y, x;
+	int i, j, n, y, x;
+
+	s16b *who;
 
 	int py = p_ptr->py;
 	int px = p_ptr->px;
@@ -2230,23 +2256,34 @@ bool detect_monsters_normal(int range, bool show)
 	if (show)
 		animate_detect(range);
 
-	/* Scan monsters */
-	for (i = 1; i < m_max; i++) {
-		monster_type *m_ptr = &m_list[i];
-		monster_race *r_ptr = &r_info[m_ptr->r_idx];
+	/* Scan monsters in range */
+	who = detect_monster_list(range, &n);
+	for (j = 0; j < n; j++) {
+		monster_type *m_ptr;
+		monster_race *r_ptr;
 
-		/* Skip dead monsters */
-		if (!m_ptr->r_idx)
-			continue;
+		/* Take the next monster in range */
+		if (who) {
+			i = who[j];
+		} else {
+			i = j;
+
+			/* Skip dead monsters */
+			if (!m_list[i].r_idx)
+				continue;
+
+			/* Check range */
+			if (distance(py, px, m_list[i].fy, m_list[i].fx) > range)
+				continue;
+		}
+
+		m_ptr = &m_list[i];
+		r_ptr = &r_info[m_ptr->r_idx];
 
 		/* Location */
 		y = m_ptr->fy;
 		x = m_ptr->fx;
 
-		/* check range */
-		if (distance(py, px, y, x) > range)
-			continue;
-
 		/* Detect all non-invisible monsters */
 		if (!(rf_has(r_ptr->flags, RF_INVISIBLE))) {
 			/* Optimize -- Repair flags */
@@ -2291,7 +2328,9 @@ bool detect_monsters_normal(int range, bool show)
  */
 bool detect_monsters_invis(int range, bool show)
 {
-	int i, y, x;
+	int i, j, n, y, x;
+
+	s16b *who;
 
 	int py = p_ptr->py;
 	int px = p_ptr->px;
@@ -2305,24 +2344,36 @@ bool detect_monsters_invis(int range, bool show)
 	if (show)
 		animate_detect(range);
 
-	/* Scan monsters */
-	for (i = 1; i < m_max; i++) {
-		monster_type *m_ptr = &m_list[i];
-		monster_race *r_ptr = &r_info[m_ptr->r_idx];
-		monster_lore *l_ptr = &l_list[m_ptr->r_idx];
+	/* Scan monsters in range */
+	who = detect_monster_list(range, &n);
+	for (j = 0; j < n; j++) {
+		monster_type *m_ptr;
+		monster_race *r_ptr;
+		monster_lore *l_ptr;
 
-		/* Skip dead monsters */
-		if (!m_ptr->r_idx)
-			continue;
+		/* Take the next monster in range */
+		if (who) {
+			i = who[j];
+		} else {
+			i = j;
+
+			/* Skip dead monsters */
+			if (!m_list[i].r_idx)
+				continue;
+
+			/* Check range */
+			if (distance(py, px, m_list[i].fy, m_list[i].fx) > range)
+				continue;
+		}
+
+		m_ptr = &m_list[i];
+		r_ptr = &r_info[m_ptr->r_idx];
+		l_ptr = &l_list[m_ptr->r_idx];
 
 		/* Location */
 		y = m_ptr->fy;
 		x = m_ptr->fx;
 
-		/* check range */
-		if (distance(py, px, y, x) > range)
-			continue;
-
 		/* Detect invisible monsters */
 		if (rf_has(r_ptr->flags, RF_INVISIBLE)) {
 			/* Take note that they are invisible */
@@ -2377,7 +2428,9 @@ bool detect_monsters_invis(int range, bool show)
  */
 bool detect_monsters_evil(int range, bool show)
 {
-	int i, y, x;
+	int i, j, n, y, x;
+
+	s16b *who;
 
 	int py = p_ptr->py;
 	int px = p_ptr->px;
@@ -2391,24 +2444,36 @@ bool detect_monsters_evil(int range, bool show)
 	if (show)
 		animate_detect(range);
 
-	/* Scan monsters */
-	for (i = 1; i < m_max; i++) {
-		monster_type *m_ptr = &m_list[i];
-		monster_race *r_ptr = &r_info[m_ptr->r_idx];
-		monster_lore *l_ptr = &l_list[m_ptr->r_idx];
+	/* Scan monsters in range */
+	who = detect_monster_list(range, &n);
+	for (j = 0; j < n; j++) {
+		monster_type *m_ptr;
+		monster_race *r_ptr;
+		monster_lore *l_ptr;
 
-		/* Skip dead monsters */
-		if (!m_ptr->r_idx)
-			continue;
+		/* Take the next monster in range */
+		if (who) {
+			i = who[j];
+		} else {
+			i = j;
+
+			/* Skip dead monsters */
+			if (!m_list[i].r_idx)
+				continue;
+
+			/* Check range */
+			if (distance(py, px, m_list[i].fy, m_list[i].fx) > range)
+				continue;
+		}
+
+		m_ptr = &m_list[i];
+		r_ptr = &r_info[m_ptr->r_idx];
+		l_ptr = &l_list[m_ptr->r_idx];
 
 		/* Location */
 		y = m_ptr->fy;
 		x = m_ptr->fx;
 
-		/* check range */
-		if (distance(py, px, y, x) > range)
-			continue;
-
 		/* Detect evil monsters */
 		if (rf_has(r_ptr->flags, RF_EVIL)) {
 			/* Take note that they are evil */
@@ -2465,7 +2530,9 @@ bool detect_monsters_evil(int range, bool show)
  */
 bool detect_monsters_living(int range, bool show)
 {
-	int i, y, x;
+	int i, j, n, y, x;
+
+	s16b *who;
 
 	int py = p_ptr->py;
 	int px = p_ptr->px;
@@ -2479,23 +2546,34 @@ bool detect_monsters_living(int range, bool show)
 	if (show)
 		animate_detect(range);
 
-	/* Scan monsters */
-	for (i = 1; i < m_max; i++) {
-		monster_type *m_ptr = &m_list[i];
-		monster_race *r_ptr = &r_info[m_ptr->r_idx];
+	/* Scan monsters in range */
+	who = detect_monster_list(range, &n);
+	for (j = 0; j < n; j++) {
+		monster_type *m_ptr;
+		monster_race *r_ptr;
 
-		/* Skip dead monsters */
-		if (!m_ptr->r_idx)
-			continue;
+		/* Take the next monster in range */
+		if (who) {
+			i = who[j];
+		} else {
+			i = j;
+
+			/* Skip dead monsters */
+			if (!m_list[i].r_idx)
+				continue;
+
+			/* Check range */
+			if (distance(py, px, m_list[i].fy, m_list[i].fx) > range)
+				continue;
+		}
+
+		m_ptr = &m_list[i];
+		r_ptr = &r_info[m_ptr->r_idx];
 
 		/* Location */
 		y = m_ptr->fy;
 		x = m_ptr->fx;
 
-		/* check range */
-		if (distance(py, px, y, x) > range)
-			continue;
-
 		/* Hack -- Detect all living monsters. */
 		if ((!strchr("Egv", r_ptr->d_char))
 			&& (!(rf_has(r_ptr->flags, RF_UNDEAD)))) {
@@ -2550,7 +2628,7 @@ bool detect_monsters_living(int range, bool show)
 			/* Notice trees */
 			if (tf_has(f_ptr->flags, TF_TREE)) {
 				/* Mark it */
-				sqinfo_on(cave_info[y][x], SQUARE_MARK);
+				square_on(y, x, SQUARE_MARK);
 
 				/* Count it */
 				num++;
@@ -2581,7 +2659,9 @@ bool detect_monsters_living(int range, bool show)
  */
 bool detect_monsters_undead(int range, bool show)
 {
-	int i, y, x;
+	int i, j, n, y, x;
+
+	s16b *who;
 
 	int py = p_ptr->py;
 	int px = p_ptr->px;
@@ -2595,22 +2675,34 @@ bool detect_monsters_undead(int range, bool show)
 	if (show)
 		animate_detect(range);
 
-	/* Scan monsters */
-	for (i = 1; i < m_max; i++) {
-		monster_type *m_ptr = &m_list[i];
-		monster_race *r_ptr = &r_info[m_ptr->r_idx];
+	/* Scan monsters in range */
+	who = detect_monster_list(range, &n);
+	for (j = 0; j < n; j++) {
+		monster_type *m_ptr;
+		monster_race *r_ptr;
 
-		/* Skip dead monsters */
-		if (!m_ptr->r_idx)
-			continue;
+		/* Take the next monster in range */
+		if (who) {
+			i = who[j];
+		} else {
+			i = j;
+
+			/* Skip dead monsters */
+			if (!m_list[i].r_idx)
+				continue;
+
+			/* Check range */
+			if (distance(py, px, m_list[i].fy, m_list[i].fx) > range)
+				continue;
+		}
+
+		m_ptr = &m_list[i];
+		r_ptr = &r_info[m_ptr->r_idx];
 
 		/* Location */
 		y = m_ptr->fy;
 		x = m_ptr->fx;
 
-		/* check range */
-		if (distance(py, px, y, x) > range)
-			continue;
 		
 		/* Detect all undead monsters */
 		if(rf_has(r_ptr->flags, RF_UNDEAD))
@@ -2689,7 +2781,9 @@ bool detect_all(int range, bool show)
 bool detect_nature_awareness(int range, bool show)
 {
 	int y, x;
-	int i;
+	int i, j, n;
+
+	s16b *who;
 	
 	int py = p_ptr->py;
 	int px = p_ptr->px;
@@ -2722,7 +2816,7 @@ bool detect_nature_awareness(int range, bool show)
 					cave_player_trap(y, x);
 				
 					/* Mark grid as trap detected */
-					sqinfo_on(cave_info[y][x], SQUARE_DTRAP);
+					square_on(y, x, SQUARE_DTRAP);
 				
 					/* Detect secret doors */
 					if(cave_feat[y][x] == FEAT_SECRET)
@@ -2741,7 +2835,7 @@ bool detect_nature_awareness(int range, bool show)
 						tf_has(f_ptr->flags, TF_WATERY))
 					{
 						/* Hack -- Memorize */
-						sqinfo_on(cave_info[y][x], SQUARE_MARK);
+						square_on(y, x, SQUARE_MARK);
 						
 						/* Redraw */
 						light_spot(y, x);
@@ -2791,24 +2885,34 @@ bool detect_nature_awareness(int range, bool show)
 		}
 	}
 	
-	/* Check for monsters within range */
-	for(i = 1; i < m_max; i++)
-	{
-		monster_type *m_ptr = &m_list[i];
-		monster_race *r_ptr = &r_info[m_ptr->r_idx];
+	/* Scan monsters in range */
+	who = detect_monster_list(range, &n);
+	for (j = 0; j < n; j++) {
+		monster_type *m_ptr;
+		monster_race *r_ptr;
+
+		/* Take the next monster in range */
+		if (who) {
+			i = who[j];
+		} else {
+			i = j;
 
-		/* Skip dead monsters */
-		if (!m_ptr->r_idx)
-			continue;
+			/* Skip dead monsters */
+			if (!m_list[i].r_idx)
+				continue;
+
+			/* Check range */
+			if (distance(py, px, m_list[i].fy, m_list[i].fx) > range)
+				continue;
+		}
+
+		m_ptr = &m_list[i];
+		r_ptr = &r_info[m_ptr->r_idx];
 
 		/* Location */
 		y = m_ptr->fy;
 		x = m_ptr->fx;
 
-		/* check range */
-		if (distance(py, px, y, x) > range)
-			continue;
-		
 		/* check for trees */
 		if (!near_tree(2, y, x))
 			continue;
@@ -4212,7 +4316,7 @@ void do_starlight(int burst_number, int dam, bool strong)
 
 	/* Is the player in a square already magically lit? */
 	bool player_lit =
-		sqinfo_has(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+		square_has(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 
 	for (i = 0; i < burst_number; i++) {
 		/* First, we find the spot. */
@@ -4246,7 +4350,7 @@ void do_starlight(int burst_number, int dam, bool strong)
 		/* Then we hit the spot. */
 
 		/* Confusing to be suddenly lit up. */
-		if (!sqinfo_has(cave_info[y][x], SQUARE_GLOW))
+		if (!square_has(y, x, SQUARE_GLOW))
 			fire_meteor(-1, GF_CONFU, y, x, dam, strong ? 1 : 0, FALSE);
 
 		/* The actual burst of light. */
@@ -4527,15 +4631,22 @@ void ele_air_smite(void)
  */
 bool project_los_not_player(int y1, int x1, int dam, int typ)
 {
-	int i, x, y;
+	int i, n, x, y;
 
 	u32b flg = PROJECT_JUMP | PROJECT_KILL | PROJECT_HIDE;
 
 	bool obvious = FALSE;
 
-	/* Affect all (nearby) monsters */
-	for (i = 1; i < m_max; i++) {
-		monster_type *m_ptr = &m_list[i];
+	s16b *who;
+
+	/*
+	 * Affect all (nearby) monsters; project() may look for monsters
+	 * near each one hit, so the list can't be temp_m_idx
+	 */
+	who = C_ZNEW(m_max, s16b);
+	n = monster_near_list(y1, x1, MAX_RANGE, MON_ANY_FACTION, who);
+	for (i = 0; i < n; i++) {
+		monster_type *m_ptr = &m_list[who[i]];
 
 		/* Paranoia -- Skip dead monsters */
 		if (!m_ptr->r_idx)
@@ -4562,6 +4673,8 @@ bool project_los_not_player(int y1, int x1, int dam, int typ)
 			obvious = TRUE;
 	}
 
+	FREE(who);
+
 	/* Result */
 	return (obvious);
 }
@@ -5013,7 +5126,7 @@ bool genocide(void)
 			continue;
 
 		/* Ignore monsters in icky squares */
-		if (sqinfo_has(cave_info[m_ptr->fy][m_ptr->fx], SQUARE_ICKY))
+		if (square_has(m_ptr->fy, m_ptr->fx, SQUARE_ICKY))
 			continue;
 
 		/* Delete the monster */
@@ -5035,12 +5148,18 @@ bool genocide(void)
  */
 bool mass_genocide(void)
 {
-	int i;
+	int i, j, n;
 
 	/* Delete the (nearby) monsters */
-	for (i = 1; i < m_max; i++) {
-		monster_type *m_ptr = &m_list[i];
-		monster_race *r_ptr = &r_info[m_ptr->r_idx];
+	n = monster_near_list(p_ptr->py, p_ptr->px, MAX_SIGHT, MON_ANY_FACTION,
+						  temp_m_idx);
+	for (j = 0; j < n; j++) {
+		monster_type *m_ptr;
+		monster_race *r_ptr;
+
+		i = temp_m_idx[j];
+		m_ptr = &m_list[i];
+		r_ptr = &r_info[m_ptr->r_idx];
 
 		/* Paranoia -- Skip dead monsters */
 		if (!m_ptr->r_idx)
@@ -5055,7 +5174,7 @@ bool mass_genocide(void)
 			continue;
 
 		/* Ignore monsters in icky squares */
-		if (sqinfo_has(cave_info[m_ptr->fy][m_ptr->fx], SQUARE_ICKY))
+		if (square_has(m_ptr->fy, m_ptr->fx, SQUARE_ICKY))
 			continue;
 
 		/* Delete the monster */
@@ -5166,15 +5285,15 @@ void destroy_area(int y1, int x1, int r, bool full)
 				continue;
 
 			/* Ignore icky squares */
-			if (sqinfo_has(cave_info[y][x], SQUARE_ICKY))
+			if (square_has(y, x, SQUARE_ICKY))
 				continue;
 
 			/* Lose room */
-			sqinfo_off(cave_info[y][x], SQUARE_ROOM);
+			square_off(y, x, SQUARE_ROOM);
 
 			/* Lose light and knowledge */
-			sqinfo_off(cave_info[y][x], SQUARE_MARK);
-			sqinfo_off(cave_info[y][x], SQUARE_GLOW);
+			square_off(y, x, SQUARE_MARK);
+			square_off(y, x, SQUARE_GLOW);
 
 			/* Hack -- Notice player affect */
 			if (cave_m_idx[y][x] < 0) {
@@ -5323,11 +5442,11 @@ void earthquake(int cy, int cx, int r, bool volcano)
 				continue;
 
 			/* Lose room */
-			sqinfo_off(cave_info[yy][xx], SQUARE_ROOM);
+			square_off(yy, xx, SQUARE_ROOM);
 
 			/* Lose light and knowledge */
-			sqinfo_off(cave_info[yy][xx], SQUARE_MARK);
-			sqinfo_off(cave_info[yy][xx], SQUARE_GLOW);
+			square_off(yy, xx, SQUARE_MARK);
+			square_off(yy, xx, SQUARE_GLOW);
 
 			/* Count total, water, lava and void grids */
 			total++;
@@ -5770,7 +5889,7 @@ bool tremor(void)
 
 		/* Test for empty floor and line of sight, forbid vaults */
 		if (cave_empty_bold(ny, nx)
-			&& !sqinfo_has(cave_info[ny][nx], SQUARE_ICKY)
+			&& !square_has(ny, nx, SQUARE_ICKY)
 			&& (player_has_los_bold(ny, nx)))
 			valid_grid = TRUE;
 	}
@@ -5807,10 +5926,10 @@ static void cave_temp_room_light(void)
 		int x = temp_x[i];
 
 		/* No longer in the array */
-		sqinfo_off(cave_info[y][x], SQUARE_TEMP);
+		square_off(y, x, SQUARE_TEMP);
 
 		/* Perma-Light */
-		sqinfo_on(cave_info[y][x], SQUARE_GLOW);
+		square_on(y, x, SQUARE_GLOW);
 	}
 
 	/* Fully update the visuals */
@@ -5894,19 +6013,19 @@ static int cave_temp_room_unlight(void)
 		feature_type *f_ptr = &f_info[cave_feat[y][x]];
 
 		/* No longer in the array */
-		sqinfo_off(cave_info[y][x], SQUARE_TEMP);
+		square_off(y, x, SQUARE_TEMP);
 		
 		/* Count if the square is lit */
-		count += sqinfo_has(cave_info[y][x], SQUARE_GLOW);
+		count += square_has(y, x, SQUARE_GLOW);
 
 		/* Darken the grid */
-		sqinfo_off(cave_info[y][x], SQUARE_GLOW);
+		square_off(y, x, SQUARE_GLOW);
 
 		/* Hack -- Forget "boring" grids */
 		if (tf_has(f_ptr->flags, TF_FLOOR) &&
-			!sqinfo_has(cave_info[y][x], SQUARE_TRAP)) {
+			!square_has(y, x, SQUARE_TRAP)) {
 			/* Forget the grid */
-			sqinfo_off(cave_info[y][x], SQUARE_MARK);
+			square_off(y, x, SQUARE_MARK);
 		}
 	}
 
@@ -5944,11 +6063,11 @@ static void cave_temp_room_aux(int y, int x)
 		return;
 
 	/* Avoid infinite recursion */
-	if (sqinfo_has(cave_info[y][x], SQUARE_TEMP))
+	if (square_has(y, x, SQUARE_TEMP))
 		return;
 
 	/* Do not "leave" the current room */
-	if (!sqinfo_has(cave_info[y][x], SQUARE_ROOM))
+	if (!square_has(y, x, SQUARE_ROOM))
 		return;
 
 	/* Paranoia -- verify space */
@@ -5956,7 +6075,7 @@ static void cave_temp_room_aux(int y, int x)
 		return;
 
 	/* Mark the grid as "seen" */
-	sqinfo_on(cave_info[y][x], SQUARE_TEMP);
+	square_on(y, x, SQUARE_TEMP);
 
 	/* Add it to the "seen" set */
 	temp_y[temp_n] = y;
@@ -6650,9 +6769,9 @@ bool create_wall(void)
 	/* Place the wall */
 	cave_set_feat(y, x, FEAT_WALL_EXTRA);
 	/* Don't perform any more alterations */
-	sqinfo_off(cave_info[y][x], SQUARE_MARK);
+	square_off(y, x, SQUARE_MARK);
 	/* Walls don't glow */
-	sqinfo_off(cave_info[y][x], SQUARE_GLOW);
+	square_off(y, x, SQUARE_GLOW);
 	
 	/* Update Stuff */
 	p_ptr->update |= (PU_FORGET_VIEW | PU_UPDATE_VIEW | PU_MONSTERS);
@@ -36,12 +36,15 @@
 /* Is the target set? */
 bool target_set;
 
-/* Current monster being tracked, or 0 */
-static struct monster *target_who;
+/* Handle on the current monster being tracked, or 0 */
+static u32b target_who;
 
 /* Current object being tracked, or 0 */
 u16b target_what;
 
+/* Handle on the current object being tracked */
+static u32b target_what_handle;
+
 /* Target location */
 static s16b target_x, target_y;
 
@@ -229,15 +232,17 @@ bool target_okay(void)
 		return (FALSE);
 
 	/* Accept "location" targets */
-	if ((target_who == NULL) && (target_what == 0))
+	if ((target_who == 0) && (target_what == 0))
 		return (TRUE);
 
-	/* Check "monster" targets */
+	/* Check "monster" targets, which may have gone */
 	if (target_who) {
-		if (target_able(target_who)) {
+		struct monster *mon = target_get_monster();
+
+		if (mon && target_able(mon)) {
 			/* Get the monster location */
-			target_y = target_who->fy;
-			target_x = target_who->fx;
+			target_y = mon->fy;
+			target_x = mon->fx;
 
 			/* Good target */
 			return TRUE;
@@ -246,10 +251,10 @@ bool target_okay(void)
 
 	/* Check "object" targets */
 	else if (target_what > 0) {
-		int o_idx = target_what;
+		int o_idx = object_handle_idx(target_what_handle);
 
-		/* Accept reasonable targets */
-		if (target_able_obj(o_idx)) {
+		/* Accept reasonable targets, if the object is still there */
+		if (o_idx && target_able_obj(o_idx)) {
 			object_type *o_ptr = &o_list[o_idx];
 
 			/* Acquire object location */
@@ -281,7 +286,7 @@ void target_set_monster(struct monster *mon)
 
 		/* Save target info */
 		target_set = TRUE;
-		target_who = mon;
+		target_who = monster_handle(mon - m_list);
 		target_what = 0;
 		target_y = mon->fy;
 		target_x = mon->fx;
@@ -291,7 +296,7 @@ void target_set_monster(struct monster *mon)
 	else {
 		/* Reset target info */
 		target_set = FALSE;
-		target_who = NULL;
+		target_who = 0;
 		target_what = 0;
 		target_y = 0;
 		target_x = 0;
@@ -310,8 +315,9 @@ void target_set_object(int o_idx)
 
 		/* Save target info */
 		target_set = TRUE;
-		target_who = NULL;
+		target_who = 0;
 		target_what = o_idx;
+		target_what_handle = object_handle(o_idx);
 		target_y = o_ptr->iy;
 		target_x = o_ptr->ix;
 	}
@@ -320,7 +326,7 @@ void target_set_object(int o_idx)
 	else {
 		/* Reset target info */
 		target_set = FALSE;
-		target_who = NULL;
+		target_who = 0;
 		target_what = 0;
 		target_y = 0;
 		target_x = 0;
@@ -337,7 +343,7 @@ void target_set_location(int y, int x)
 	if (in_bounds_fully(y, x)) {
 		/* Save target info */
 		target_set = TRUE;
-		target_who = NULL;
+		target_who = 0;
 		target_what = 0;
 		target_y = y;
 		target_x = x;
@@ -347,7 +353,7 @@ void target_set_location(int y, int x)
 	else {
 		/* Reset target info */
 		target_set = FALSE;
-		target_who = NULL;
+		target_who = 0;
 		target_what = 0;
 		target_y = 0;
 		target_x = 0;
@@ -500,7 +506,7 @@ static bool target_set_interactive_accept(int y, int x)
 	}
 
 	/* Interesting memorized features */
-	if (sqinfo_has(cave_info[y][x], SQUARE_MARK)) {
+	if (square_has(y, x, SQUARE_MARK)) {
 		feature_type *f_ptr = &f_info[cave_feat[y][x]];
 
 		/* Notice interesting things */
@@ -1133,7 +1139,7 @@ static ui_event target_set_interactive_aux(s16b y, s16b x, int mode)
 		feat = f_info[cave_feat[y][x]].mimic;
 
 		/* Require knowledge about grid, or ability to see grid */
-		if (!sqinfo_has(cave_info[y][x], SQUARE_MARK) &&
+		if (!square_has(y, x, SQUARE_MARK) &&
 			!player_can_see_bold(y, x)) {
 			/* Forget feature */
 			feat = FEAT_NONE;
@@ -1339,12 +1345,12 @@ static int draw_path(u16b path_n, u16b * path_g, wchar_t * c, int *a,
 			colour = TERM_YELLOW;
 
 		else if (!cave_project(y, x) &&
-				 (sqinfo_has(cave_info[y][x], SQUARE_MARK) ||
+				 (square_has(y, x, SQUARE_MARK) ||
 				  player_can_see_bold(y, x)))
 			/* Known walls are blue. */
 			colour = TERM_BLUE;
 
-		else if (!sqinfo_has(cave_info[y][x], SQUARE_MARK) &&
+		else if (!square_has(y, x, SQUARE_MARK) &&
 				 !player_can_see_bold(y, x))
 			/* Unknown squares are grey. */
 			colour = TERM_L_DARK;
@@ -2113,7 +2119,9 @@ void target_get(s16b * col, s16b * row)
  */
 struct monster *target_get_monster(void)
 {
-	return target_who;
+	int m_idx = monster_handle_idx(target_who);
+
+	return (m_idx ? &m_list[m_idx] : NULL);
 }
 
 /**
@@ -2134,7 +2142,7 @@ bool target_sighted(void)
 		/* either the target is a grid and is visible, or it is a monster 
 		 * that is visible */
 		((!target_who && player_can_see_bold(target_y, target_x))
-		 || (target_who && target_who->ml));
+		 || (target_who && target_get_monster()->ml));
 }
 
 /*
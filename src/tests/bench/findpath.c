@@ -0,0 +1,94 @@
+/*
+ * File: tests/bench/findpath.c
+ * Purpose: Time findpath() against the old windowed search
+ *
+ * Usage: bench/findpath [levels] [targets]
+ *
+ * Every grid of each level is known, so walls are obstacles.  Targets are
+ * picked inside the square the old search could see, and both searches are
+ * timed on them; then the new search is timed on targets anywhere on the
+ * level, which the old one refused.
+ */
+
+#include "test-utils.h"
+#include "cave.h"
+#include "pathfind/old-findpath.h"
+
+int main(int argc, char *argv[])
+{
+	int levels = (argc > 1) ? atoi(argv[1]) : 100;
+	int targets = (argc > 2) ? atoi(argv[2]) : 20;
+	int level, n, y, x;
+	int near = 0, far = 0;
+	int new_found = 0, old_found = 0, far_found = 0, shorter = 0;
+	double t, dt, t_new = 0.0, t_old = 0.0, t_far = 0.0;
+	double t_new_miss = 0.0, t_old_miss = 0.0;
+
+	test_init_game();
+	test_new_player(1);
+
+	for (level = 0; level < levels; level++) {
+		test_new_level(900 + level, 5 + level % 40);
+
+		for (y = 0; y < DUNGEON_HGT; y++)
+			for (x = 0; x < DUNGEON_WID; x++)
+				square_on(y, x, SQUARE_MARK);
+
+		if (!test_random_floor(&y, &x))
+			continue;
+		test_place_player(y, x);
+
+		for (n = 0; n < targets; n++) {
+			int ty = p_ptr->py + rand_spread(0, MAX_PF_RADIUS / 2);
+			int tx = p_ptr->px + rand_spread(0, MAX_PF_RADIUS / 2);
+			bool found_new, found_old;
+
+			if (!in_bounds_fully(ty, tx) || !old_findpath_window(ty, tx))
+				continue;
+			near++;
+
+			t = test_clock();
+			found_new = findpath(ty, tx);
+			dt = test_clock() - t;
+			t_new += dt;
+			if (!found_new)
+				t_new_miss += dt;
+
+			t = test_clock();
+			found_old = old_findpath(ty, tx);
+			dt = test_clock() - t;
+			t_old += dt;
+			if (!found_new)
+				t_old_miss += dt;
+
+			new_found += found_new;
+			old_found += found_old;
+			if (found_new && found_old &&
+				(pf_result_index < old_pf_result_index))
+				shorter++;
+		}
+
+		for (n = 0; n < targets; n++) {
+			int ty = randint1(DUNGEON_HGT - 2);
+			int tx = randint1(DUNGEON_WID - 2);
+
+			far++;
+			t = test_clock();
+			far_found += findpath(ty, tx);
+			t_far += test_clock() - t;
+		}
+	}
+
+	printf("%d levels\n", levels);
+	printf("%d targets inside the old window:\n", near);
+	printf("  findpath():     %8.3f s, %d found, %d shorter than the old\n",
+		   t_new, new_found, shorter);
+	printf("  old search:     %8.3f s, %d found\n", t_old, old_found);
+	printf("  of which on the %d unreachable targets: %.3f s, old %.3f s\n",
+		   near - new_found, t_new_miss, t_old_miss);
+	printf("%d targets anywhere:\n", far);
+	printf("  findpath():     %8.3f s, %d found\n", t_far, far_found);
+
+	test_cleanup_game();
+	return 0;
+}
@@ -0,0 +1,94 @@
+/*
+ * File: tests/bench/flags.c
+ * Purpose: Time the inlined single flag tests against the checked ones
+ *
+ * Usage: bench/flags [passes]
+ *
+ * Each pass walks every grid of a level testing terrain flags, then every
+ * monster race testing all its race flags, once with the tests the per-set
+ * macros use and once with flag_has_dbg(), which is what they called
+ * before (and still call when built with BITFLAG_DEBUG).
+ */
+
+#include "test-utils.h"
+
+static long walk_fast(void)
+{
+	int y, x, i, flag;
+	long n = 0;
+
+	for (y = 0; y < DUNGEON_HGT; y++) {
+		for (x = 0; x < DUNGEON_WID; x++) {
+			bitflag *f = f_info[cave_feat[y][x]].flags;
+
+			n += tf_has(f, TF_LOS) + tf_has(f, TF_PROJECT) +
+				tf_has(f, TF_PASSABLE) + tf_has(f, TF_ROCK);
+		}
+	}
+
+	for (i = 1; i < z_info->r_max; i++)
+		for (flag = FLAG_START; flag < RF_MAX; flag++)
+			n += rf_has(r_info[i].flags, flag);
+
+	return n;
+}
+
+static long walk_checked(void)
+{
+	int y, x, i, flag;
+	long n = 0;
+
+	for (y = 0; y < DUNGEON_HGT; y++) {
+		for (x = 0; x < DUNGEON_WID; x++) {
+			bitflag *f = f_info[cave_feat[y][x]].flags;
+
+			n += flag_has_dbg(f, TF_SIZE, TF_LOS, "f", "TF_LOS") +
+				flag_has_dbg(f, TF_SIZE, TF_PROJECT, "f", "TF_PROJECT") +
+				flag_has_dbg(f, TF_SIZE, TF_PASSABLE, "f", "TF_PASSABLE") +
+				flag_has_dbg(f, TF_SIZE, TF_ROCK, "f", "TF_ROCK");
+		}
+	}
+
+	for (i = 1; i < z_info->r_max; i++)
+		for (flag = FLAG_START; flag < RF_MAX; flag++)
+			n += flag_has_dbg(r_info[i].flags, RF_SIZE, flag, "r", "flag");
+
+	return n;
+}
+
+int main(int argc, char *argv[])
+{
+	int passes = (argc > 1) ? atoi(argv[1]) : 500;
+	int i;
+	long tests, n_fast = 0, n_checked = 0;
+	double t, t_fast, t_checked;
+
+	test_init_game();
+	test_new_player(1);
+	test_new_level(7, 20);
+
+	tests = 4L * DUNGEON_HGT * DUNGEON_WID +
+		(long) (z_info->r_max - 1) * (RF_MAX - FLAG_START);
+
+	t = test_clock();
+	for (i = 0; i < passes; i++)
+		n_fast += walk_fast();
+	t_fast = test_clock() - t;
+
+	t = test_clock();
+	for (i = 0; i < passes; i++)
+		n_checked += walk_checked();
+	t_checked = test_clock() - t;
+
+	if (n_fast != n_checked)
+		quit_fmt("Flag counts differ: %ld, %ld", n_fast, n_checked);
+
+	printf("%d passes of %ld flag tests\n", passes, tests);
+	printf("inlined tests:      %6.2f ns/test\n",
+		   1e9 * t_fast / (passes * (double) tests));
+	printf("flag_has_dbg():     %6.2f ns/test\n",
+		   1e9 * t_checked / (passes * (double) tests));
+
+	test_cleanup_game();
+	return 0;
+}
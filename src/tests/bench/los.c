@@ -0,0 +1,118 @@
+/*
+ * File: tests/bench/los.c
+ * Purpose: Time the cached los() against the uncached line walk
+ *
+ * Usage: bench/los [queries]
+ *
+ * Two sets of queries are timed, both between grids at most MAX_SIGHT_LGE
+ * apart on a generated level.  The first asks 200 pairs over and over,
+ * which is what monster turns and scent and noise updates do.  The second
+ * asks a new random pair every time, so that nearly every query misses the
+ * cache, which is the worst case for it.  The pairs are made up before the
+ * clock starts.
+ */
+
+#include "test-utils.h"
+#include "cave/old-los.h"
+
+#define REPEATED_PAIRS	200
+
+static s16b pair_y1[REPEATED_PAIRS], pair_x1[REPEATED_PAIRS];
+static s16b pair_y2[REPEATED_PAIRS], pair_x2[REPEATED_PAIRS];
+
+/**
+ * Make up "n" random pairs of grids near each other
+ */
+static void make_pairs(s16b *y1, s16b *x1, s16b *y2, s16b *x2, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		int y, x, ty, tx;
+
+		if (!test_random_floor(&y, &x))
+			quit("No floor to start from");
+
+		do {
+			ty = y + rand_spread(0, MAX_SIGHT_LGE);
+			tx = x + rand_spread(0, MAX_SIGHT_LGE);
+		} while (!in_bounds(ty, tx));
+
+		y1[i] = y;
+		x1[i] = x;
+		y2[i] = ty;
+		x2[i] = tx;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int queries = (argc > 1) ? atoi(argv[1]) : 20000000;
+	int distinct = queries / 10;
+	s16b *dy1, *dx1, *dy2, *dx2;
+	int i, seen = 0, seen_old = 0;
+	u32b hits, misses;
+	double t, t_rep, t_rep_old, t_dis, t_dis_old;
+
+	test_init_game();
+	test_new_player(1);
+	test_new_level(7, 20);
+
+	make_pairs(pair_y1, pair_x1, pair_y2, pair_x2, REPEATED_PAIRS);
+
+	dy1 = mem_alloc(distinct * sizeof(s16b));
+	dx1 = mem_alloc(distinct * sizeof(s16b));
+	dy2 = mem_alloc(distinct * sizeof(s16b));
+	dx2 = mem_alloc(distinct * sizeof(s16b));
+	make_pairs(dy1, dx1, dy2, dx2, distinct);
+
+	/* The same pairs over and over */
+	hits = los_cache_hits;
+	misses = los_cache_misses;
+	t = test_clock();
+	for (i = 0; i < queries; i++) {
+		int n = i % REPEATED_PAIRS;
+
+		seen += los(pair_y1[n], pair_x1[n], pair_y2[n], pair_x2[n]);
+	}
+	t_rep = test_clock() - t;
+	hits = los_cache_hits - hits;
+	misses = los_cache_misses - misses;
+
+	t = test_clock();
+	for (i = 0; i < queries; i++) {
+		int n = i % REPEATED_PAIRS;
+
+		seen_old += old_los(pair_y1[n], pair_x1[n], pair_y2[n], pair_x2[n]);
+	}
+	t_rep_old = test_clock() - t;
+
+	/* A new pair every time */
+	t = test_clock();
+	for (i = 0; i < distinct; i++)
+		seen += los(dy1[i], dx1[i], dy2[i], dx2[i]);
+	t_dis = test_clock() - t;
+
+	t = test_clock();
+	for (i = 0; i < distinct; i++)
+		seen_old += old_los(dy1[i], dx1[i], dy2[i], dx2[i]);
+	t_dis_old = test_clock() - t;
+
+	if (seen != seen_old)
+		quit("los() and the old line walk disagree");
+
+	printf("%d queries of %d pairs (%lu hits, %lu misses)\n", queries,
+		   REPEATED_PAIRS, (unsigned long) hits, (unsigned long) misses);
+	printf("  los():            %8.1f ns/query\n", 1e9 * t_rep / queries);
+	printf("  old line walk:    %8.1f ns/query\n", 1e9 * t_rep_old / queries);
+	printf("%d queries of distinct pairs\n", distinct);
+	printf("  los():            %8.1f ns/query\n", 1e9 * t_dis / distinct);
+	printf("  old line walk:    %8.1f ns/query\n", 1e9 * t_dis_old / distinct);
+
+	mem_free(dy1);
+	mem_free(dx1);
+	mem_free(dy2);
+	mem_free(dx2);
+	test_cleanup_game();
+	return 0;
+}
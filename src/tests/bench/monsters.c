@@ -0,0 +1,111 @@
+/*
+ * File: tests/bench/monsters.c
+ * Purpose: Time game turns on a level crowded with monsters
+ *
+ * Usage: bench/monsters [pit|level|summon] [monsters] [turns] [depth]
+ *
+ * A level is generated and then crowded with extra monsters:
+ *   pit     awake monsters packed around the player
+ *   level   awake monsters anywhere on the level
+ *   summon  monsters summoned next to the player
+ * Then game turns are run as dungeon() runs them, but without the player
+ * taking any actions; the player is kept alive.  Only process_monsters()
+ * and reset_monsters() are timed.
+ *
+ * The hash at the end covers every monster's race, place, hit points,
+ * speed and sleep, and the state of the random number generator, so a
+ * change to how monster turns are scheduled can be checked for the same
+ * game as well as the same speed.
+ */
+
+#include "test-utils.h"
+#include "monster.h"
+
+static void crowd(const char *how, int count)
+{
+	int i, tries;
+
+	if (!strcmp(how, "pit")) {
+		for (i = 0, tries = 0; (i < count) && (tries < 100000); tries++) {
+			int y = p_ptr->py + rand_spread(0, 12);
+			int x = p_ptr->px + rand_spread(0, 30);
+
+			if (in_bounds_fully(y, x) && cave_empty_bold(y, x) &&
+				place_monster(y, x, FALSE, FALSE, TRUE))
+				i++;
+		}
+	} else if (!strcmp(how, "level")) {
+		for (i = 0; i < count; i++)
+			alloc_monster(10, FALSE, TRUE);
+	} else if (!strcmp(how, "summon")) {
+		for (i = 0; i < count; i++)
+			summon_specific(p_ptr->py, p_ptr->px, FALSE, p_ptr->depth + 5,
+							0, F_MONSTER);
+	} else {
+		quit_fmt("Unknown crowd '%s'", how);
+	}
+}
+
+static u32b monster_hash(void)
+{
+	u32b h = 0;
+	int i;
+
+	for (i = 1; i < m_max; i++) {
+		monster_type *m_ptr = &m_list[i];
+
+		if (!m_ptr->r_idx)
+			continue;
+
+		h = h * 31 + m_ptr->r_idx;
+		h = h * 31 + m_ptr->fy;
+		h = h * 31 + m_ptr->fx;
+		h = h * 31 + m_ptr->hp;
+		h = h * 31 + m_ptr->mspeed;
+		h = h * 31 + m_ptr->csleep;
+	}
+
+	return h * 31 + Rand_div(1000000);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *how = (argc > 1) ? argv[1] : "pit";
+	int count = (argc > 2) ? atoi(argv[2]) : 400;
+	int turns = (argc > 3) ? atoi(argv[3]) : 10000;
+	int depth = (argc > 4) ? atoi(argv[4]) : 20;
+	int n, start_cnt;
+	double t, t_mon = 0.0;
+
+	test_init_game();
+	test_new_player(1);
+	test_new_level(7, depth);
+
+	crowd(how, count);
+	update_stuff(p_ptr);
+	start_cnt = m_cnt;
+
+	for (n = 0; (n < turns) && !p_ptr->leaving; n++) {
+		p_ptr->chp = p_ptr->mhp;
+		p_ptr->is_dead = FALSE;
+
+		t = test_clock();
+		process_monsters(0);
+		reset_monsters();
+		t_mon += test_clock() - t;
+
+		if (p_ptr->update)
+			update_stuff(p_ptr);
+
+		turn++;
+	}
+
+	printf("%s, depth %d: %d monsters at the start, %d at the end\n", how,
+		   p_ptr->depth, start_cnt, m_cnt);
+	printf("%d game turns in %.3f s: %.0f turns/s\n", n, t_mon,
+		   t_mon > 0 ? n / t_mon : 0.0);
+	printf("hash %08lx\n", (unsigned long) monster_hash());
+
+	test_cleanup_game();
+	return 0;
+}
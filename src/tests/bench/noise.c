@@ -0,0 +1,71 @@
+/*
+ * File: tests/bench/noise.c
+ * Purpose: Time update_noise() on a walk, and count the grids it changes
+ *
+ * Usage: bench/noise [levels] [steps]
+ *
+ * On each level the player wanders for a number of steps, and the noise
+ * flow is updated after every step.  Only the update itself is timed.  The
+ * grids whose cost changed are counted by comparing cave_cost before and
+ * after, which is a lower bound on the grids the update wrote.
+ */
+
+#include "test-utils.h"
+#include "cave.h"
+
+static byte old_cost[DUNGEON_HGT][DUNGEON_WID];
+
+int main(int argc, char *argv[])
+{
+	int levels = (argc > 1) ? atoi(argv[1]) : 100;
+	int steps = (argc > 2) ? atoi(argv[2]) : 500;
+	int level, n, y, x;
+	int dir = 0;
+	long changed = 0, rebuilds = 0, recenters = 0, calls = 0;
+	double t, t_noise = 0.0;
+
+	test_init_game();
+	test_new_player(1);
+
+	for (level = 0; level < levels; level++) {
+		test_new_level(500 + level, 5 + level % 40);
+		if (!test_random_floor(&y, &x))
+			continue;
+		test_place_player(y, x);
+
+		for (n = 0; n < steps; n++) {
+			int old_center = cost_at_center;
+			int old_y = flow_center_y;
+			int old_x = flow_center_x;
+
+			test_walk(&dir);
+			memcpy(old_cost, cave_cost, sizeof(old_cost));
+
+			t = test_clock();
+			update_noise();
+			t_noise += test_clock() - t;
+			calls++;
+
+			if ((cost_at_center == 100) && ((old_center != 100) ||
+											(flow_center_y != old_y) ||
+											(flow_center_x != old_x)))
+				rebuilds++;
+			else if (cost_at_center < old_center)
+				recenters++;
+
+			for (y = 0; y < DUNGEON_HGT; y++)
+				for (x = 0; x < DUNGEON_WID; x++)
+					if (cave_cost[y][x] != old_cost[y][x])
+						changed++;
+		}
+	}
+
+	printf("%d levels, %ld updates (%ld rebuilds, %ld re-centered)\n",
+		   levels, calls, rebuilds, recenters);
+	printf("grids changed per step:   %8.1f\n", (double) changed / calls);
+	printf("time in update_noise():   %8.3f s (%.2f us/step)\n", t_noise,
+		   1e6 * t_noise / calls);
+
+	test_cleanup_game();
+	return 0;
+}
@@ -0,0 +1,80 @@
+/*
+ * File: tests/bench/parser.c
+ * Purpose: Time how fast parser_parse() splits the template files, against
+ * the old way of splitting them
+ *
+ * Usage: bench/parser [rounds]
+ *
+ * Every line of every template file is held in memory, so no time goes on
+ * reading files, and parsed with hooks which split every field as a sym
+ * and do nothing with it.  The same lines are then split the old way, with
+ * strtok() and an allocation for every field.
+ */
+
+#include "test-utils.h"
+#include "parse/old-tokenize.h"
+
+static const char *names[] = {
+	"limits", "object", "artifact", "set_item", "names", "trap",
+	"terrain", "ego_item", "monster_base", "monster", "shop_own",
+	"p_race", "ability", "p_class", "p_mark", "vault", "themed",
+	"p_hist", "flavor", "spell", "hints", "pain"
+};
+
+static const char *kinds = "ssssssssssssssss";
+
+int main(int argc, char *argv[])
+{
+	int rounds = (argc > 1) ? atoi(argv[1]) : 50;
+	char **lines[N_ELEMENTS(names)];
+	int counts[N_ELEMENTS(names)];
+	struct parser *parsers[N_ELEMENTS(names)];
+	double bytes = 0.0, num_lines = 0.0;
+	double t, t_new = 0.0, t_old = 0.0;
+	size_t f;
+	int n, i;
+
+	test_init_paths();
+
+	for (f = 0; f < N_ELEMENTS(names); f++) {
+		lines[f] = test_read_template(names[f], &counts[f]);
+		if (!lines[f])
+			quit_fmt("Cannot read '%s'", names[f]);
+
+		parsers[f] = kinds_parser(lines[f], counts[f], kinds, ignored);
+
+		for (i = 0; i < counts[f]; i++)
+			bytes += strlen(lines[f][i]) + 1;
+		num_lines += counts[f];
+	}
+
+	for (n = 0; n < rounds; n++) {
+		t = test_clock();
+		for (f = 0; f < N_ELEMENTS(names); f++)
+			for (i = 0; i < counts[f]; i++)
+				if (parser_parse(parsers[f], lines[f][i]))
+					quit_fmt("%s line %d did not parse", names[f], i + 1);
+		t_new += test_clock() - t;
+
+		t = test_clock();
+		for (f = 0; f < N_ELEMENTS(names); f++)
+			for (i = 0; i < counts[f]; i++)
+				old_tokenize(lines[f][i], kinds);
+		old_freeold();
+		t_old += test_clock() - t;
+	}
+
+	printf("%d rounds over %.0f lines, %.0f KB, of templates\n", rounds,
+		   num_lines, bytes / 1024);
+	printf("  parser_parse(): %8.1f MB/s\n",
+		   t_new > 0 ? rounds * bytes / t_new / 1e6 : 0.0);
+	printf("  old splitting:  %8.1f MB/s\n",
+		   t_old > 0 ? rounds * bytes / t_old / 1e6 : 0.0);
+
+	for (f = 0; f < N_ELEMENTS(names); f++) {
+		parser_destroy(parsers[f]);
+		test_free_lines(lines[f], counts[f]);
+	}
+
+	return 0;
+}
@@ -0,0 +1,44 @@
+/*
+ * File: tests/bench/startup.c
+ * Purpose: Time init_angband() with and without the binary caches
+ *
+ * Usage: bench/startup [rounds]
+ *
+ * The caches go in a private user directory.  Each round deletes them and
+ * runs init_angband(), which parses every template and writes the caches
+ * again, as the first start after an upgrade does; then runs it again,
+ * which loads the caches, as every later start does.
+ */
+
+#include "test-utils.h"
+#include "init/caches.h"
+
+int main(int argc, char *argv[])
+{
+	int rounds = (argc > 1) ? atoi(argv[1]) : 20;
+	int n;
+	double t, t_text = 0.0, t_cache = 0.0;
+
+	test_init_paths();
+	if (!cache_dir_make())
+		quit("Cannot make a directory for the caches");
+
+	for (n = 0; n < rounds; n++) {
+		cache_files_remove();
+		t = test_clock();
+		init_angband();
+		t_text += test_clock() - t;
+
+		t = test_clock();
+		init_angband();
+		t_cache += test_clock() - t;
+	}
+
+	printf("%d rounds of init_angband()\n", rounds);
+	printf("  from the templates: %8.2f ms\n", 1000 * t_text / rounds);
+	printf("  from the caches:    %8.2f ms\n", 1000 * t_cache / rounds);
+
+	cache_dir_remove();
+	test_cleanup_game();
+	return 0;
+}
@@ -0,0 +1,86 @@
+/*
+ * File: tests/bench/view.c
+ * Purpose: Time update_view() against the old whole-map los() sweep
+ *
+ * Usage: bench/view [calls]
+ *
+ * The player takes a random walk through a level, and the view is worked
+ * out after every step, first by update_view() and then by old_view().
+ * The player then stands still while one grid next to them is lit and
+ * darkened in turn, which is what the incremental update is for.
+ */
+
+#include "test-utils.h"
+#include "cave/old-view.h"
+
+/**
+ * Take one step in a random direction, if the grid there is empty
+ */
+static void random_step(void)
+{
+	int d = randint0(8);
+	int y = p_ptr->py + ddy_ddd[d];
+	int x = p_ptr->px + ddx_ddd[d];
+
+	if (in_bounds_fully(y, x) && cave_empty_bold(y, x))
+		test_place_player(y, x);
+}
+
+int main(int argc, char *argv[])
+{
+	int calls = (argc > 1) ? atoi(argv[1]) : 20000;
+	int i, y, x;
+	u32b walk_seed = 42;
+	double t, t_new, t_old, t_still;
+
+	test_init_game();
+	test_new_player(1);
+	test_new_level(7, 20);
+	p_ptr->cur_light = 2;
+
+	if (!test_random_floor(&y, &x))
+		quit("No floor to start from");
+
+	/* Walk with the new view */
+	test_place_player(y, x);
+	Rand_state_init(walk_seed);
+	t = test_clock();
+	for (i = 0; i < calls; i++) {
+		random_step();
+		update_view();
+	}
+	t_new = test_clock() - t;
+
+	/* The same walk with the old view */
+	test_place_player(y, x);
+	Rand_state_init(walk_seed);
+	t = test_clock();
+	for (i = 0; i < calls; i++) {
+		random_step();
+		old_view();
+	}
+	t_old = test_clock() - t;
+
+	/* Stand still and change the lighting next to the player */
+	update_view();
+	t = test_clock();
+	for (i = 0; i < calls; i++) {
+		if (i & 1)
+			square_off(p_ptr->py, p_ptr->px + 1, SQUARE_GLOW);
+		else
+			square_on(p_ptr->py, p_ptr->px + 1, SQUARE_GLOW);
+		update_view();
+	}
+	t_still = test_clock() - t;
+
+	printf("%d calls\n", calls);
+	printf("update_view(), walking:        %8.2f us/call\n",
+		   1e6 * t_new / calls);
+	printf("old whole-map view, walking:   %8.2f us/call\n",
+		   1e6 * t_old / calls);
+	printf("update_view(), one grid lit:   %8.2f us/call\n",
+		   1e6 * t_still / calls);
+
+	test_cleanup_game();
+	return 0;
+}
@@ -0,0 +1,154 @@
+/*
+ * File: tests/cave/los.c
+ * Purpose: Check the cached los() against the uncached line walk
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave/old-los.h"
+
+const char *suite_name = "cave/los";
+
+int setup_tests(void **state)
+{
+	test_init_game();
+	test_new_player(1);
+	return 0;
+}
+
+int teardown_tests(void *state)
+{
+	test_cleanup_game();
+	return 0;
+}
+
+/**
+ * Pick a grid inside the map within "d" grids of (y, x)
+ */
+static void random_near(int y, int x, int d, int *y2, int *x2)
+{
+	do {
+		*y2 = y + rand_spread(0, d);
+		*x2 = x + rand_spread(0, d);
+	} while (!in_bounds(*y2, *x2));
+}
+
+/**
+ * Find two grids on one row, "d" apart, with nothing between them to stop
+ * a projection
+ */
+static bool open_row(int d, int *y, int *x1, int *x2)
+{
+	int tries;
+
+	for (tries = 0; tries < 10000; tries++) {
+		int x;
+
+		if (!test_random_floor(y, x1))
+			return FALSE;
+
+		*x2 = *x1 + d;
+		if (!in_bounds_fully(*y, *x2))
+			continue;
+
+		for (x = *x1; x <= *x2; x++)
+			if (!cave_project(*y, x))
+				break;
+
+		if (x > *x2)
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+/**
+ * Ask the same pairs twice on a range of levels, so that both the answers
+ * worked out and the answers found in the cache are checked.
+ */
+static int test_pairs(void *state)
+{
+	int level, n, pass;
+
+	for (level = 0; level < 6; level++) {
+		test_new_level(200 + level, 5 + 8 * level);
+
+		for (pass = 0; pass < 2; pass++) {
+			Rand_state_init(300 + level);
+
+			for (n = 0; n < 20000; n++) {
+				int y1, x1, y2, x2;
+
+				require(test_random_floor(&y1, &x1));
+				random_near(y1, x1, MAX_SIGHT_LGE, &y2, &x2);
+
+				if (verbose && (los(y1, x1, y2, x2) !=
+								old_los(y1, x1, y2, x2)))
+					printf("    (%d, %d) to (%d, %d), pass %d\n", y1, x1,
+						   y2, x2, pass);
+				eq(los(y1, x1, y2, x2), old_los(y1, x1, y2, x2));
+			}
+		}
+	}
+
+	ok;
+}
+
+/**
+ * Answers change as soon as the terrain between two grids does
+ */
+static int test_terrain(void *state)
+{
+	int y, x1, x2;
+
+	test_new_level(210, 20);
+	require(open_row(6, &y, &x1, &x2));
+
+	require(los(y, x1, y, x2));
+	require(projectable(y, x1, y, x2, PROJECT_NONE));
+
+	cave_set_feat(y, x1 + 3, FEAT_WALL_EXTRA);
+	require(!los(y, x1, y, x2));
+	require(!projectable(y, x1, y, x2, PROJECT_NONE));
+
+	cave_set_feat(y, x1 + 3, FEAT_FLOOR);
+	require(los(y, x1, y, x2));
+	require(projectable(y, x1, y, x2, PROJECT_NONE));
+
+	ok;
+}
+
+/**
+ * Grids off the map must not share a cache entry with grids on it.  A
+ * coordinate 256 away from one on the map fills the same byte of the key;
+ * the lines to such grids cross the permanent walls round the map, so
+ * have no line of sight.
+ */
+static int test_off_map(void *state)
+{
+	int y, x1, x2;
+
+	test_new_level(220, 20);
+	require(open_row(6, &y, &x1, &x2));
+
+	require(los(y, x1, y, x2));
+	require(!old_los(y, x1, y + 256, x2));
+	require(!los(y, x1, y + 256, x2));
+	require(!old_los(y, x1, y - 256, x2));
+	require(!los(y, x1, y - 256, x2));
+
+	require(projectable(y, x1, y, x2, PROJECT_NONE));
+	require(!projectable(y, x1, y + 256, x2, PROJECT_NONE));
+
+	/* The answer on the map is still there */
+	require(los(y, x1, y, x2));
+
+	ok;
+}
+
+struct test tests[] = {
+	{ "pairs", test_pairs },
+	{ "terrain", test_terrain },
+	{ "off_map", test_off_map },
+	{ NULL, NULL }
+};
@@ -0,0 +1,215 @@
+/*
+ * File: tests/cave/noise.c
+ * Purpose: Check the noise flow built by update_noise()
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+
+const char *suite_name = "cave/noise";
+
+int setup_tests(void **state)
+{
+	test_init_game();
+	test_new_player(1);
+	return 0;
+}
+
+int teardown_tests(void *state)
+{
+	test_cleanup_game();
+	return 0;
+}
+
+static byte bfs_cost[DUNGEON_HGT][DUNGEON_WID];
+static u16b bfs_queue[DUNGEON_HGT * DUNGEON_WID];
+
+/**
+ * The flow a full rebuild should give: a plain breadth-first search from
+ * the player over grids which let noise through, starting at "cost" and
+ * going out NOISE_STRENGTH grids.
+ */
+static void bfs_flow(int cost)
+{
+	int head = 0, tail = 0;
+	int d;
+
+	memset(bfs_cost, 0, sizeof(bfs_cost));
+
+	bfs_cost[p_ptr->py][p_ptr->px] = cost;
+	bfs_queue[tail++] = GRID(p_ptr->py, p_ptr->px);
+
+	while (head < tail) {
+		int y = GRID_Y(bfs_queue[head]);
+		int x = GRID_X(bfs_queue[head]);
+		int next = bfs_cost[y][x] + 1;
+
+		head++;
+		if (next > cost + NOISE_STRENGTH)
+			continue;
+
+		for (d = 0; d < 8; d++) {
+			int y2 = y + ddy_ddd[d];
+			int x2 = x + ddx_ddd[d];
+
+			if (!in_bounds(y2, x2) || bfs_cost[y2][x2])
+				continue;
+			if (tf_has(f_info[cave_feat[y2][x2]].flags, TF_NO_NOISE))
+				continue;
+
+			bfs_cost[y2][x2] = next;
+			bfs_queue[tail++] = GRID(y2, x2);
+		}
+	}
+}
+
+/**
+ * Count the grids where cave_cost differs from bfs_cost
+ */
+static int flow_mismatches(void)
+{
+	int y, x;
+	int bad = 0;
+
+	for (y = 0; y < DUNGEON_HGT; y++) {
+		for (x = 0; x < DUNGEON_WID; x++) {
+			if (cave_cost[y][x] == bfs_cost[y][x])
+				continue;
+
+			if (verbose && !bad)
+				printf("    player (%d, %d), grid (%d, %d): %d, not %d\n",
+					   p_ptr->py, p_ptr->px, y, x, cave_cost[y][x],
+					   bfs_cost[y][x]);
+			bad++;
+		}
+	}
+
+	return bad;
+}
+
+/**
+ * Count the grids with flow, other than the update center, which have no
+ * neighbour with a lower flow cost.  A monster on one of them could not
+ * follow the flow to the player.
+ */
+static int flow_dead_ends(void)
+{
+	int y, x, d;
+	int bad = 0;
+
+	for (y = 0; y < DUNGEON_HGT; y++) {
+		for (x = 0; x < DUNGEON_WID; x++) {
+			int cost = cave_cost[y][x];
+
+			if (!cost || ((y == update_center_y) && (x == update_center_x)))
+				continue;
+
+			for (d = 0; d < 8; d++) {
+				int y2 = y + ddy_ddd[d];
+				int x2 = x + ddx_ddd[d];
+
+				if (in_bounds(y2, x2) && cave_cost[y2][x2] &&
+					(cave_cost[y2][x2] < cost))
+					break;
+			}
+
+			if (d < 8)
+				continue;
+
+			if (verbose && !bad)
+				printf("    update center (%d, %d), grid (%d, %d): %d\n",
+					   update_center_y, update_center_x, y, x, cost);
+			bad++;
+		}
+	}
+
+	return bad;
+}
+
+/**
+ * A full rebuild on a new level gives exactly the breadth-first costs,
+ * with nothing left over from the last level or the last rebuild.
+ */
+static int test_rebuild(void *state)
+{
+	int level, n;
+
+	for (level = 0; level < 8; level++) {
+		test_new_level(300 + level, 5 + 6 * level);
+
+		for (n = 0; n < 10; n++) {
+			int y, x;
+
+			/* Far enough from the last flow center to rebuild */
+			do {
+				require(test_random_floor(&y, &x));
+			} while (n && (ABS(y - flow_center_y) < 15) &&
+					 (ABS(x - flow_center_x) < 15));
+			test_place_player(y, x);
+
+			update_noise();
+			require((flow_center_y == y) && (flow_center_x == x));
+			eq(cost_at_center, 100);
+
+			bfs_flow(100);
+			eq(flow_mismatches(), 0);
+		}
+	}
+
+	ok;
+}
+
+/**
+ * Walking around, the flow is sometimes re-centered and sometimes rebuilt.
+ * Either way every grid keeps a way down to the update center, and after
+ * each rebuild the costs are the breadth-first ones.
+ */
+static int test_walk_flow(void *state)
+{
+	int level, n;
+	int dir = 0;
+	int rebuilds = 0, recenters = 0;
+
+	for (level = 0; level < 4; level++) {
+		int y, x;
+
+		test_new_level(400 + level, 10 + 10 * level);
+		require(test_random_floor(&y, &x));
+		test_place_player(y, x);
+		update_noise();
+
+		for (n = 0; n < 500; n++) {
+			int old_cost = cost_at_center;
+			int old_y = flow_center_y;
+			int old_x = flow_center_x;
+
+			test_walk(&dir);
+			update_noise();
+
+			if ((cost_at_center == 100) && ((old_cost != 100) ||
+											(flow_center_y != old_y) ||
+											(flow_center_x != old_x))) {
+				rebuilds++;
+				bfs_flow(100);
+				eq(flow_mismatches(), 0);
+			} else if (cost_at_center < old_cost) {
+				recenters++;
+			}
+
+			eq(flow_dead_ends(), 0);
+		}
+	}
+
+	/* Both kinds of update happened */
+	require(rebuilds > 0);
+	require(recenters > 0);
+
+	ok;
+}
+
+struct test tests[] = {
+	{ "rebuild", test_rebuild },
+	{ "walk", test_walk_flow },
+	{ NULL, NULL }
+};
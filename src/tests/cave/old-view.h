@@ -0,0 +1,131 @@
+/*
+ * File: old-view.h
+ * Purpose: The field of view as update_view() found it before cave-view.c,
+ * by calling los() for every grid, as a reference for the tests and the
+ * benchmark
+ *
+ * Rather than setting SQUARE_VIEW and SQUARE_SEEN, old_view() records them
+ * in old_view_info[][] so that the two can be compared.  Only grids inside
+ * the dungeon are looked at.
+ */
+
+#ifndef INCLUDED_OLD_VIEW_H
+#define INCLUDED_OLD_VIEW_H
+
+#include "angband.h"
+#include "cave.h"
+
+#define OLD_VIEW	0x01
+#define OLD_SEEN	0x02
+
+static byte old_view_info[DUNGEON_HGT][DUNGEON_WID];
+
+static void old_become_viewable(int y, int x, int lit, int py, int px)
+{
+	int xc = x;
+	int yc = y;
+	if (old_view_info[y][x] & OLD_VIEW)
+		return;
+
+	old_view_info[y][x] |= OLD_VIEW;
+
+	if (lit)
+		old_view_info[y][x] |= OLD_SEEN;
+
+	if (square_has(y, x, SQUARE_GLOW)) {
+		if (cave_iswall(y, x)) {
+			/* For walls, move a bit towards the player */
+			xc = (x < px) ? (x + 1) : (x > px) ? (x - 1) : x;
+			yc = (y < py) ? (y + 1) : (y > py) ? (y - 1) : y;
+		}
+		if (square_has(yc, xc, SQUARE_GLOW))
+			old_view_info[y][x] |= OLD_SEEN;
+	}
+}
+
+static void old_update_view_one(int y, int x, int radius, int py, int px)
+{
+	int xc = x;
+	int yc = y;
+
+	int d = distance(y, x, py, px);
+	int lit = d < radius;
+
+	if (d > MAX_SIGHT)
+		return;
+
+	/* Walls steal LOS from the grid next to them towards the player */
+	if (cave_iswall(y, x)) {
+		int dx = x - px;
+		int dy = y - py;
+		int ax = ABS(dx);
+		int ay = ABS(dy);
+		int sx = dx > 0 ? 1 : -1;
+		int sy = dy > 0 ? 1 : -1;
+
+		xc = (x < px) ? (x + 1) : (x > px) ? (x - 1) : x;
+		yc = (y < py) ? (y + 1) : (y > py) ? (y - 1) : y;
+
+		/* Not through double-thickness walls */
+		if (cave_iswall(yc, xc)) {
+			xc = x;
+			yc = y;
+		}
+
+		/* Not by the 'knight's move' rule */
+		if (ax == 2 && ay == 1) {
+			if (!cave_iswall(y, x - sx) && cave_iswall(y - sy, x - sx)) {
+				xc = x;
+				yc = y;
+			}
+		} else if (ax == 1 && ay == 2) {
+			if (cave_iswall(y - sy, x) && cave_iswall(y - sy, x - sx)) {
+				xc = x;
+				yc = y;
+			}
+		}
+	}
+
+	if (los(py, px, yc, xc))
+		old_become_viewable(y, x, lit, py, px);
+}
+
+static void old_view(void)
+{
+	int x, y;
+	int py = p_ptr->py;
+	int px = p_ptr->px;
+
+	int radius;
+
+	memset(old_view_info, 0, sizeof(old_view_info));
+
+	/* Extract "radius" value */
+	if ((player_has(PF_UNLIGHT) || p_ptr->state.darkness)
+		&& (p_ptr->cur_light <= 0))
+		radius = 2;
+	else
+		radius = p_ptr->cur_light;
+
+	/* Handle real light */
+	if (radius > 0)
+		++radius;
+
+	/* Assume we can view the player grid */
+	old_view_info[py][px] |= OLD_VIEW;
+	if (radius > 0 || square_has(py, px, SQUARE_GLOW))
+		old_view_info[py][px] |= OLD_SEEN;
+
+	/* View squares we have LOS to */
+	for (y = 0; y < DUNGEON_HGT; y++)
+		for (x = 0; x < DUNGEON_WID; x++)
+			old_update_view_one(y, x, radius, py, px);
+
+	/* The blind see nothing */
+	if (p_ptr->timed[TMD_BLIND])
+		for (y = 0; y < DUNGEON_HGT; y++)
+			for (x = 0; x < DUNGEON_WID; x++)
+				old_view_info[y][x] &= ~OLD_SEEN;
+}
+
+#endif /* INCLUDED_OLD_VIEW_H */
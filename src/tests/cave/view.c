@@ -0,0 +1,137 @@
+/*
+ * File: tests/cave/view.c
+ * Purpose: Check update_view() against the old whole-map los() sweep
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave/old-view.h"
+
+const char *suite_name = "cave/view";
+
+int setup_tests(void **state)
+{
+	test_init_game();
+	test_new_player(1);
+	return 0;
+}
+
+int teardown_tests(void *state)
+{
+	test_cleanup_game();
+	return 0;
+}
+
+/**
+ * Count the grids where update_view() and old_view() disagree about
+ * SQUARE_VIEW or SQUARE_SEEN.
+ */
+static int view_mismatches(void)
+{
+	int y, x;
+	int bad = 0;
+
+	old_view();
+
+	for (y = 0; y < DUNGEON_HGT; y++) {
+		for (x = 0; x < DUNGEON_WID; x++) {
+			byte info = 0;
+
+			if (square_has(y, x, SQUARE_VIEW))
+				info |= OLD_VIEW;
+			if (square_has(y, x, SQUARE_SEEN))
+				info |= OLD_SEEN;
+
+			if (info == old_view_info[y][x])
+				continue;
+
+			if (verbose && !bad)
+				printf("    player (%d, %d), grid (%d, %d): %d, not %d\n",
+					   p_ptr->py, p_ptr->px, y, x, info,
+					   old_view_info[y][x]);
+			bad++;
+		}
+	}
+
+	return bad;
+}
+
+/**
+ * Move around a range of levels with different light radii, sometimes
+ * blind, so that the view is calculated from scratch every time.
+ */
+static int test_positions(void *state)
+{
+	int level, n;
+
+	for (level = 0; level < 6; level++) {
+		test_new_level(100 + level, 5 + 8 * level);
+
+		for (n = 0; n < 50; n++) {
+			int y, x;
+
+			require(test_random_floor(&y, &x));
+			test_place_player(y, x);
+
+			p_ptr->cur_light = n % 4;
+			p_ptr->timed[TMD_BLIND] = (n % 7) ? 0 : 10;
+			update_view();
+
+			eq(view_mismatches(), 0);
+		}
+	}
+
+	p_ptr->timed[TMD_BLIND] = 0;
+	ok;
+}
+
+/**
+ * Change walls and lighting near a player who stays put, so that only the
+ * grids behind the changes are recalculated.
+ */
+static int test_changes(void *state)
+{
+	int y, x, n;
+
+	test_new_level(200, 20);
+	require(test_random_floor(&y, &x));
+	test_place_player(y, x);
+	p_ptr->cur_light = 2;
+	update_view();
+	eq(view_mismatches(), 0);
+
+	for (n = 0; n < 400; n++) {
+		int ty = p_ptr->py + rand_spread(0, 8);
+		int tx = p_ptr->px + rand_spread(0, 8);
+
+		if (!in_bounds_fully(ty, tx) || cave_m_idx[ty][tx] ||
+			cave_o_idx[ty][tx])
+			continue;
+
+		switch (n % 4) {
+		case 0:
+			cave_set_feat(ty, tx, FEAT_WALL_EXTRA);
+			break;
+		case 1:
+			cave_set_feat(ty, tx, FEAT_FLOOR);
+			break;
+		case 2:
+			square_on(ty, tx, SQUARE_GLOW);
+			break;
+		default:
+			square_off(ty, tx, SQUARE_GLOW);
+			break;
+		}
+
+		update_view();
+		eq(view_mismatches(), 0);
+	}
+
+	ok;
+}
+
+struct test tests[] = {
+	{ "positions", test_positions },
+	{ "changes", test_changes },
+	{ NULL, NULL }
+};
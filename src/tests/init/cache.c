@@ -0,0 +1,424 @@
+/*
+ * File: tests/init/cache.c
+ * Purpose: Check that info arrays loaded from their binary caches match
+ * the ones parsed from the template files
+ *
+ * The arrays are parsed once, into a private user directory which gets the
+ * caches, and kept.  Each test then sets up the caches some way and runs
+ * init_angband() again.  A cache file's modification time shows whether it
+ * was loaded (left alone) or parsed again (written afresh).
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "init/caches.h"
+
+#include <sys/stat.h>
+#include <utime.h>
+
+const char *suite_name = "init/cache";
+
+/**
+ * A modification time which is newer than any template file
+ */
+#define CACHE_FUTURE	((time_t) 4000000000UL)
+
+/**
+ * The arrays as parsed from the templates, with copies of their strings
+ */
+static char *parsed[N_ELEMENTS(cached_arrays)];
+static size_t parsed_count[N_ELEMENTS(cached_arrays)];
+
+/**
+ * Number of records in a cached array
+ */
+static size_t cached_count(const struct cached_array *ca)
+{
+	return *(u16b *) ((char *) z_info + ca->max);
+}
+
+/**
+ * Read a pointer field of a record
+ */
+static void *field_get(const char *record, size_t offset)
+{
+	void *value;
+
+	memcpy(&value, record + offset, sizeof(value));
+	return value;
+}
+
+/**
+ * Write a pointer field of a record
+ */
+static void field_put(char *record, size_t offset, const void *value)
+{
+	memcpy(record + offset, &value, sizeof(value));
+}
+
+/**
+ * Copy an array, with its own copies of the strings.  A monster race's base
+ * is kept as the base's name, since the bases are parsed afresh each time.
+ */
+static char *array_copy(const struct cached_array *ca)
+{
+	size_t count = cached_count(ca);
+	char *copy = mem_zalloc(count * ca->size + 1);
+	size_t i;
+	int j;
+
+	memcpy(copy, *ca->info, count * ca->size);
+
+	for (i = 0; i < count; i++) {
+		char *record = copy + i * ca->size;
+
+		for (j = 0; j < ca->num_strings; j++) {
+			const char *str = field_get(record, ca->strings[j]);
+
+			field_put(record, ca->strings[j], str ? string_make(str) : NULL);
+		}
+
+		field_put(record, ca->next, NULL);
+
+		if (ca->info == (void **) &r_info) {
+			monster_race *r_ptr = (monster_race *) record;
+
+			field_put(record, offsetof(monster_race, base),
+					  r_ptr->base ? string_make(r_ptr->base->name) : NULL);
+		}
+	}
+
+	return copy;
+}
+
+/**
+ * Free a copy of an array
+ */
+static void array_free(const struct cached_array *ca, char *copy, size_t count)
+{
+	size_t i;
+	int j;
+
+	for (i = 0; i < count; i++) {
+		char *record = copy + i * ca->size;
+
+		for (j = 0; j < ca->num_strings; j++)
+			string_free(field_get(record, ca->strings[j]));
+
+		if (ca->info == (void **) &r_info)
+			string_free(field_get(record, offsetof(monster_race, base)));
+	}
+
+	mem_free(copy);
+}
+
+/**
+ * Compare two copies of an array.  Strings must be equal, and every other
+ * byte of each record the same.  Return the index of the first record
+ * which differs, or -1.
+ */
+static int array_differs(const struct cached_array *ca, const char *a,
+						 const char *b, size_t count)
+{
+	char *ra = mem_alloc(ca->size);
+	char *rb = mem_alloc(ca->size);
+	int differs = -1;
+	size_t i;
+	int j;
+
+	for (i = 0; (differs < 0) && (i < count); i++) {
+		memcpy(ra, a + i * ca->size, ca->size);
+		memcpy(rb, b + i * ca->size, ca->size);
+
+		for (j = 0; j < ca->num_strings; j++) {
+			const char *sa = field_get(ra, ca->strings[j]);
+			const char *sb = field_get(rb, ca->strings[j]);
+
+			if ((!sa != !sb) || (sa && !streq(sa, sb)))
+				differs = i;
+
+			field_put(ra, ca->strings[j], NULL);
+			field_put(rb, ca->strings[j], NULL);
+		}
+
+		if (ca->info == (void **) &r_info) {
+			const char *sa = field_get(ra, offsetof(monster_race, base));
+			const char *sb = field_get(rb, offsetof(monster_race, base));
+
+			if ((!sa != !sb) || (sa && !streq(sa, sb)))
+				differs = i;
+
+			field_put(ra, offsetof(monster_race, base), NULL);
+			field_put(rb, offsetof(monster_race, base), NULL);
+		}
+
+		if (memcmp(ra, rb, ca->size))
+			differs = i;
+	}
+
+	mem_free(rb);
+	mem_free(ra);
+	return differs;
+}
+
+/**
+ * Compare the arrays now loaded with the parsed ones.  Return the index
+ * of the first array which differs, or -1.
+ */
+static int arrays_differ(void)
+{
+	size_t i;
+
+	for (i = 0; i < N_ELEMENTS(cached_arrays); i++) {
+		const struct cached_array *ca = &cached_arrays[i];
+		size_t count = cached_count(ca);
+		char *copy;
+		int differs;
+
+		if (count != parsed_count[i])
+			return i;
+
+		copy = array_copy(ca);
+		differs = array_differs(ca, parsed[i], copy, count);
+		array_free(ca, copy, count);
+
+		if (differs >= 0) {
+			if (verbose)
+				printf("  %s record %d differs\n", ca->name, differs);
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * Modification time of the cache file of an array, or 0 if it is missing
+ */
+static time_t cache_mtime(const struct cached_array *ca)
+{
+	char path[1024];
+	struct stat st;
+
+	cached_path(path, sizeof(path), ca);
+	if (stat(path, &st))
+		return 0;
+
+	return st.st_mtime;
+}
+
+/**
+ * Set the modification time of the cache file of an array
+ */
+static bool cache_touch(const struct cached_array *ca, time_t when)
+{
+	char path[1024];
+	struct utimbuf times;
+
+	cached_path(path, sizeof(path), ca);
+	times.actime = when;
+	times.modtime = when;
+	return !utime(path, &times);
+}
+
+/**
+ * Date every cache file after the templates, so they are all used
+ */
+static bool caches_touch(void)
+{
+	size_t i;
+
+	for (i = 0; i < N_ELEMENTS(cached_arrays); i++)
+		if (!cache_touch(&cached_arrays[i], CACHE_FUTURE))
+			return FALSE;
+
+	return TRUE;
+}
+
+/**
+ * Flip the bits of one byte of the cache file of an array
+ */
+static bool cache_flip(const struct cached_array *ca, long offset)
+{
+	char path[1024];
+	FILE *fp;
+	int c;
+	bool done;
+
+	cached_path(path, sizeof(path), ca);
+	fp = fopen(path, "r+b");
+	if (!fp)
+		return FALSE;
+
+	done = (!fseek(fp, offset, SEEK_SET) && ((c = fgetc(fp)) != EOF) &&
+			!fseek(fp, offset, SEEK_SET) && (fputc(c ^ 0xFF, fp) != EOF));
+	fclose(fp);
+
+	return done;
+}
+
+/**
+ * Cut the cache file of an array down to a few bytes
+ */
+static bool cache_truncate(const struct cached_array *ca)
+{
+	char path[1024];
+	FILE *fp;
+	bool done;
+
+	cached_path(path, sizeof(path), ca);
+	fp = fopen(path, "wb");
+	if (!fp)
+		return FALSE;
+
+	done = (fputs("raw", fp) != EOF);
+	fclose(fp);
+
+	return done;
+}
+
+/**
+ * The monster cache, which is the largest and the only one with a pointer
+ * to turn into an index
+ */
+static struct cached_array *monster_cache(void)
+{
+	size_t i;
+
+	for (i = 0; i < N_ELEMENTS(cached_arrays); i++)
+		if (streq(cached_arrays[i].name, "monster"))
+			return &cached_arrays[i];
+
+	return NULL;
+}
+
+int setup_tests(void **state)
+{
+	size_t i;
+
+	test_init_paths();
+	if (!cache_dir_make())
+		return 1;
+
+	init_angband();
+
+	for (i = 0; i < N_ELEMENTS(cached_arrays); i++) {
+		parsed[i] = array_copy(&cached_arrays[i]);
+		parsed_count[i] = cached_count(&cached_arrays[i]);
+	}
+
+	return 0;
+}
+
+int teardown_tests(void *state)
+{
+	size_t i;
+
+	for (i = 0; i < N_ELEMENTS(cached_arrays); i++)
+		array_free(&cached_arrays[i], parsed[i], parsed_count[i]);
+
+	cache_dir_remove();
+	test_cleanup_game();
+	return 0;
+}
+
+/**
+ * Parsing the templates writes a cache of every array
+ */
+static int test_written(void *state)
+{
+	size_t i;
+
+	for (i = 0; i < N_ELEMENTS(cached_arrays); i++)
+		require(cache_mtime(&cached_arrays[i]) > 0);
+
+	ok;
+}
+
+/**
+ * Up to date caches are loaded, and give the arrays the templates do
+ */
+static int test_loaded(void *state)
+{
+	size_t i;
+
+	require(caches_touch());
+	init_angband();
+
+	for (i = 0; i < N_ELEMENTS(cached_arrays); i++)
+		eq(cache_mtime(&cached_arrays[i]), CACHE_FUTURE);
+
+	eq(arrays_differ(), -1);
+	ok;
+}
+
+/**
+ * A cache older than its template is parsed again
+ */
+static int test_stale(void *state)
+{
+	struct cached_array *ca = monster_cache();
+
+	require(ca);
+	require(caches_touch());
+	require(cache_touch(ca, 1));
+	init_angband();
+
+	require(cache_mtime(ca) != 1);
+	require(cache_mtime(ca) != CACHE_FUTURE);
+	eq(arrays_differ(), -1);
+	ok;
+}
+
+/**
+ * A cache with the wrong hash of its templates is parsed again
+ */
+static int test_hash(void *state)
+{
+	struct cached_array *ca = monster_cache();
+
+	/* The hash follows the version string and the format */
+	require(ca);
+	require(cache_flip(ca, 64 + sizeof(u32b)));
+	require(caches_touch());
+	init_angband();
+
+	require(cache_mtime(ca) != CACHE_FUTURE);
+	eq(arrays_differ(), -1);
+	ok;
+}
+
+/**
+ * A cut short cache is parsed again, and written whole
+ */
+static int test_damaged(void *state)
+{
+	struct cached_array *ca = monster_cache();
+	char path[1024];
+	struct stat st;
+	off_t size;
+
+	require(ca);
+	cached_path(path, sizeof(path), ca);
+	require(!stat(path, &st));
+	size = st.st_size;
+
+	require(cache_truncate(ca));
+	require(caches_touch());
+	init_angband();
+
+	require(cache_mtime(ca) != CACHE_FUTURE);
+	require(!stat(path, &st));
+	eq(st.st_size, size);
+	eq(arrays_differ(), -1);
+	ok;
+}
+
+struct test tests[] = {
+	{ "written", test_written },
+	{ "loaded", test_loaded },
+	{ "stale", test_stale },
+	{ "hash", test_hash },
+	{ "damaged", test_damaged },
+	{ NULL, NULL }
+};
@@ -0,0 +1,106 @@
+/*
+ * File: tests/init/caches.h
+ * Purpose: The info arrays init_angband() keeps in binary caches, and a
+ * private user directory for those caches to go in
+ *
+ * The table mirrors the one in init.c, which is private to it.
+ */
+
+#ifndef INCLUDED_TESTS_CACHES_H
+#define INCLUDED_TESTS_CACHES_H
+
+#include "angband.h"
+#include "generate.h"
+#include "init.h"
+#include "monster.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+struct cached_array {
+	const char *name;	/**< Template name, and so cache name */
+	void **info;		/**< The info array */
+	size_t max;		/**< Offset of its size in z_info */
+	size_t size;		/**< Size of a record */
+	size_t next;		/**< Offset of the list pointer */
+	size_t strings[3];	/**< Offsets of string fields */
+	int num_strings;
+};
+
+static struct cached_array cached_arrays[] = {
+	{ "terrain", (void **) &f_info, offsetof(maxima, f_max),
+	  sizeof(feature_type), offsetof(feature_type, next),
+	  { offsetof(feature_type, name), offsetof(feature_type, text) }, 2 },
+	{ "object", (void **) &k_info, offsetof(maxima, k_max),
+	  sizeof(object_kind), offsetof(object_kind, next),
+	  { offsetof(object_kind, name), offsetof(object_kind, text) }, 2 },
+	{ "ego_item", (void **) &e_info, offsetof(maxima, e_max),
+	  sizeof(ego_item_type), offsetof(ego_item_type, next),
+	  { offsetof(ego_item_type, name), offsetof(ego_item_type, text) }, 2 },
+	{ "monster", (void **) &r_info, offsetof(maxima, r_max),
+	  sizeof(monster_race), offsetof(monster_race, next),
+	  { offsetof(monster_race, name), offsetof(monster_race, text) }, 2 },
+	{ "artifact", (void **) &a_info, offsetof(maxima, a_max),
+	  sizeof(artifact_type), offsetof(artifact_type, next),
+	  { offsetof(artifact_type, name), offsetof(artifact_type, text),
+	    offsetof(artifact_type, effect_msg) }, 3 },
+	{ "vault", (void **) &v_info, offsetof(maxima, v_max),
+	  sizeof(struct vault), offsetof(struct vault, next),
+	  { offsetof(struct vault, name), offsetof(struct vault, message),
+	    offsetof(struct vault, text) }, 3 },
+	{ "themed", (void **) &t_info, offsetof(maxima, t_max),
+	  sizeof(struct vault), offsetof(struct vault, next),
+	  { offsetof(struct vault, name), offsetof(struct vault, message),
+	    offsetof(struct vault, text) }, 3 },
+};
+
+static char cache_dir[] = "/tmp/ponyband-cache-XXXXXX";
+
+/**
+ * Path of the cache file of an array
+ */
+static void cached_path(char *buf, size_t len, const struct cached_array *ca)
+{
+	path_build(buf, len, ANGBAND_DIR_USER, format("%s.raw", ca->name));
+}
+
+/**
+ * Make an empty directory and use it as the user directory, so the caches
+ * init_angband() finds there are only ever the ones written by this run.
+ * Call after the paths are set up.
+ */
+static bool cache_dir_make(void)
+{
+	if (!mkdtemp(cache_dir))
+		return FALSE;
+
+	string_free(ANGBAND_DIR_USER);
+	ANGBAND_DIR_USER = string_make(cache_dir);
+	return TRUE;
+}
+
+/**
+ * Delete the cache files, so the next init_angband() parses every template
+ */
+static void cache_files_remove(void)
+{
+	char path[1024];
+	size_t i;
+
+	for (i = 0; i < N_ELEMENTS(cached_arrays); i++) {
+		cached_path(path, sizeof(path), &cached_arrays[i]);
+		if (file_exists(path))
+			file_delete(path);
+	}
+}
+
+/**
+ * Delete the cache files and the directory they are in
+ */
+static void cache_dir_remove(void)
+{
+	cache_files_remove();
+	rmdir(cache_dir);
+}
+
+#endif /* INCLUDED_TESTS_CACHES_H */
@@ -0,0 +1,142 @@
+/*
+ * File: tests/parse/old-tokenize.h
+ * Purpose: The way parser_parse() split lines before it tokenized them in
+ * place, kept to check and time the new way against
+ *
+ * The old way copied the line, split it with strtok(), allocated a value
+ * for every field and copied every sym and str field, then freed all of it
+ * when the next line came.  Only the splitting is kept here: the fields of
+ * a line are described by a string of kinds, 's' for a sym (ended by ':')
+ * and 'S' for a str (the rest of the line).
+ */
+
+#ifndef INCLUDED_TESTS_OLD_TOKENIZE_H
+#define INCLUDED_TESTS_OLD_TOKENIZE_H
+
+#include "angband.h"
+#include "parser.h"
+
+#include <ctype.h>
+
+struct old_value {
+	struct old_value *next;
+	char *sval;
+};
+
+static char old_dir[1024];
+static struct old_value *old_fhead;
+static struct old_value *old_ftail;
+
+/**
+ * Free the values of the last line
+ */
+static void old_freeold(void)
+{
+	struct old_value *v;
+
+	while (old_fhead) {
+		v = old_fhead->next;
+		mem_free(old_fhead->sval);
+		mem_free(old_fhead);
+		old_fhead = v;
+	}
+
+	old_ftail = NULL;
+}
+
+/**
+ * Split a line into its directive, left in old_dir, and up to
+ * strlen(kinds) fields, left in the list at old_fhead.  Return the number
+ * of fields, or -1 for a blank line or comment.
+ */
+static int old_tokenize(const char *line, const char *kinds)
+{
+	char *cline;
+	char *tok;
+	int n = 0;
+
+	old_freeold();
+	old_dir[0] = '\0';
+
+	while (*line && (isspace(*line)))
+		line++;
+	if (!*line || *line == '#')
+		return -1;
+
+	cline = string_make(line);
+
+	tok = strtok(cline, ":");
+	if (!tok) {
+		mem_free(cline);
+		return 0;
+	}
+	my_strcpy(old_dir, tok, sizeof(old_dir));
+
+	for (; kinds[n]; n++) {
+		struct old_value *v;
+
+		tok = strtok(NULL, (kinds[n] == 'S') ? "" : ":");
+		if (!tok)
+			break;
+
+		v = mem_alloc(sizeof *v);
+		v->next = NULL;
+		v->sval = string_make(tok);
+		if (!old_fhead)
+			old_fhead = v;
+		else
+			old_ftail->next = v;
+		old_ftail = v;
+	}
+
+	mem_free(cline);
+	return n;
+}
+
+/**
+ * The most directives kinds_parser() handles
+ */
+#define KINDS_MAX_DIRS	64
+
+/**
+ * Make a parser which splits every line in "lines" the way old_tokenize()
+ * does with "kinds": each directive gets a hook, run by "func", whose
+ * fields are all optional and named f0, f1 and so on.
+ */
+static struct parser *kinds_parser(char **lines, int count, const char *kinds,
+								   enum parser_error (*func)(struct parser *p))
+{
+	struct parser *p = parser_new();
+	char *dirs[KINDS_MAX_DIRS];
+	int num_dirs = 0;
+	char fmt[1024];
+	int i, j;
+
+	for (i = 0; i < count; i++) {
+		if (old_tokenize(lines[i], "") < 0)
+			continue;
+
+		for (j = 0; j < num_dirs; j++)
+			if (streq(dirs[j], old_dir))
+				break;
+		if ((j < num_dirs) || (num_dirs == KINDS_MAX_DIRS))
+			continue;
+		dirs[num_dirs++] = string_make(old_dir);
+
+		my_strcpy(fmt, old_dir, sizeof(fmt));
+		for (j = 0; kinds[j]; j++)
+			my_strcat(fmt, format(" ?%s f%d", (kinds[j] == 'S') ? "str" :
+								  "sym", j), sizeof(fmt));
+
+		if (parser_reg(p, fmt, func))
+			quit_fmt("Bad format '%s'", fmt);
+	}
+
+	for (j = 0; j < num_dirs; j++)
+		string_free(dirs[j]);
+	old_freeold();
+
+	return p;
+}
+
+#endif /* INCLUDED_TESTS_OLD_TOKENIZE_H */
@@ -0,0 +1,369 @@
+/*
+ * File: tests/parse/parser.c
+ * Purpose: Check how parser_parse() splits lines into fields
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "parse/old-tokenize.h"
+
+const char *suite_name = "parse/parser";
+
+int setup_tests(void **state)
+{
+	test_init_paths();
+	return 0;
+}
+
+int teardown_tests(void *state)
+{
+	return 0;
+}
+
+/**
+ * How many times a counting hook has run
+ */
+static int hook_runs;
+
+static enum parser_error count_hook(struct parser *p)
+{
+	hook_runs++;
+	return PARSE_ERROR_NONE;
+}
+
+/**
+ * Fields of every type
+ */
+static int test_types(void *state)
+{
+	struct parser *p = parser_new();
+	random_value r;
+
+	require(!parser_reg(p, "test int i uint u sym s rand r str rest", ignored));
+
+	eq(parser_parse(p, "test:-5:0x10:foo:1+2d3M4:the rest: with a colon"),
+	   PARSE_ERROR_NONE);
+	eq(parser_getint(p, "i"), -5);
+	eq(parser_getuint(p, "u"), 16);
+	require(streq(parser_getsym(p, "s"), "foo"));
+	r = parser_getrand(p, "r");
+	eq(r.base, 1);
+	eq(r.dice, 2);
+	eq(r.sides, 3);
+	eq(r.m_bonus, 4);
+	require(streq(parser_getstr(p, "rest"), "the rest: with a colon"));
+
+	parser_destroy(p);
+	ok;
+}
+
+/**
+ * Empty fields are skipped, as strtok() skips them
+ */
+static int test_empty(void *state)
+{
+	struct parser *p = parser_new();
+
+	require(!parser_reg(p, "e sym a sym b ?sym c", ignored));
+
+	eq(parser_parse(p, "e::x:::y:"), PARSE_ERROR_NONE);
+	require(streq(parser_getsym(p, "a"), "x"));
+	require(streq(parser_getsym(p, "b"), "y"));
+	require(!parser_hasval(p, "c"));
+
+	parser_destroy(p);
+	ok;
+}
+
+/**
+ * A char field is one character, followed by a ':' if anything, so it can
+ * be a ':' itself, and can end the line
+ */
+static int test_char(void *state)
+{
+	struct parser *p = parser_new();
+
+	require(!parser_reg(p, "c char ch ?sym s", ignored));
+	require(!parser_reg(p, "t char ch str text", ignored));
+
+	eq(parser_parse(p, "c:x:red"), PARSE_ERROR_NONE);
+	eq(parser_getchar(p, "ch"), L'x');
+	require(streq(parser_getsym(p, "s"), "red"));
+
+	eq(parser_parse(p, "c:::blue"), PARSE_ERROR_NONE);
+	eq(parser_getchar(p, "ch"), L':');
+	require(streq(parser_getsym(p, "s"), "blue"));
+
+	eq(parser_parse(p, "c:y"), PARSE_ERROR_NONE);
+	eq(parser_getchar(p, "ch"), L'y');
+	require(!parser_hasval(p, "s"));
+
+	/* Only the one ':' after the char is passed over */
+	eq(parser_parse(p, "t:z::the rest"), PARSE_ERROR_NONE);
+	eq(parser_getchar(p, "ch"), L'z');
+	require(streq(parser_getstr(p, "text"), ":the rest"));
+
+	parser_destroy(p);
+	ok;
+}
+
+/**
+ * Errors name the field, and leave the parser's state set
+ */
+static int test_errors(void *state)
+{
+	struct parser *p = parser_new();
+	struct parser_state s;
+
+	require(!parser_reg(p, "m int a int b", ignored));
+	require(!parser_reg(p, "u uint a", ignored));
+	require(!parser_reg(p, "r rand a", ignored));
+
+	eq(parser_parse(p, "m:1"), PARSE_ERROR_MISSING_FIELD);
+	require(parser_getstate(p, &s));
+	eq(s.line, 1);
+	require(streq(s.msg, "b"));
+
+	eq(parser_parse(p, "m:1:two"), PARSE_ERROR_NOT_NUMBER);
+	eq(parser_parse(p, "u:-1"), PARSE_ERROR_NOT_NUMBER);
+	eq(parser_parse(p, "r:2d"), PARSE_ERROR_NOT_RANDOM);
+
+	eq(parser_parse(p, "zzz:1"), PARSE_ERROR_UNDEFINED_DIRECTIVE);
+	require(parser_getstate(p, &s));
+	require(streq(s.msg, "zzz"));
+
+	eq(parser_parse(p, ":::"), PARSE_ERROR_MISSING_FIELD);
+
+	parser_destroy(p);
+	ok;
+}
+
+/**
+ * Blank lines and comments are passed over without running a hook
+ */
+static int test_comments(void *state)
+{
+	struct parser *p = parser_new();
+
+	require(!parser_reg(p, "x ?sym a", count_hook));
+
+	hook_runs = 0;
+	eq(parser_parse(p, ""), PARSE_ERROR_NONE);
+	eq(parser_parse(p, "   \t"), PARSE_ERROR_NONE);
+	eq(parser_parse(p, "# x:1"), PARSE_ERROR_NONE);
+	eq(parser_parse(p, "  # x:1"), PARSE_ERROR_NONE);
+	eq(hook_runs, 0);
+
+	eq(parser_parse(p, "  x:1"), PARSE_ERROR_NONE);
+	eq(hook_runs, 1);
+
+	parser_destroy(p);
+	ok;
+}
+
+/**
+ * Bad formats are refused
+ */
+static int test_formats(void *state)
+{
+	struct parser *p = parser_new();
+
+	require(parser_reg(p, "x ?int a int b", ignored));
+	require(parser_reg(p, "x str a int b", ignored));
+	require(parser_reg(p, "x foo a", ignored));
+	require(parser_reg(p, "x int", ignored));
+	require(parser_reg(p, "", ignored));
+
+	/* A later hook supersedes an earlier one for the same directive */
+	require(!parser_reg(p, "x int a", ignored));
+	require(!parser_reg(p, "x sym a", ignored));
+	eq(parser_parse(p, "x:word"), PARSE_ERROR_NONE);
+	require(streq(parser_getsym(p, "a"), "word"));
+
+	parser_destroy(p);
+	ok;
+}
+
+/**
+ * Lines longer than any before them are parsed whole
+ */
+static int test_long(void *state)
+{
+	struct parser *p = parser_new();
+	char *line = mem_alloc(5000);
+	int i;
+
+	require(!parser_reg(p, "d sym a str text", ignored));
+
+	my_strcpy(line, "d:a:", 5000);
+	for (i = 4; i < 4999; i++)
+		line[i] = 'a' + i % 26;
+	line[4999] = '\0';
+
+	eq(parser_parse(p, "d:a:short"), PARSE_ERROR_NONE);
+	require(streq(parser_getstr(p, "text"), "short"));
+
+	eq(parser_parse(p, line), PARSE_ERROR_NONE);
+	require(streq(parser_getstr(p, "text"), line + 4));
+
+	eq(parser_parse(p, "d:b:short again"), PARSE_ERROR_NONE);
+	require(streq(parser_getsym(p, "a"), "b"));
+	require(streq(parser_getstr(p, "text"), "short again"));
+
+	mem_free(line);
+	parser_destroy(p);
+	ok;
+}
+
+/**
+ * The parser inside a hook, which one hook parses a line with
+ */
+static struct parser *inner;
+
+static enum parser_error outer_hook(struct parser *p)
+{
+	enum parser_error r = parser_parse(inner, "b:3:4");
+
+	if (r)
+		return r;
+
+	/* The outer line's values must be untouched */
+	if (!streq(parser_getsym(p, "x"), "1") ||
+		!streq(parser_getsym(p, "y"), "2"))
+		return PARSE_ERROR_GENERIC;
+
+	return PARSE_ERROR_NONE;
+}
+
+/**
+ * Parsers keep their own state, so one can be used while another is part
+ * way through a line
+ */
+static int test_interleaved(void *state)
+{
+	struct parser *p = parser_new();
+
+	inner = parser_new();
+	require(!parser_reg(p, "a sym x sym y", outer_hook));
+	require(!parser_reg(inner, "b sym x sym y", ignored));
+
+	eq(parser_parse(p, "a:1:2"), PARSE_ERROR_NONE);
+	require(streq(parser_getsym(p, "x"), "1"));
+	require(streq(parser_getsym(p, "y"), "2"));
+	require(streq(parser_getsym(inner, "x"), "3"));
+	require(streq(parser_getsym(inner, "y"), "4"));
+
+	parser_destroy(inner);
+	parser_destroy(p);
+	ok;
+}
+
+/**
+ * The fields the capturing hook last saw
+ */
+#define CAPTURE_MAX	16
+
+static const char *capture_kinds;
+static char captured[CAPTURE_MAX][1024];
+static int num_captured;
+
+static enum parser_error capture_hook(struct parser *p)
+{
+	int i;
+
+	hook_runs++;
+	for (num_captured = 0, i = 0; capture_kinds[i]; i++) {
+		const char *name = format("f%d", i);
+
+		if (!parser_hasval(p, name))
+			break;
+
+		my_strcpy(captured[num_captured++], (capture_kinds[i] == 'S') ?
+				  parser_getstr(p, name) : parser_getsym(p, name),
+				  sizeof(captured[0]));
+	}
+
+	return PARSE_ERROR_NONE;
+}
+
+/**
+ * Every line of every template file splits into the same fields as it
+ * did with strtok()
+ */
+static int test_templates(void *state)
+{
+	static const char *names[] = {
+		"limits", "object", "artifact", "set_item", "names", "trap",
+		"terrain", "ego_item", "monster_base", "monster", "shop_own",
+		"p_race", "ability", "p_class", "p_mark", "vault", "themed",
+		"p_hist", "flavor", "spell", "hints", "pain"
+	};
+	static const char *kinds[] = {
+		"ssssssssssssssss", "S", "sS", "ssS", "sssS"
+	};
+	size_t f, k;
+	int lines_checked = 0;
+
+	for (f = 0; f < N_ELEMENTS(names); f++) {
+		int count, i;
+		char **lines = test_read_template(names[f], &count);
+
+		require(lines);
+
+		for (k = 0; k < N_ELEMENTS(kinds); k++) {
+			struct parser *p = kinds_parser(lines, count, kinds[k],
+											capture_hook);
+
+			capture_kinds = kinds[k];
+
+			for (i = 0; i < count; i++) {
+				struct old_value *v;
+				int n_old, n;
+
+				hook_runs = 0;
+				num_captured = 0;
+				eq(parser_parse(p, lines[i]), PARSE_ERROR_NONE);
+				n_old = old_tokenize(lines[i], kinds[k]);
+
+				if (n_old < 0) {
+					eq(hook_runs, 0);
+					continue;
+				}
+
+				if (verbose && (num_captured != n_old))
+					printf("  %s line %d\n", names[f], i + 1);
+				eq(hook_runs, 1);
+				eq(num_captured, n_old);
+
+				for (n = 0, v = old_fhead; v; n++, v = v->next) {
+					if (verbose && !streq(captured[n], v->sval))
+						printf("  %s line %d\n", names[f], i + 1);
+					require(streq(captured[n], v->sval));
+				}
+
+				lines_checked++;
+			}
+
+			old_freeold();
+			parser_destroy(p);
+		}
+
+		test_free_lines(lines, count);
+	}
+
+	require(lines_checked > 0);
+	ok;
+}
+
+struct test tests[] = {
+	{ "types", test_types },
+	{ "empty", test_empty },
+	{ "char", test_char },
+	{ "errors", test_errors },
+	{ "comments", test_comments },
+	{ "formats", test_formats },
+	{ "long", test_long },
+	{ "interleaved", test_interleaved },
+	{ "templates", test_templates },
+	{ NULL, NULL }
+};
@@ -0,0 +1,221 @@
+/*
+ * File: tests/pathfind/findpath.c
+ * Purpose: Check the paths findpath() finds
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "pathfind/old-findpath.h"
+
+const char *suite_name = "pathfind/findpath";
+
+int setup_tests(void **state)
+{
+	test_init_game();
+	test_new_player(1);
+	return 0;
+}
+
+int teardown_tests(void *state)
+{
+	test_cleanup_game();
+	return 0;
+}
+
+static s16b bfs_dist[DUNGEON_HGT][DUNGEON_WID];
+static u16b bfs_queue[DUNGEON_HGT * DUNGEON_WID];
+
+/**
+ * Length of the shortest path from the player to (ty, tx) through grids
+ * the pathfinder may use, by breadth-first search; -1 if there is none.
+ */
+static int bfs_length(int ty, int tx)
+{
+	int head = 0, tail = 0;
+	int d;
+
+	memset(bfs_dist, -1, sizeof(bfs_dist));
+
+	bfs_dist[p_ptr->py][p_ptr->px] = 0;
+	bfs_queue[tail++] = GRID(p_ptr->py, p_ptr->px);
+
+	while (head < tail) {
+		int y = GRID_Y(bfs_queue[head]);
+		int x = GRID_X(bfs_queue[head]);
+
+		head++;
+		if ((y == ty) && (x == tx))
+			return bfs_dist[y][x];
+
+		for (d = 0; d < 8; d++) {
+			int y2 = y + ddy_ddd[d];
+			int x2 = x + ddx_ddd[d];
+
+			if (!in_bounds_fully(y2, x2) || (bfs_dist[y2][x2] >= 0))
+				continue;
+			if (((y2 != ty) || (x2 != tx)) && !is_valid_pf(y2, x2))
+				continue;
+
+			bfs_dist[y2][x2] = bfs_dist[y][x] + 1;
+			bfs_queue[tail++] = GRID(y2, x2);
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * Follow a path, first step last, from the player.  Return its length if
+ * every step is to a usable grid and it ends at (ty, tx), or -1.
+ */
+static int walk_path(const char *path, int last, int ty, int tx)
+{
+	int y = p_ptr->py;
+	int x = p_ptr->px;
+	int i;
+
+	for (i = last; i >= 0; i--) {
+		int dir = path[i] - '0';
+
+		if ((dir < 1) || (dir > 9) || (dir == 5))
+			return -1;
+
+		y += ddy[dir];
+		x += ddx[dir];
+
+		if (!in_bounds_fully(y, x))
+			return -1;
+		if (((y != ty) || (x != tx)) && !is_valid_pf(y, x))
+			return -1;
+	}
+
+	if ((y != ty) || (x != tx))
+		return -1;
+
+	return last + 1;
+}
+
+/**
+ * Mark every grid of the level as known, so walls are obstacles
+ */
+static void know_level(void)
+{
+	int y, x;
+
+	for (y = 0; y < DUNGEON_HGT; y++)
+		for (x = 0; x < DUNGEON_WID; x++)
+			square_on(y, x, SQUARE_MARK);
+}
+
+/**
+ * On known levels, a path is found exactly when one exists, it only uses
+ * usable grids, and it is as short as possible, wherever the target is.
+ */
+static int test_known(void *state)
+{
+	int level, n;
+
+	for (level = 0; level < 6; level++) {
+		int y, x;
+
+		test_new_level(600 + level, 5 + 7 * level);
+		know_level();
+		require(test_random_floor(&y, &x));
+		test_place_player(y, x);
+
+		for (n = 0; n < 40; n++) {
+			int ty = randint1(DUNGEON_HGT - 2);
+			int tx = randint1(DUNGEON_WID - 2);
+			int best = bfs_length(ty, tx);
+
+			if (best == 0)
+				continue;
+
+			if (best < 0) {
+				require(!findpath(ty, tx));
+				continue;
+			}
+
+			require(findpath(ty, tx));
+			eq(walk_path(pf_result, pf_result_index, ty, tx), best);
+		}
+	}
+
+	ok;
+}
+
+/**
+ * Grids the character has not seen count as open, so on an unknown level
+ * every path is as short as the distance to the target.
+ */
+static int test_unknown(void *state)
+{
+	int n, y, x;
+
+	test_new_level(700, 20);
+	require(test_random_floor(&y, &x));
+	test_place_player(y, x);
+
+	for (n = 0; n < 100; n++) {
+		int ty = randint1(DUNGEON_HGT - 2);
+		int tx = randint1(DUNGEON_WID - 2);
+
+		if ((ty == p_ptr->py) && (tx == p_ptr->px))
+			continue;
+
+		require(findpath(ty, tx));
+		eq(walk_path(pf_result, pf_result_index, ty, tx),
+		   MAX(ABS(ty - p_ptr->py), ABS(tx - p_ptr->px)));
+	}
+
+	ok;
+}
+
+/**
+ * Wherever the old windowed search found a path, the new one is no longer
+ */
+static int test_old(void *state)
+{
+	int level, n;
+	int found = 0;
+
+	for (level = 0; level < 6; level++) {
+		int y, x;
+
+		test_new_level(800 + level, 5 + 7 * level);
+		know_level();
+		require(test_random_floor(&y, &x));
+		test_place_player(y, x);
+
+		for (n = 0; n < 40; n++) {
+			int ty = p_ptr->py + rand_spread(0, MAX_PF_RADIUS / 2);
+			int tx = p_ptr->px + rand_spread(0, MAX_PF_RADIUS / 2);
+			int old_len;
+
+			if (!in_bounds_fully(ty, tx) || !old_findpath_window(ty, tx) ||
+				((ty == p_ptr->py) && (tx == p_ptr->px)))
+				continue;
+
+			if (!old_findpath(ty, tx))
+				continue;
+
+			old_len = walk_path(old_pf_result, old_pf_result_index, ty, tx);
+			require(old_len > 0);
+
+			require(findpath(ty, tx));
+			require(walk_path(pf_result, pf_result_index, ty, tx) <= old_len);
+			found++;
+		}
+	}
+
+	require(found > 0);
+	ok;
+}
+
+struct test tests[] = {
+	{ "known", test_known },
+	{ "unknown", test_unknown },
+	{ "old", test_old },
+	{ NULL, NULL }
+};
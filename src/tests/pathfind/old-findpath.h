@@ -0,0 +1,171 @@
+/*
+ * File: old-findpath.h
+ * Purpose: findpath() as it was before the A* search, as a reference for
+ * the tests and the benchmark
+ *
+ * It copies a MAX_PF_RADIUS square around the character and relaxes it
+ * until nothing changes, so only targets inside that square can be
+ * reached.  The path goes to old_pf_result[] rather than pf_result[], in
+ * the same last-step-first format, and failures are silent.
+ */
+
+#ifndef INCLUDED_OLD_FINDPATH_H
+#define INCLUDED_OLD_FINDPATH_H
+
+#include "angband.h"
+
+#define MAX_PF_RADIUS 50
+#define OLD_PF_LENGTH 250
+
+static int old_terrain[MAX_PF_RADIUS][MAX_PF_RADIUS];
+static char old_pf_result[OLD_PF_LENGTH];
+static int old_pf_result_index;
+
+static int old_ox, old_oy, old_ex, old_ey;
+
+static void old_fill_terrain_info(void)
+{
+	int i, j;
+
+	old_ox = MAX(p_ptr->px - MAX_PF_RADIUS / 2, 0);
+	old_oy = MAX(p_ptr->py - MAX_PF_RADIUS / 2, 0);
+
+	old_ex = MIN(p_ptr->px + MAX_PF_RADIUS / 2 - 1, DUNGEON_WID);
+	old_ey = MIN(p_ptr->py + MAX_PF_RADIUS / 2 - 1, DUNGEON_HGT);
+
+	for (i = 0; i < MAX_PF_RADIUS * MAX_PF_RADIUS; i++)
+		old_terrain[0][i] = -1;
+
+	for (j = old_oy; j < old_ey; j++)
+		for (i = old_ox; i < old_ex; i++)
+			if (is_valid_pf(j, i))
+				old_terrain[j - old_oy][i - old_ox] = OLD_PF_LENGTH;
+
+	old_terrain[p_ptr->py - old_oy][p_ptr->px - old_ox] = 1;
+}
+
+/**
+ * Is (y, x) inside the square the old search looked at?
+ */
+static bool old_findpath_window(int y, int x)
+{
+	old_fill_terrain_info();
+
+	return ((x >= old_ox) && (x < old_ex) && (y >= old_oy) && (y < old_ey));
+}
+
+#define OLD_MARK_DISTANCE(c,d) if ((c <= OLD_PF_LENGTH) && (c > d)) \
+                              { c = d; try_again = (TRUE); }
+
+static bool old_findpath(int y, int x)
+{
+	int i, j, k, dir, starty = 0, startx = 0, start_index;
+	bool try_again;
+	int cur_distance;
+	int findir[] = { 1, 4, 7, 8, 9, 6, 3, 2 };
+	int oy, ox, ey, ex;
+
+	old_fill_terrain_info();
+	oy = old_oy;
+	ox = old_ox;
+	ey = old_ey;
+	ex = old_ex;
+
+	old_terrain[p_ptr->py - oy][p_ptr->px - ox] = 1;
+
+	if ((x >= ox) && (x < ex) && (y >= oy) && (y < ey)) {
+		if ((cave_m_idx[y][x] > 0) && (m_list[cave_m_idx[y][x]].ml)) {
+			old_terrain[y - oy][x - ox] = OLD_PF_LENGTH;
+		}
+		old_terrain[y - oy][x - ox] = OLD_PF_LENGTH;
+	} else {
+		return (FALSE);
+	}
+
+	if (old_terrain[y - oy][x - ox] == -1)
+		return (FALSE);
+
+	do {
+		try_again = (FALSE);
+		for (j = oy + 1; j < ey - 1; j++)
+			for (i = ox + 1; i < ex - 1; i++) {
+				cur_distance = old_terrain[j - oy][i - ox] + 1;
+				if ((cur_distance > 0) && (cur_distance < OLD_PF_LENGTH)) {
+					for (dir = 1; dir < 10; dir++) {
+						if (dir == 5)
+							continue;
+						OLD_MARK_DISTANCE(old_terrain[j - oy + ddy[dir]]
+										  [i - ox + ddx[dir]], cur_distance);
+					}
+				}
+			}
+		if (old_terrain[y - oy][x - ox] < OLD_PF_LENGTH)
+			try_again = (FALSE);
+	} while (try_again);
+
+	/* Failure */
+	if (old_terrain[y - oy][x - ox] == OLD_PF_LENGTH)
+		return (FALSE);
+
+	/* Success */
+	i = x;
+	j = y;
+
+	old_pf_result_index = 0;
+
+	while ((i != p_ptr->px) || (j != p_ptr->py)) {
+		int xdiff = i - p_ptr->px, ydiff = j - p_ptr->py;
+
+		cur_distance = old_terrain[j - oy][i - ox] - 1;
+
+		/* Starting direction */
+		if (xdiff < 0)
+			startx = 1;
+		else if (xdiff > 0)
+			startx = -1;
+		else
+			startx = 0;
+
+		if (ydiff < 0)
+			starty = 1;
+		else if (ydiff > 0)
+			starty = -1;
+		else
+			starty = 0;
+
+		for (dir = 1; dir < 10; dir++)
+			if ((ddx[dir] == startx) && (ddy[dir] == starty))
+				break;
+
+		if ((dir % 5) == 0)
+			return (FALSE);
+
+		for (start_index = 0; findir[start_index % 8] != dir;
+			 start_index++);
+
+		for (k = 0; k < 5; k++) {
+			dir = findir[(start_index + k) % 8];
+			if (old_terrain[j - oy + ddy[dir]][i - ox + ddx[dir]]
+				== cur_distance)
+				break;
+			dir = findir[(8 + start_index - k) % 8];
+			if (old_terrain[j - oy + ddy[dir]][i - ox + ddx[dir]]
+				== cur_distance)
+				break;
+		}
+
+		/* The back-trace lost the path */
+		if (k == 5)
+			return (FALSE);
+
+		old_pf_result[old_pf_result_index++] = '0' + (char) (10 - dir);
+		i += ddx[dir];
+		j += ddy[dir];
+		starty = 0;
+		startx = 0;
+	}
+	old_pf_result_index--;
+	return (TRUE);
+}
+
+#endif /* INCLUDED_OLD_FINDPATH_H */
@@ -0,0 +1,257 @@
+/*
+ * File: test-utils.c
+ * Purpose: Setting up a game without a user interface, for tests and
+ * benchmarks
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+#include "birth.h"
+#include "dungeon.h"
+#include "game-cmd.h"
+#include "generate.h"
+#include "init.h"
+#include "mapmode.h"
+#include "test-utils.h"
+
+#include <time.h>
+
+/**
+ * A terminal which draws nothing, and answers every request for a key with
+ * an escape
+ */
+static term test_term;
+
+static errr test_term_xtra(int n, int v)
+{
+	if (n == TERM_XTRA_EVENT)
+		Term_keypress(ESCAPE, 0);
+
+	return 0;
+}
+
+static errr test_term_curs(int x, int y)
+{
+	return 0;
+}
+
+static errr test_term_wipe(int x, int y, int n)
+{
+	return 0;
+}
+
+static errr test_term_text(int x, int y, int n, int a, const wchar_t *s)
+{
+	return 0;
+}
+
+/**
+ * init_angband() waits for the first command before it returns
+ */
+static errr test_get_cmd(cmd_context context, bool wait)
+{
+	return cmd_insert(CMD_NEWGAME);
+}
+
+/**
+ * Set up the terminal and the paths init_angband() needs, using the lib
+ * directory the game was configured with.
+ */
+void test_init_paths(void)
+{
+	term_init(&test_term, 80, 24, 256);
+	test_term.xtra_hook = test_term_xtra;
+	test_term.curs_hook = test_term_curs;
+	test_term.wipe_hook = test_term_wipe;
+	test_term.text_hook = test_term_text;
+	Term_activate(&test_term);
+	angband_term[0] = &test_term;
+
+	init_file_paths(DEFAULT_CONFIG_PATH, DEFAULT_LIB_PATH,
+					DEFAULT_DATA_PATH);
+
+	cmd_get_hook = test_get_cmd;
+}
+
+/**
+ * Read the game data from the lib directory the game was configured with.
+ */
+void test_init_game(void)
+{
+	test_init_paths();
+	init_angband();
+}
+
+/**
+ * Roll a new character, much as play_game() does, but without asking any
+ * questions.  The character is given plenty of hit points, so that tests
+ * which run game turns are not cut short by an unlucky fight.
+ */
+void test_new_player(u32b seed)
+{
+	int i;
+
+	Rand_quick = FALSE;
+	Rand_state_init(seed);
+
+	seed_flavor = randint0(0x10000000);
+	for (i = 0; i < 10; i++)
+		seed_town[i] = randint0(0x10000000);
+
+	player_init(p_ptr);
+	p_ptr->map = MAP_EXTENDED;
+	set_map(p_ptr);
+	player_generate(p_ptr, NULL, NULL, NULL, NULL);
+
+	/* Stats as the point-based roller starts them */
+	for (i = 0; i < A_MAX; i++)
+		p_ptr->stat_max[i] = p_ptr->stat_cur[i] = p_ptr->stat_birth[i] = 10;
+
+	p_ptr->lev = p_ptr->max_lev = 30;
+	for (i = 0; i < PY_MAX_LEVEL; i++)
+		p_ptr->player_hp[i] = 20000;
+
+	if (init_race_probs())
+		quit("Cannot initialize race probs");
+	flavor_init();
+	init_artifacts();
+
+	character_generated = TRUE;
+	p_ptr->playing = TRUE;
+}
+
+/**
+ * Generate the first dungeon level which is at least "depth" deep.
+ */
+void test_new_level(u32b seed, int depth)
+{
+	int i;
+
+	Rand_state_init(seed);
+
+	for (i = 0; i < NUM_STAGES - 1; i++)
+		if ((stage_map[i][STAGE_TYPE] == CAVE) &&
+			(stage_map[i][DEPTH] >= depth))
+			break;
+
+	p_ptr->stage = i;
+	p_ptr->depth = stage_map[i][DEPTH];
+	monster_level = object_level = p_ptr->depth;
+
+	generate_cave();
+	character_dungeon = TRUE;
+
+	p_ptr->update |= (PU_BONUS | PU_HP | PU_TORCH);
+	update_stuff(p_ptr);
+	p_ptr->chp = p_ptr->mhp;
+}
+
+/**
+ * Pick a random empty floor grid
+ */
+bool test_random_floor(int *y, int *x)
+{
+	int tries;
+
+	for (tries = 0; tries < 10000; tries++) {
+		*y = randint0(DUNGEON_HGT);
+		*x = randint0(DUNGEON_WID);
+
+		if (in_bounds_fully(*y, *x) && cave_empty_bold(*y, *x))
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+/**
+ * Move the player to an empty grid
+ */
+void test_place_player(int y, int x)
+{
+	monster_swap(p_ptr->py, p_ptr->px, y, x);
+}
+
+/**
+ * Take a step in direction "dir" (an index into ddy_ddd[]), turning to a
+ * random direction instead when the way is blocked, so the player wanders
+ * all over the level rather than staying near where they started.
+ */
+void test_walk(int *dir)
+{
+	int tries;
+
+	for (tries = 0; tries < 16; tries++) {
+		int y = p_ptr->py + ddy_ddd[*dir];
+		int x = p_ptr->px + ddx_ddd[*dir];
+
+		if (in_bounds_fully(y, x) && cave_empty_bold(y, x)) {
+			test_place_player(y, x);
+			return;
+		}
+
+		*dir = randint0(8);
+	}
+}
+
+/**
+ * Read the lines of a template file, as parse_file() reads them, into an
+ * array of strings; free it with test_free_lines().
+ */
+char **test_read_template(const char *name, int *count)
+{
+	char path[1024];
+	char buf[1024];
+	ang_file *fh;
+	char **lines = NULL;
+	int size = 0;
+
+	*count = 0;
+	path_build(path, sizeof(path), ANGBAND_DIR_EDIT, format("%s.txt", name));
+	fh = file_open(path, MODE_READ, -1);
+	if (!fh)
+		return NULL;
+
+	while (file_getl(fh, buf, sizeof(buf))) {
+		if (*count == size) {
+			size = size ? 2 * size : 256;
+			lines = mem_realloc(lines, size * sizeof(*lines));
+		}
+		lines[(*count)++] = string_make(buf);
+	}
+
+	file_close(fh);
+	return lines;
+}
+
+void test_free_lines(char **lines, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+		string_free(lines[i]);
+	mem_free(lines);
+}
+
+void test_cleanup_game(void)
+{
+	cleanup_angband();
+}
+
+/**
+ * Processor time used so far, in seconds
+ */
+double test_clock(void)
+{
+	return (double) clock() / CLOCKS_PER_SEC;
+}
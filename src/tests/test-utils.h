@@ -0,0 +1,25 @@
+/*
+ * File: test-utils.h
+ * Purpose: Setting up a game without a user interface, for tests and
+ * benchmarks
+ */
+
+#ifndef INCLUDED_TEST_UTILS_H
+#define INCLUDED_TEST_UTILS_H
+
+#include "angband.h"
+
+extern void test_init_paths(void);
+extern void test_init_game(void);
+extern void test_new_player(u32b seed);
+extern void test_new_level(u32b seed, int depth);
+extern bool test_random_floor(int *y, int *x);
+extern void test_place_player(int y, int x);
+extern void test_walk(int *dir);
+extern char **test_read_template(const char *name, int *count);
+extern void test_free_lines(char **lines, int count);
+extern void test_cleanup_game(void);
+
+extern double test_clock(void);
+
+#endif /* INCLUDED_TEST_UTILS_H */
@@ -0,0 +1,52 @@
+/*
+ * File: unit-test.c
+ * Purpose: Run the tests of one suite
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "unit-test.h"
+
+int verbose = 0;
+
+int main(int argc, char *argv[])
+{
+	void *state = NULL;
+	int i;
+	int passed = 0;
+	int total = 0;
+
+	if ((argc > 1) && !strcmp(argv[1], "-v"))
+		verbose = 1;
+
+	if (setup_tests(&state)) {
+		printf("%s: setup failed\n", suite_name);
+		return 1;
+	}
+
+	for (i = 0; tests[i].name; i++) {
+		if (tests[i].func(state) == TEST_PASS)
+			passed++;
+		else
+			printf("  %-20s %-24s FAILED\n", suite_name, tests[i].name);
+		total++;
+	}
+
+	if (teardown_tests(state)) {
+		printf("%s: teardown failed\n", suite_name);
+		return 1;
+	}
+
+	printf("%-20s %d/%d passed\n", suite_name, passed, total);
+
+	return (passed != total);
+}
@@ -0,0 +1,80 @@
+/*
+ * File: unit-test.h
+ * Purpose: Minimal unit test framework
+ *
+ * Each suite is a program of its own.  It defines "suite_name", the
+ * "tests" array (ended by an entry with a NULL name), and the functions
+ * "setup_tests()" and "teardown_tests()"; unit-test.c supplies main().
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef INCLUDED_UNIT_TEST_H
+#define INCLUDED_UNIT_TEST_H
+
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_PASS	0
+#define TEST_FAIL	1
+
+struct test {
+	const char *name;
+	int (*func)(void *state);
+};
+
+extern const char *suite_name;
+extern struct test tests[];
+
+extern int setup_tests(void **state);
+extern int teardown_tests(void *state);
+
+extern int verbose;
+
+/**
+ * Pass the current test
+ */
+#define ok \
+	do { \
+		if (verbose) \
+			printf("  %-20s %-24s passed\n", suite_name, __func__); \
+		return TEST_PASS; \
+	} while (0)
+
+/**
+ * Fail the current test unless "x" holds
+ */
+#define require(x) \
+	do { \
+		if (!(x)) { \
+			printf("  %s:%d: %s: requirement '%s' failed\n", \
+			       suite_name, __LINE__, __func__, #x); \
+			return TEST_FAIL; \
+		} \
+	} while (0)
+
+/**
+ * Fail the current test unless the integers "x" and "y" are equal
+ */
+#define eq(x, y) \
+	do { \
+		long long eq_x = (long long) (x); \
+		long long eq_y = (long long) (y); \
+		if (eq_x != eq_y) { \
+			printf("  %s:%d: %s: requirement '%s' == '%s' failed\n", \
+			       suite_name, __LINE__, __func__, #x, #y); \
+			printf("    %s: %lld\n    %s: %lld\n", #x, eq_x, #y, eq_y); \
+			return TEST_FAIL; \
+		} \
+	} while (0)
+
+#endif /* INCLUDED_UNIT_TEST_H */
@@ -0,0 +1,137 @@
+/*
+ * File: tests/z-bitflag/single.c
+ * Purpose: Check the inlined single flag operations against the checked
+ * flag_has(), flag_on() and flag_off()
+ */
+
+#include "unit-test.h"
+#include "angband.h"
+
+const char *suite_name = "z-bitflag/single";
+
+/* Big enough for every set, with sizes that do and do not fill a word */
+#define SET_SIZE	12
+
+int setup_tests(void **state)
+{
+	Rand_quick = FALSE;
+	Rand_state_init(1);
+	return 0;
+}
+
+int teardown_tests(void *state)
+{
+	return 0;
+}
+
+static void random_set(bitflag *f, size_t size)
+{
+	size_t i;
+
+	for (i = 0; i < size; i++)
+		f[i] = (bitflag) randint0(256);
+}
+
+/**
+ * flag_has_fast() agrees with flag_has() on every flag of random sets
+ */
+static int test_has(void *state)
+{
+	bitflag f[SET_SIZE];
+	size_t size;
+	int n, flag;
+
+	for (size = 1; size <= SET_SIZE; size++) {
+		for (n = 0; n < 50; n++) {
+			random_set(f, size);
+
+			for (flag = FLAG_START; flag < FLAG_MAX(size); flag++)
+				eq(flag_has_fast(f, size, flag), flag_has(f, size, flag));
+		}
+	}
+
+	ok;
+}
+
+/**
+ * flag_on_fast() and flag_off_fast() change the same bit as flag_on() and
+ * flag_off(), and say whether they changed it in the same way
+ */
+static int test_on_off(void *state)
+{
+	bitflag f[SET_SIZE], fast[SET_SIZE], slow[SET_SIZE];
+	size_t size;
+	int n, flag;
+
+	for (size = 1; size <= SET_SIZE; size++) {
+		for (n = 0; n < 50; n++) {
+			random_set(f, size);
+
+			for (flag = FLAG_START; flag < FLAG_MAX(size); flag++) {
+				memcpy(fast, f, size);
+				memcpy(slow, f, size);
+				eq(flag_on_fast(fast, size, flag), flag_on(slow, size, flag));
+				require(!memcmp(fast, slow, size));
+
+				memcpy(fast, f, size);
+				memcpy(slow, f, size);
+				eq(flag_off_fast(fast, size, flag),
+				   flag_off(slow, size, flag));
+				require(!memcmp(fast, slow, size));
+			}
+		}
+	}
+
+	ok;
+}
+
+/**
+ * FLAG_END is never set, and turning it on or off does nothing
+ */
+static int test_end(void *state)
+{
+	bitflag f[SET_SIZE], g[SET_SIZE];
+
+	memset(f, 0xff, sizeof(f));
+	memcpy(g, f, sizeof(f));
+
+	require(!flag_has_fast(f, SET_SIZE, FLAG_END));
+	require(!flag_on_fast(f, SET_SIZE, FLAG_END));
+	require(!flag_off_fast(f, SET_SIZE, FLAG_END));
+	require(!memcmp(f, g, sizeof(f)));
+
+	ok;
+}
+
+/**
+ * The per-set macros see the same flags as flag_has()
+ */
+static int test_macros(void *state)
+{
+	bitflag rf[RF_SIZE];
+	bitflag of[OF_SIZE];
+	bitflag tf[TF_SIZE];
+	int n;
+
+	for (n = 0; n < 200; n++) {
+		random_set(rf, RF_SIZE);
+		random_set(of, OF_SIZE);
+		random_set(tf, TF_SIZE);
+
+		eq(rf_has(rf, RF_UNIQUE), flag_has(rf, RF_SIZE, RF_UNIQUE));
+		eq(rf_has(rf, RF_MULTIPLY), flag_has(rf, RF_SIZE, RF_MULTIPLY));
+		eq(of_has(of, OF_SEE_INVIS), flag_has(of, OF_SIZE, OF_SEE_INVIS));
+		eq(tf_has(tf, TF_LOS), flag_has(tf, TF_SIZE, TF_LOS));
+		eq(tf_has(tf, TF_PASSABLE), flag_has(tf, TF_SIZE, TF_PASSABLE));
+	}
+
+	ok;
+}
+
+struct test tests[] = {
+	{ "has", test_has },
+	{ "on_off", test_on_off },
+	{ "end", test_end },
+	{ "macros", test_macros },
+	{ NULL, NULL }
+};
@@ -36,7 +36,7 @@ bool cave_trap_specific(int y, int x, int t_idx)
 	int i;
 
 	/* First, check the trap marker */
-	if (!sqinfo_has(cave_info[y][x], SQUARE_TRAP))
+	if (!square_has(y, x, SQUARE_TRAP))
 		return (FALSE);
 
 	/* Scan the current trap list */
@@ -64,7 +64,7 @@ bool cave_trap_flag(int y, int x, int flag)
 	int i;
 
 	/* First, check the trap marker */
-	if (!sqinfo_has(cave_info[y][x], SQUARE_TRAP))
+	if (!square_has(y, x, SQUARE_TRAP))
 		return (FALSE);
 
 	/* Scan the current trap list */
@@ -180,10 +180,10 @@ static bool verify_trap(int y, int x, int vis)
 	/* No traps in this location. */
 	if (!trap) {
 		/* No traps */
-		sqinfo_off(cave_info[y][x], SQUARE_TRAP);
+		square_off(y, x, SQUARE_TRAP);
 
 		/* No reason to mark this grid, ... */
-		sqinfo_off(cave_info[y][x], SQUARE_MARK);
+		square_off(y, x, SQUARE_MARK);
 
 		/* ... unless certain conditions apply */
 		note_spot(y, x);
@@ -208,7 +208,7 @@ bool cave_visible_trap(int y, int x)
 bool cave_invisible_trap(int y, int x)
 {
 	/* First, check the trap marker */
-	if (!sqinfo_has(cave_info[y][x], SQUARE_TRAP))
+	if (!square_has(y, x, SQUARE_TRAP))
 		return (FALSE);
 
 	/* Verify trap, require that it be invisible */
@@ -295,7 +295,7 @@ bool reveal_trap(int y, int x, int chance, bool domsg)
 	int found_trap = 0;
 
 	/* Check the trap marker */
-	if (!sqinfo_has(cave_info[y][x], SQUARE_TRAP))
+	if (!square_has(y, x, SQUARE_TRAP))
 		return (FALSE);
 
 	/* Scan the current trap list */
@@ -309,7 +309,7 @@ bool reveal_trap(int y, int x, int chance, bool domsg)
 			if (!trf_has(t_ptr->flags, TRF_VISIBLE)) {
 				/* See the trap */
 				trf_on(t_ptr->flags, TRF_VISIBLE);
-				sqinfo_on(cave_info[y][x], SQUARE_MARK);
+				square_on(y, x, SQUARE_MARK);
 
 				/* We found a trap */
 				found_trap++;
@@ -332,7 +332,7 @@ bool reveal_trap(int y, int x, int chance, bool domsg)
 		}
 
 		/* Memorize */
-		sqinfo_on(cave_info[y][x], SQUARE_MARK);
+		square_on(y, x, SQUARE_MARK);
 
 		/* Redraw */
 		light_spot(y, x);
@@ -511,7 +511,7 @@ bool cave_trap_allowed(int y, int x)
 	 * We currently forbid multiple traps in a grid under normal conditions.
 	 * If this changes, various bits of code elsewhere will have to change too.
 	 */
-	if (sqinfo_has(cave_info[y][x], SQUARE_TRAP))
+	if (square_has(y, x, SQUARE_TRAP))
 		return (FALSE);
 
 	/* Check the feature trap flag */
@@ -580,7 +580,7 @@ bool place_trap(int y, int x, int t_idx, int trap_level)
 				num_trap_on_level++;
 
 			/* Toggle on the trap marker */
-			sqinfo_on(cave_info[y][x], SQUARE_TRAP);
+			square_on(y, x, SQUARE_TRAP);
 
 			/* Redraw the grid */
 			light_spot(y, x);
@@ -670,7 +670,7 @@ void hit_trap_aux(int y, int x, int trap)
 			if (((stage_map[p_ptr->stage][STAGE_TYPE] == CAVE)
 				 || (stage_map[p_ptr->stage][STAGE_TYPE] == VALLEY))
 				&& (!stage_map[p_ptr->stage][DOWN])) {
-				sqinfo_off(cave_info[y][x], SQUARE_MARK);
+				square_off(y, x, SQUARE_MARK);
 				remove_trap(y, x, FALSE, trap);
 				msg("The trap fails!");
 				break;
@@ -1572,7 +1572,7 @@ extern void hit_trap(int y, int x)
 
 			/* Trap becomes visible (always XXX) */
 			trf_on(t_ptr->flags, TRF_VISIBLE);
-			sqinfo_on(cave_info[y][x], SQUARE_MARK);
+			square_on(y, x, SQUARE_MARK);
 		}
 	}
 
@@ -2115,7 +2115,7 @@ static void remove_trap_aux(trap_type * t_ptr, int y, int x, bool domsg)
 		num_trap_on_level--;
 
 	/* Wipe the trap */
-	sqinfo_off(cave_info[y][x], SQUARE_TRAP);
+	square_off(y, x, SQUARE_TRAP);
 	(void) WIPE(t_ptr, trap_type);
 }
 
@@ -2330,7 +2330,7 @@ bool get_trap(int y, int x, int *idx)
 		return (FALSE);
 
 	/* Look for the trap marker */
-	if (!sqinfo_has(cave_info[y][x], SQUARE_TRAP))
+	if (!square_has(y, x, SQUARE_TRAP))
 		return (FALSE);
 
 	/* Get a trap */
@@ -2356,7 +2356,7 @@ bool has_disarmable_trap(int y, int x)
 	int i;
 
 	/* First, check the trap marker */
-	if (!sqinfo_has(cave_info[y][x], SQUARE_TRAP))
+	if (!square_has(y, x, SQUARE_TRAP))
 		return (FALSE);
 
 	/* Scan the current trap list */
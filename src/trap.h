@@ -69,15 +69,15 @@ enum
 
 #define TRF_SIZE                FLAG_SIZE(TRF_MAX)
 
-#define trf_has(f, flag)        flag_has_dbg(f, TRF_SIZE, flag, #f, #flag)
+#define trf_has(f, flag)        flag_has_fast(f, TRF_SIZE, flag)
 #define trf_next(f, flag)       flag_next(f, TRF_SIZE, flag)
 #define trf_is_empty(f)         flag_is_empty(f, TRF_SIZE)
 #define trf_is_full(f)          flag_is_full(f, TRF_SIZE)
 #define trf_is_inter(f1, f2)    flag_is_inter(f1, f2, TRF_SIZE)
 #define trf_is_subset(f1, f2)   flag_is_subset(f1, f2, TRF_SIZE)
 #define trf_is_equal(f1, f2)    flag_is_equal(f1, f2, TRF_SIZE)
-#define trf_on(f, flag)         flag_on_dbg(f, TRF_SIZE, flag, #f, #flag)
-#define trf_off(f, flag)        flag_off(f, TRF_SIZE, flag)
+#define trf_on(f, flag)         flag_on_fast(f, TRF_SIZE, flag)
+#define trf_off(f, flag)        flag_off_fast(f, TRF_SIZE, flag)
 #define trf_wipe(f)             flag_wipe(f, TRF_SIZE)
 #define trf_setall(f)           flag_setall(f, TRF_SIZE)
 #define trf_negate(f)           flag_negate(f, TRF_SIZE)
@@ -122,9 +122,11 @@ bool repair_mflag_mark;			/* Hack -- repair monster flags (mark) */
 
 s16b o_max = 1;					/* Number of allocated objects */
 s16b o_cnt = 0;					/* Number of live objects */
+s16b o_free_num = 0;			/* Number of free objects below o_max */
 
 s16b m_max = 1;					/* Number of allocated monsters */
 s16b m_cnt = 0;					/* Number of live monsters */
+s16b m_free_num = 0;			/* Number of free monsters below m_max */
 
 u16b trap_max = 1;				/* Number of allocated traps */
 u16b trap_cnt = 0;				/* Number of live traps */
@@ -182,6 +184,11 @@ u16b *temp_g;
 byte *temp_y;
 byte *temp_x;
 
+/*
+ * Array[z_info->m_max] of monster indexes, for monster_near_list() answers
+ */
+s16b *temp_m_idx;
+
 /* 
  * Arrays[NUM_STAGES][NUM_STAGES] of numbers of paths between nearby stages
  */
@@ -199,12 +206,20 @@ u16b(*race_prob)[NUM_STAGES];
 byte *dummy;
 
 /**
- * Array[DUNGEON_HGT][256] of cave grid info flags (padded)
+ * Array[SQUARE_MAX][DUNGEON_HGT][CAVE_WORDS] of cave grid info flags, one
+ * bit plane per flag (see "square_has()")
  *
- * These arrays are padded to a width of 256 to allow fast access to elements
- * in the array via "grid" values (see the GRID() macros).
+ * In each plane a grid is one bit, and a row is CAVE_WORDS words of 32
+ * grids, padded to 256 grids so that the word and bit of a column are a
+ * shift and a mask (see CAVE_WORD() and CAVE_BIT()).
+ */
+u32b(*cave_info)[DUNGEON_HGT][CAVE_WORDS];
+
+/**
+ * Array[CAVE_TF_MAX][DUNGEON_HGT][CAVE_WORDS] of the frequently tested
+ * terrain flags of each grid's feature (see "cave_tf_has()")
  */
-bitflag(*cave_info)[256][SQUARE_SIZE];
+u32b(*cave_tf)[DUNGEON_HGT][CAVE_WORDS];
 
 /**
  * Array[DUNGEON_HGT][DUNGEON_WID] of cave grid feature codes
@@ -242,22 +257,29 @@ s16b(*cave_o_idx)[DUNGEON_WID];
  */
 s16b(*cave_m_idx)[DUNGEON_WID];
 
+/**
+ * Array[FLOW_MAX][DUNGEON_HGT][DUNGEON_WID] of cave grid flow "cost" values
+ * for each flow layer (see "update_noise()")
+ */
+byte(*cave_flow)[DUNGEON_HGT][DUNGEON_WID];
+
 /**
  * Array[DUNGEON_HGT][DUNGEON_WID] of cave grid flow "cost" values
- * Used to simulate character noise.
+ * Used to simulate character noise.  This is layer 0 of "cave_flow".
  */
 byte(*cave_cost)[DUNGEON_WID];
 
 /**
  * Array[DUNGEON_HGT][DUNGEON_WID] of cave grid flow "when" stamps.
- * Used to store character scent trails.
+ * Used to store character scent trails, as the scent clock time they
+ * were laid down (0 for no scent).
  */
-byte(*cave_when)[DUNGEON_WID];
+u32b(*cave_when)[DUNGEON_WID];
 
 /**
- * Current scent age marker.  Counts down from 250 to 0 and then loops.
+ * Scent clock.  Counts up one per character turn.
  */
-int scent_when = 250;
+u32b scent_turn = SCENT_MAX_AGE;
 
 
 /*
@@ -284,11 +306,55 @@ trap_type *trap_list;
  */
 object_type *o_list;
 
+/**
+ * Array[z_info->o_max] of the free object indexes below o_max (a stack)
+ */
+s16b *o_free;
+
+/**
+ * Array[z_info->o_max] of object generations, which change whenever an
+ * object leaves its index
+ */
+u16b *o_gen;
+
 /**
  * Array[z_info->m_max] of dungeon monsters
  */
 monster_type *m_list;
 
+/**
+ * Array[z_info->m_max] of the free monster indexes below m_max (a stack)
+ */
+s16b *m_free;
+
+/**
+ * Array[z_info->m_max] of monster generations, which change whenever a
+ * monster leaves its index
+ */
+u16b *m_gen;
+
+/**
+ * Array[MON_BUCKET_HGT][MON_BUCKET_WID] of the first monster filed in each
+ * bucket of the monster index
+ */
+s16b *mon_bucket;
+
+/**
+ * Array[MON_BUCKET_HGT][MON_BUCKET_WID] of the number of monsters filed in
+ * each bucket of the monster index
+ */
+s16b *mon_bucket_count;
+
+/**
+ * Array[z_info->m_max] of the next monster filed in the same bucket
+ */
+s16b *mon_bucket_next;
+
+/**
+ * Array[MON_MARK_WORDS] of scratch marks for monster index queries
+ */
+u32b *mon_bucket_mark;
+
 /**
  * Array[z_info->m_max] of monster lore
  */
@@ -319,6 +385,12 @@ s16b alloc_kind_size;
  */
 alloc_entry *alloc_kind_table;
 
+/**
+ * The array[ALLOC_KIND_CACHE][alloc_kind_size] of running totals of the
+ * object probabilities, one row per restriction
+ */
+u32b *alloc_kind_cum;
+
 /**
  * The size of the "alloc_ego_table"
  */
@@ -329,6 +401,12 @@ s16b alloc_ego_size;
  */
 alloc_entry *alloc_ego_table;
 
+/**
+ * The array[ALLOC_EGO_CACHE][alloc_ego_size] of running totals of the
+ * ego-item probabilities, one row per base object type
+ */
+u32b *alloc_ego_cum;
+
 /**
  * The size of "alloc_race_table" (at most z_info->r_max)
  */
@@ -344,6 +422,18 @@ alloc_entry *alloc_race_table;
  */
 u32b alloc_race_total;
 
+/**
+ * The array[alloc_race_size] of alias table thresholds for the final
+ * monster generation probabilities, out of "alloc_race_total"
+ */
+u32b *alloc_race_cut;
+
+/**
+ * The array[alloc_race_size] of alias table entries, used when a draw
+ * passes the threshold
+ */
+s16b *alloc_race_alias;
+
 /*
  * Specify attr/char pairs for visual special effects for project()
  */
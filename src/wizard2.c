@@ -1810,11 +1810,11 @@ static void do_cmd_wiz_query(void)
 			feature_type *f_ptr = &f_info[cave_feat[y][x]];
 
 			/* Given mask, show only those grids */
-			if (mask && !(cave_info[y][x][0] & mask))
+			if (mask && !(square_get_byte(y, x, 0) & mask))
 				continue;
 
 			/* Given no mask, show unknown grids */
-			if (!mask && (cave_info[y][x][0] & (SQUARE_MARK)))
+			if (!mask && (square_get_byte(y, x, 0) & (SQUARE_MARK)))
 				continue;
 
 			/* Color */
@@ -1980,6 +1980,18 @@ void do_cmd_debug(void)
 			break;
 		}
 
+		/* Line of sight cache statistics */
+	case 'L':
+		{
+			u32b total = los_cache_hits + los_cache_misses;
+
+			msg("LOS cache: %lu hits, %lu misses (%lu%% hit rate).",
+				(unsigned long) los_cache_hits,
+				(unsigned long) los_cache_misses,
+				total ? (unsigned long) (100.0 * los_cache_hits / total) : 0UL);
+			break;
+		}
+
 		/* Learn about objects */
 	case 'l':
 		{
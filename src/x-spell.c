@@ -1449,14 +1449,14 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 	case PRAYER_DETECT_CHAOS:
 		{
 			(void) detect_monsters_evil(DETECT_RAD_DEFAULT, TRUE);
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_CURE_MINOR_WOUNDS:
 		{
 			(void) hp_player(damroll(2, plev / 4 + 5));
 			(void) dec_timed(TMD_CUT, 10, TRUE);
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_CELESTIAS_BLESSING:
@@ -1466,13 +1466,13 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 			} else {
 				(void) inc_timed(TMD_BLESSED, randint1(4) + 4, TRUE);
 			}
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_REMOVE_FEAR:
 		{
 			(void) clear_timed(TMD_AFRAID, TRUE);
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_SUNLANCE:
@@ -1484,13 +1484,13 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 		{
 			(void) clear_timed(TMD_POISONED, TRUE);
 			(void) clear_timed(TMD_CUT, TRUE);
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_RESIST_FIRE:
 		{
 			(void) inc_timed(TMD_OPP_FIRE, randint1(30) + 2 * plev / 3, TRUE);
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_HEROISM:
@@ -1502,7 +1502,7 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 				(void) inc_timed(TMD_HERO, randint1(20) + 10, TRUE);
 			}
 			(void) clear_timed(TMD_AFRAID, TRUE);
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 
 			break;
 		}
@@ -1510,7 +1510,7 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 		{
 			(void) hp_player(damroll(4, plev / 4 + 6));
 			(void) dec_timed(TMD_CUT, p_ptr->timed[TMD_CUT] + 5, TRUE);
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_ABSORB_LIGHT:
@@ -1522,13 +1522,13 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 	case PRAYER_DETECT_UNDEAD:
 		{
 			(void) detect_monsters_undead(DETECT_RAD_DEFAULT, TRUE);
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_SATISFY_HUNGER:
 		{
 			(void) set_food(PY_FOOD_MAX - 1);
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_TURN_UNDEAD:
@@ -1544,14 +1544,14 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 			} else {
 				inc_timed(TMD_TELEPATHY, randint1(10), TRUE);
 			}
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_REMOVE_CURSE:
 		{
 			if (remove_curse())
 				msg("You feel kindly hands aiding you.");
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_EULOGY:
@@ -1588,7 +1588,7 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 			(void) hp_player(damroll(9, plev / 3 + 12));
 			(void) clear_timed(TMD_STUN, TRUE);
 			(void) clear_timed(TMD_CUT, TRUE);
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_SOLAR_FLARE:
@@ -1611,7 +1611,7 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 			(void) hp_player(300);
 			(void) clear_timed(TMD_STUN, TRUE);
 			(void) clear_timed(TMD_CUT, TRUE);
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_BREAKING:
@@ -1643,7 +1643,7 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 			(void) hp_player(700);
 			(void) clear_timed(TMD_STUN, TRUE);
 			(void) clear_timed(TMD_CUT, TRUE);
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_RENEWING_DAWN:
@@ -1658,37 +1658,37 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 			(void) dispel_monsters(4 * plev);
 			fire_ball(GF_HOLY_ORB, 0, 2 * plev, 3, FALSE);
 			(void) hp_player(400);
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_BLINK:
 		{
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			teleport_player(10, TRUE);
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_TELEPORT_SELF:
 		{
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			teleport_player(plev * 4, TRUE);
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_PORTAL:
 		{
 			msg("Choose a location in sight to teleport to.");
 			message_flush();
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			dimen_door_los();
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_WORD_OF_RECALL:
 		{
 			if (!word_recall(randint0(20) + 15))
 				break;
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_TELEPORT_LEVEL:
@@ -1719,12 +1719,12 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 			/* Hack - 'show' effected region only with the first detect */
 			(void) detect_doors(DETECT_RAD_DEFAULT, TRUE);
 			(void) detect_stairs(DETECT_RAD_DEFAULT, FALSE);
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_PERCEPTION:
 		{
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			if (!ident_spell())
 				return FALSE;
 			break;
@@ -1737,7 +1737,7 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 	case PRAYER_SACRED_KNOWLEDGE:
 		{
 			(void) identify_fully();
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_DETECTION:
@@ -1759,7 +1759,7 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 				(void) inc_timed(TMD_SHIELD, randint1(10) + plev / 4,
 								 TRUE);
 			}
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_RIGHTEOUS_FURY:
@@ -1783,7 +1783,7 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 			} else {
 				(void) inc_timed(TMD_SHERO, dur / 3, TRUE);
 			}
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_CURING:
@@ -1794,7 +1794,7 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 			clear_timed(TMD_STUN, TRUE);
 			clear_timed(TMD_CUT, TRUE);
 			clear_timed(TMD_AFRAID, TRUE);
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_STEADFAST:
@@ -1805,7 +1805,7 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 			} else {
 				msg("Nothing happens");
 			}
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_SUSTAINING:
@@ -1862,7 +1862,7 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 					inc_timed(TMD_SCHA, dur / 3, TRUE);
 				}
 			}
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_RESTORATION:
@@ -1873,13 +1873,13 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 			(void) do_res_stat(A_DEX);
 			(void) do_res_stat(A_CON);
 			(void) do_res_stat(A_CHR);
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_REMEMBERANCE:
 		{
 			(void) restore_level();
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_GLORY:
@@ -1897,7 +1897,7 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 			} else {
 				inc_timed(TMD_BLESSED, dur / 3, TRUE);
 			}
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_RESIST_HEAT_COLD:
@@ -1915,7 +1915,7 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 			} else {
 				inc_timed(TMD_OPP_COLD, dur / 3, TRUE);
 			}
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_PROTECTION_FROM_CHAOS:
@@ -1926,19 +1926,19 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 			} else {
 				(void) inc_timed(TMD_PROTEVIL, randint1(30), TRUE);
 			}
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_GLYPH_OF_WARDING:
 		{
 			(void) lay_rune(RUNE_PROTECT);
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_RALLY_ALLY:
 		{
 			fire_ball(GF_RALLY, dir, 25 + damroll(plev / 2, 10), 0, FALSE);
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}
 	case PRAYER_CIRCLE_OF_HARMONY:
@@ -1959,7 +1959,7 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 			/* Redraw the state */
 			p_ptr->redraw |= (PR_STATUS);
 			
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 
 			break;
 		}
@@ -1982,7 +1982,7 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 			(void) dec_timed(TMD_POISONED, 200, TRUE);
 			(void) clear_timed(TMD_STUN, TRUE);
 			(void) clear_timed(TMD_CUT, TRUE);
-			sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+			square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 			break;
 		}   
 	case PRAYER_RADIANCE:
@@ -1990,7 +1990,7 @@ bool cast_spell(int tval, int sindex, int dir, int plev)
 		    fire_ball(GF_LIGHT, 0, 5 * plev, plev / 6, FALSE);
 		    (void) hp_player(200);
 		    (void) fear_monsters(2 * plev);
-		    sqinfo_on(cave_info[p_ptr->py][p_ptr->px], SQUARE_GLOW);
+		    square_on(p_ptr->py, p_ptr->px, SQUARE_GLOW);
 		    break;
 		}
 	case PRAYER_ANNIHILATE_UNDEAD:
@@ -402,14 +402,15 @@ static void prt_sp(int row, int col)
 byte monster_health_attr(void)
 {
 	byte attr = TERM_WHITE;
+	int m_idx = health_tracked();
 
 	/* Not tracking */
-	if (!p_ptr->health_who)
+	if (!m_idx)
 		attr = TERM_DARK;
 
 	/* Tracking an unseen, hallucinatory, or dead monster */
-	else if ((!m_list[p_ptr->health_who].ml) || (p_ptr->timed[TMD_IMAGE])
-			 || (m_list[p_ptr->health_who].hp < 0)) {
+	else if ((!m_list[m_idx].ml) || (p_ptr->timed[TMD_IMAGE])
+			 || (m_list[m_idx].hp < 0)) {
 		/* The monster health is "unknown" */
 		attr = TERM_WHITE;
 	}
@@ -417,7 +418,7 @@ byte monster_health_attr(void)
 	else {
 		int pct;
 
-		monster_type *m_ptr = &m_list[p_ptr->health_who];
+		monster_type *m_ptr = &m_list[m_idx];
 
 		/* Default to almost dead */
 		attr = TERM_RED;
@@ -479,14 +480,15 @@ byte monster_health_attr(void)
 byte monster_mana_attr(void)
 {
 	byte attr = TERM_WHITE;
+	int m_idx = health_tracked();
 
 	/* Not tracking */
-	if (!p_ptr->health_who)
+	if (!m_idx)
 		attr = TERM_DARK;
 
 	/* Tracking an unseen, hallucinatory, or dead monster */
-	else if ((!m_list[p_ptr->health_who].ml) || (p_ptr->timed[TMD_IMAGE])
-			 || (m_list[p_ptr->health_who].hp < 0)) {
+	else if ((!m_list[m_idx].ml) || (p_ptr->timed[TMD_IMAGE])
+			 || (m_list[m_idx].hp < 0)) {
 		/* The monster health is "unknown" */
 		attr = TERM_WHITE;
 	}
@@ -494,7 +496,7 @@ byte monster_mana_attr(void)
 	else {
 		int pct;
 
-		monster_type *m_ptr = &m_list[p_ptr->health_who];
+		monster_type *m_ptr = &m_list[m_idx];
 		monster_race *r_ptr = &r_info[m_ptr->r_idx];
 
 		/* Default to out of mana */
@@ -538,17 +540,18 @@ byte monster_mana_attr(void)
 static void prt_health(int row, int col)
 {
 	byte attr = monster_health_attr();
+	int m_idx = health_tracked();
 
 	/* Not tracking */
-	if (!p_ptr->health_who) {
+	if (!m_idx) {
 		/* Erase the health bar */
 		Term_erase(col, row, 12);
 	}
 
 	/* Tracking an unseen, hallucinatory, or dead monster */
-	else if ((!m_list[p_ptr->health_who].ml) ||	/* Unseen */
+	else if ((!m_list[m_idx].ml) ||	/* Unseen */
 			 (p_ptr->timed[TMD_IMAGE]) ||	/* Hallucination */
-			 (m_list[p_ptr->health_who].hp < 0)) {	/* Dead (?) */
+			 (m_list[m_idx].hp < 0)) {	/* Dead (?) */
 		/* The monster health is "unknown" */
 		Term_putstr(col, row, 12, attr, "[----------]");
 	}
@@ -557,7 +560,7 @@ static void prt_health(int row, int col)
 	else {
 		int pct, len;
 
-		monster_type *m_ptr = &m_list[p_ptr->health_who];
+		monster_type *m_ptr = &m_list[m_idx];
 
 		/* Extract the "percent" of health */
 		pct = 100L * m_ptr->hp / m_ptr->maxhp;
@@ -591,17 +594,18 @@ static void prt_health(int row, int col)
 static void prt_mana(int row, int col)
 {
 	byte attr = TERM_SLATE;
+	int m_idx = health_tracked();
 
 	/* Not tracking */
-	if (!p_ptr->health_who) {
+	if (!m_idx) {
 		/* Erase the health bar */
 		Term_erase(col, row, 12);
 	}
 
 	/* Tracking an unseen, hallucinatory, or dead monster */
-	else if ((!m_list[p_ptr->health_who].ml) ||	/* Unseen */
+	else if ((!m_list[m_idx].ml) ||	/* Unseen */
 			 (p_ptr->timed[TMD_IMAGE]) ||	/* Hallucination */
-			 (m_list[p_ptr->health_who].hp < 0)) {	/* Dead (?) */
+			 (m_list[m_idx].hp < 0)) {	/* Dead (?) */
 		/* The monster mana is "unknown" */
 		Term_putstr(col, row, 12, attr, "[----------]");
 	}
@@ -610,7 +614,7 @@ static void prt_mana(int row, int col)
 	else {
 		int pct, len;
 
-		monster_type *m_ptr = &m_list[p_ptr->health_who];
+		monster_type *m_ptr = &m_list[m_idx];
 		monster_race *r_ptr = &r_info[m_ptr->r_idx];
 
 		/* no mana, stop here */
@@ -1141,9 +1145,9 @@ static size_t prt_state(int row, int col)
 static size_t prt_dtrap(int row, int col)
 {
 	/* The player is in a trap-detected grid */
-	if (sqinfo_has(cave_info[p_ptr->py][p_ptr->px], SQUARE_DTRAP)) {
+	if (square_has(p_ptr->py, p_ptr->px, SQUARE_DTRAP)) {
 		/* The player is on the border */
-		if (sqinfo_has(cave_info[p_ptr->py][p_ptr->px], SQUARE_DEDGE))
+		if (square_has(p_ptr->py, p_ptr->px, SQUARE_DEDGE))
 			c_put_str(TERM_YELLOW, "DTrap", row, col);
 		else
 			c_put_str(TERM_L_GREEN, "DTrap", row, col);
@@ -76,4 +76,62 @@ bool flags_set      (bitflag *flags, const size_t size, ...);
 void flags_init     (bitflag *flags, const size_t size, ...);
 bool flags_mask     (bitflag *flags, const size_t size, ...);
 
+
+/*
+ * Single flag tests and changes, as used by the per-set macros such as
+ * tf_has() and sqinfo_on().
+ *
+ * These are in the innermost loops of the game, so by default they are
+ * inlined and do no checking.  Build with BITFLAG_DEBUG defined (for
+ * instance with CFLAGS=-DBITFLAG_DEBUG) to have every flag checked against
+ * the size of its set, with the offending expression reported on failure.
+ */
+#ifdef BITFLAG_DEBUG
+
+#define flag_has_fast(f, size, flag)   flag_has_dbg(f, size, flag, #f, #flag)
+#define flag_on_fast(f, size, flag)    flag_on_dbg(f, size, flag, #f, #flag)
+#define flag_off_fast(f, size, flag)   flag_off(f, size, flag)
+
+#else
+
+#define flag_has_fast(f, size, flag)   flag_has_inline(f, flag)
+#define flag_on_fast(f, size, flag)    flag_on_inline(f, flag)
+#define flag_off_fast(f, size, flag)   flag_off_inline(f, flag)
+
+#endif
+
+/*
+ * Index and bit mask of a flag within its set, done in signed arithmetic
+ * so that FLAG_END gives index 0 and an empty mask rather than needing a
+ * branch.
+ */
+#define FLAG_INDEX(id)    (((id) - FLAG_START) / (int) FLAG_WIDTH)
+#define FLAG_MASK(id) \
+	((bitflag) (((id) != FLAG_END) << (((id) - FLAG_START) & (int) (FLAG_WIDTH - 1))))
+
+static inline bool flag_has_inline(const bitflag *flags, const int flag)
+{
+	return (flags[FLAG_INDEX(flag)] & FLAG_MASK(flag)) != 0;
+}
+
+static inline bool flag_on_inline(bitflag *flags, const int flag)
+{
+	bitflag *f = &flags[FLAG_INDEX(flag)];
+	bitflag old = *f;
+
+	*f = old | FLAG_MASK(flag);
+
+	return *f != old;
+}
+
+static inline bool flag_off_inline(bitflag *flags, const int flag)
+{
+	bitflag *f = &flags[FLAG_INDEX(flag)];
+	bitflag old = *f;
+
+	*f = old & ~FLAG_MASK(flag);
+
+	return *f != old;
+}
+
 #endif
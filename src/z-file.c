@@ -243,11 +243,22 @@ FILE *fdopen(int handle, const char *mode);
 #endif
 
 /* Private structure to hold file pointers and useful info. */
+/*
+ * Size of the buffer that reads from a file are taken from
+ */
+#define FILE_BUF_SIZE 4096
+
 struct ang_file
 {
 	FILE *fh;
 	char *fname;
 	file_mode mode;
+
+	/* Read buffer, allocated on the first read; bytes buf_pos to buf_len
+	 * are read from the file but not yet used */
+	byte *buf;
+	size_t buf_pos;
+	size_t buf_len;
 };
 
 
@@ -418,6 +429,7 @@ bool file_close(ang_file *f)
 		return FALSE;
 
 	FREE(f->fname);
+	FREE(f->buf);
 	FREE(f);
 
 	return TRUE;
@@ -462,12 +474,53 @@ void file_unlock(ang_file *f)
 
 /** Byte-based IO and functions **/
 
+/*
+ * Refill the read buffer of file 'f' once it has all been used.
+ * Returns FALSE if there is nothing left to read.
+ */
+static bool file_fill(ang_file *f)
+{
+	if (f->buf_pos < f->buf_len)
+		return TRUE;
+
+	if (!f->buf)
+		f->buf = C_RNEW(FILE_BUF_SIZE, byte);
+
+	f->buf_pos = 0;
+	f->buf_len = fread(f->buf, 1, FILE_BUF_SIZE, f->fh);
+
+	return (f->buf_len > 0);
+}
+
+/*
+ * Throw away the unused part of the read buffer of file 'f', moving the
+ * stream back to the first byte that was not used.
+ */
+static bool file_unbuffer(ang_file *f)
+{
+	long unused = (long)(f->buf_len - f->buf_pos);
+
+	f->buf_pos = f->buf_len = 0;
+
+	return (unused == 0) || (fseek(f->fh, -unused, SEEK_CUR) == 0);
+}
+
 /*
  * Seek to location 'pos' in file 'f'.
  */
 bool file_skip(ang_file *f, int bytes)
 {
-	return (fseek(f->fh, bytes, SEEK_CUR) == 0);
+	long unused = (long)(f->buf_len - f->buf_pos);
+
+	/* Stay inside the read buffer if we can */
+	if ((bytes >= 0) && (bytes <= unused)) {
+		f->buf_pos += bytes;
+		return TRUE;
+	}
+
+	f->buf_pos = f->buf_len = 0;
+
+	return (fseek(f->fh, bytes - unused, SEEK_CUR) == 0);
 }
 
 /*
@@ -475,12 +528,10 @@ bool file_skip(ang_file *f, int bytes)
  */
 bool file_readc(ang_file *f, byte *b)
 {
-	int i = fgetc(f->fh);
-
-	if (i == EOF)
+	if (!file_fill(f))
 		return FALSE;
 
-	*b = (byte)i;
+	*b = f->buf[f->buf_pos++];
 	return TRUE;
 }
 
@@ -497,7 +548,16 @@ bool file_writec(ang_file *f, byte b)
  */
 int file_read(ang_file *f, char *buf, size_t n)
 {
-	size_t read = fread(buf, 1, n, f->fh);
+	size_t buffered = MIN(n, f->buf_len - f->buf_pos);
+	size_t read;
+
+	/* Use up the read buffer first, then read the rest directly */
+	if (buffered) {
+		memcpy(buf, f->buf + f->buf_pos, buffered);
+		f->buf_pos += buffered;
+	}
+
+	read = buffered + fread(buf + buffered, 1, n - buffered, f->fh);
 
 	if (read == 0 && ferror(f->fh))
 		return -1;
@@ -510,6 +570,10 @@ int file_read(ang_file *f, char *buf, size_t n)
  */
 bool file_write(ang_file *f, const char *buf, size_t n)
 {
+	/* Writes go where the last read left off */
+	if ((f->buf_pos < f->buf_len) && !file_unbuffer(f))
+		return FALSE;
+
 	return fwrite(buf, 1, n, f->fh) == n;
 }
 
@@ -526,58 +590,92 @@ bool file_write(ang_file *f, const char *buf, size_t n)
 bool file_getl(ang_file *f, char *buf, size_t len)
 {
 	bool seen_cr = FALSE;
-	byte b;
+	bool done = FALSE;
 	size_t i = 0;
 
 	/* Leave a byte for the terminating 0 */
 	size_t max_len = len - 1;
 
-	while (i < max_len)
+	while (!done && (i < max_len))
 	{
-		char c;
+		const byte *p, *end, *nl;
 
-		if (!file_readc(f, &b))
+		if (!file_fill(f))
 		{
 			buf[i] = '\0';
 			return (i == 0) ? FALSE : TRUE;
 		}
 
-		c = (char) b;
+		/* Work through the buffer up to the end of the line, if it is there */
+		p = f->buf + f->buf_pos;
+		end = f->buf + f->buf_len;
+		nl = memchr(p, '\n', end - p);
+		if (nl) end = nl + 1;
 
-		if (c == '\r')
+		/* Copy text without \r, \t or \n straight across */
+		if (!seen_cr)
 		{
-			seen_cr = TRUE;
-			continue;
-		}
+			size_t run = MIN((size_t)((nl ? nl : end) - p), max_len - i);
+			const byte *stop;
 
-		if (seen_cr && c != '\n')
-		{
-			fseek(f->fh, -1, SEEK_CUR);
-			buf[i] = '\0';
-			return TRUE;
-		}
+			stop = memchr(p, '\r', run);
+			if (stop) run = stop - p;
+			stop = memchr(p, '\t', run);
+			if (stop) run = stop - p;
 
-		if (c == '\n')
-		{
-			buf[i] = '\0';
-			return TRUE;
+			memcpy(buf + i, p, run);
+			i += run;
+			p += run;
 		}
 
-		/* Expand tabs */
-		if (c == '\t')
+		/* Deal with the rest a character at a time */
+		for (; (p < end) && (i < max_len); p++)
 		{
-			/* Next tab stop */
-			size_t tabstop = ((i + TAB_COLUMNS) / TAB_COLUMNS) * TAB_COLUMNS;
-			if (tabstop >= len) break;
+			char c = (char) *p;
 
-			/* Convert to spaces */
-			while (i < tabstop)
-				buf[i++] = ' ';
+			if (c == '\r')
+			{
+				seen_cr = TRUE;
+				continue;
+			}
 
-			continue;
+			/* Leave the character after a lone \r for the next line */
+			if (seen_cr && c != '\n')
+			{
+				done = TRUE;
+				break;
+			}
+
+			if (c == '\n')
+			{
+				done = TRUE;
+				p++;
+				break;
+			}
+
+			/* Expand tabs */
+			if (c == '\t')
+			{
+				/* Next tab stop */
+				size_t tabstop = ((i + TAB_COLUMNS) / TAB_COLUMNS) * TAB_COLUMNS;
+				if (tabstop >= len)
+				{
+					done = TRUE;
+					p++;
+					break;
+				}
+
+				/* Convert to spaces */
+				while (i < tabstop)
+					buf[i++] = ' ';
+
+				continue;
+			}
+
+			buf[i++] = c;
 		}
 
-		buf[i++] = c;
+		f->buf_pos = p - f->buf;
 	}
 
 	buf[i] = '\0';